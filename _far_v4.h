@@ -227,6 +227,17 @@ typedef struct _bitstream_parser {
 
   /* Specific FDRI quirks */
   const void *last_frame;
+  guint32 last_far;
+  /* frames already seen in the current FDRI write */
+  unsigned fdri_frames;
+  /* frames recorded, added to the stats once at the end */
+  unsigned nframes;
+  /* when the input is not kept around (streaming), the last frame is
+     copied here */
+  guint32 *frame_copy;
+  /* called for each frame recorded */
+  frame_unk_iterator_t frame_hook;
+  void *frame_hook_data;
 
   /* Bitstream proper */
   bytearray_t ba;
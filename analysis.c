@@ -21,9 +21,12 @@
 #include <glib/gprintf.h>
 
 #include "debitlog.h"
+#include "stats.h"
 
 #include "wiring.h"
 #include "localpips.h"
+#include "snapshot.h"
+#include "sitearchive.h"
 #include "bitstream.h"
 #include "connexity.h"
 #include "analysis.h"
@@ -40,28 +43,30 @@
  */
 
 /*
- * Very simple analysis function which only dumps the pips to stdout
+ * Very simple analysis function which only dumps the pips to the
+ * output stream
  */
 
 static inline void
-print_pip(const csite_descr_t *site, const gchar *start, const gchar *end) {
+print_pip(FILE *out,
+	  const csite_descr_t *site, const gchar *start, const gchar *end) {
   gchar site_buf[MAX_SITE_NLEN];
   /* XXX */
   snprint_csite(site_buf, ARRAY_SIZE(site_buf), site, 0, 0);
-  g_printf("pip %s %s -> %s\n", site_buf, start, end);
+  g_fprintf(out, "pip %s %s -> %s\n", site_buf, start, end);
 }
 
 static void
-print_bram_data(const csite_descr_t *site, const guint16 *data) {
+print_bram_data(FILE *out, const csite_descr_t *site, const guint16 *data) {
   guint i,j;
-  g_printf("BRAM_%02x_%02x\n",
-	   site->type_coord.x,
-	   site->type_coord.y >> 2);
+  g_fprintf(out, "BRAM_%02x_%02x\n",
+	    site->type_coord.x,
+	    site->type_coord.y >> 2);
   for (i = 0; i < 64; i++) {
-    g_printf("INIT_%02x:",i);
+    g_fprintf(out, "INIT_%02x:",i);
     for (j = 0; j < 16; j++)
-      g_printf("%04x", data[16*i + 15 - j]);
-    g_printf("\n");
+      g_fprintf(out, "%04x", data[16*i + 15 - j]);
+    g_fprintf(out, "\n");
   }
 }
 
@@ -82,18 +87,19 @@ get_input_wire(const lut_t lut,
 }
 
 static void
-print_lut_inputs(const lut_t lut) {
+print_lut_inputs(FILE *out, const lut_t lut) {
   int i;
 
   for(i = 0; i < 4; i++) {
     if (get_input_wire(lut,i))
-      g_printf("A%i ",i+1);
+      g_fprintf(out, "A%i ",i+1);
   }
-  g_printf("\n");
+  g_fprintf(out, "\n");
 }
 
 static void
-print_lut_data(const csite_descr_t *site,
+print_lut_data(FILE *out,
+	       const csite_descr_t *site,
 	       const chip_descr_t *chip,
 	       const unsigned x, const unsigned y,
 	       const guint16 data[]) {
@@ -102,43 +108,45 @@ print_lut_data(const csite_descr_t *site,
 
   snprint_csite(sname, ARRAY_SIZE(sname),
 		site, x, y);
-  g_printf("%s\n", sname);
+  g_fprintf(out, "%s\n", sname);
   for (j = 0; j < 4; j++) {
     gchar slicen[MAX_SITE_NLEN];
     snprint_slice(slicen, MAX_SITE_NLEN, chip, site, j);
-    g_printf("%s\n", slicen);
+    g_fprintf(out, "%s\n", slicen);
     for (i = 0; i < 2; i++) {
       lut_t lut = data[i|j<<1];
-      g_printf("%s::#ROM:D=0x%04x\n", i ? "G" : "F", lut);
-      print_lut_inputs(lut);
+      g_fprintf(out, "%s::#ROM:D=0x%04x\n", i ? "G" : "F", lut);
+      print_lut_inputs(out, lut);
     }
   }
 }
 
 static void
-print_switchpip(const wire_db_t *wiredb,
+print_switchpip(FILE *out,
+		const wire_db_t *wiredb,
 		const chip_descr_t *chip,
 		const pip_t pip,
 		const site_ref_t site_ref) {
   gchar site_buf[MAX_SITE_NLEN];
   snprint_switch(site_buf, ARRAY_SIZE(site_buf),
 		 chip, site_ref);
-  g_printf("pip %s %s -> %s\n", site_buf,
-	   wire_name(wiredb,pip.source),
-	   wire_name(wiredb,pip.target));
+  g_fprintf(out, "pip %s %s -> %s\n", site_buf,
+	    wire_name(wiredb,pip.source),
+	    wire_name(wiredb,pip.target));
 }
 
 static void
-print_logicopt(const wire_db_t *wiredb,
+print_logicopt(FILE *out,
+	       const wire_db_t *wiredb,
 	       const chip_descr_t *chip,
 	       const pip_t pip,
 	       const site_ref_t site_ref) {
   gchar site_buf[MAX_SITE_NLEN];
   snprint_switch(site_buf, ARRAY_SIZE(site_buf),
 		 chip, site_ref);
-  g_printf("%s %s::%s\n", site_buf,
-	   wire_name(wiredb,pip.target),
-	   wire_name(wiredb,pip.source));
+  g_fprintf(out, "%s %s::%s\n", site_buf,
+	    wire_name(wiredb,pip.target),
+	    wire_name(wiredb,pip.source));
 }
 
 static void
@@ -151,10 +159,10 @@ print_switchpip_iter(gpointer data, const pip_t pip,
 
   switch (wtype) {
   case LOGIC:
-    print_logicopt(wiredb, chip, pip, site_ref);
+    print_logicopt(bitstream->out, wiredb, chip, pip, site_ref);
     break;
   default:
-    print_switchpip(wiredb, chip, pip, site_ref);
+    print_switchpip(bitstream->out, wiredb, chip, pip, site_ref);
   }
 }
 
@@ -171,7 +179,7 @@ print_lut_iter(unsigned site_x, unsigned site_y,
   bitstream_analyzed_t *analysis = dat;
   guint16 luts[8];
   query_bitstream_luts(analysis->bitstream, site, luts);
-  print_lut_data(site,analysis->chip,site_x,site_y,luts);
+  print_lut_data(analysis->out,site,analysis->chip,site_x,site_y,luts);
 }
 
 static void
@@ -182,24 +190,24 @@ print_all_luts(const bitstream_analyzed_t *bitstream) {
 static void
 print_bram_iter(unsigned site_x, unsigned site_y,
 		csite_descr_t *site, gpointer dat) {
-  bitstream_parsed_t *bitstream = dat;
+  bitstream_analyzed_t *analysis = dat;
   guint16 *bram;
   if ((site->type_coord.y & 0x3) != 0)
     return;
-  bram = query_bitstream_bram_data(bitstream, site);
-  print_bram_data(site,bram);
+  bram = query_bitstream_bram_data(analysis->bitstream, site);
+  print_bram_data(analysis->out,site,bram);
   debit_log(L_SITES, "Did BRAM %i x %i", site_x, site_y);
   (void) site_x; (void) site_y;
   g_free(bram);
 }
 
 static void
-print_all_bram(const chip_descr_t *chip,
-	       const bitstream_parsed_t *bitstream) {
-  iterate_over_typed_sites(chip, BRAM, print_bram_iter, (gpointer)bitstream);
+print_all_bram(const bitstream_analyzed_t *bitstream) {
+  iterate_over_typed_sites(bitstream->chip, BRAM, print_bram_iter, (gpointer)bitstream);
 }
 
-/** \brief Test function which dumps the pips of a bitstream on stdout.
+/** \brief Test function which dumps the pips of a bitstream on the
+ * output stream of the analysis.
  *
  * @param bitstream the bitstream data
  *
@@ -210,18 +218,18 @@ void dump_pips(bitstream_analyzed_t *bitstream) {
 }
 
 /** \brief Test function which dumps the bram data of a bitstream on
- * stdout.
+ * the output stream of the analysis.
  *
  * @param bitstream the bitstream data
  *
  */
 
 void dump_bram(bitstream_analyzed_t *bitstream) {
-  print_all_bram(bitstream->chip, bitstream->bitstream);
+  print_all_bram(bitstream);
 }
 
 /** \brief Test function which dumps the lut contents of a bitstream on
- * stdout.
+ * the output stream of the analysis.
  *
  * @param bitstream the bitstream data
  *
@@ -240,17 +248,29 @@ typedef struct _dump_site {
 } dump_site_t;
 
 /** \brief Test function which dumps the nets of a bitstream to
- * stdout.
+ * the output stream of the analysis.
  *
  * @param nlz the parsed bitstream
  */
 
 void dump_nets(const bitstream_analyzed_t *nlz) {
   nets_t * nets;
+  nets_csr_t *csr;
+  stats_mark_t mark;
   /* Then do some work */
-  print_design(&nlz->bitstream->header);
+  print_design(nlz->out, &nlz->bitstream->header);
+  stats_begin(&mark);
   nets = build_nets(nlz->pipdb, nlz->chip, nlz->pipdat);
-  print_nets(nets, nlz->pipdb, nlz->chip);
+  if (!nets) {
+    stats_end(&mark, STATS_NETS);
+    return;
+  }
+  csr = nets_csr(nets);
+  stats_end(&mark, STATS_NETS);
+  stats_count(STATS_NNETS, csr->nnets);
+  stats_count(STATS_NNODES, nets->nnodes);
+  print_nets(nlz->out, nets, csr, nlz->pipdb, nlz->chip);
+  free_nets_csr(csr);
   free_nets(nets);
 }
 
@@ -279,6 +299,18 @@ dump_site_iter(unsigned site_x, unsigned site_y,
   g_free(fullname);
 }
 
+/* The types of the sites dumped */
+#if defined(VIRTEX2) || defined(SPARTAN3)
+static const site_type_t dump_types[] =
+	  { CLB,
+	    TTERM, LTERM, BTERM, RTERM,
+	    TTERMBRAM, BTERMBRAM,
+	    TIOI, LIOI, BIOI, RIOI,
+	    TIOIBRAM, BIOIBRAM, BRAM };
+#elif defined(VIRTEX4) || defined(VIRTEX5)
+static const site_type_t dump_types[] = { IOB, CLB, DSP48, GCLKC, BRAM };
+#endif
+
 /** \brief Test function which dumps the site configuration data in a
  * specific directory.
  *
@@ -290,21 +322,10 @@ dump_site_iter(unsigned site_x, unsigned site_y,
 void dump_sites(const bitstream_analyzed_t *nlz,
 		const gchar *odir, const gchar *suffix) {
   dump_site_t dump = { .parsed = nlz->bitstream, .odir = odir, .suffix = suffix };
-#if defined(VIRTEX2) || defined(SPARTAN3)
-  site_type_t types[] =
-	  { CLB,
-	    TTERM, LTERM, BTERM, RTERM,
-	    TTERMBRAM, BTERMBRAM,
-	    TIOI, LIOI, BIOI, RIOI,
-	    TIOIBRAM, BIOIBRAM, BRAM };
-#elif defined(VIRTEX4) || defined(VIRTEX5)
-  site_type_t types[] = { IOB, CLB, DSP48, GCLKC, BRAM };
-#endif
-
   unsigned index;
 
-  for (index = 0; index < G_N_ELEMENTS(types); index++) {
-    site_type_t type = types[index];
+  for (index = 0; index < G_N_ELEMENTS(dump_types); index++) {
+    site_type_t type = dump_types[index];
     dump.buffer_len = query_bitstream_type_size(nlz->bitstream, type);
     dump.buffer = g_new(gchar, dump.buffer_len);
     iterate_over_typed_sites(nlz->chip, type, dump_site_iter, &dump);
@@ -312,6 +333,24 @@ void dump_sites(const bitstream_analyzed_t *nlz,
   }
 }
 
+/** \brief Dump the site configuration data into one archive
+ *
+ * Same data as dump_sites, written as a site archive.
+ *
+ * @param nlz the analyzed bitstream
+ * @param filename the archive to write
+ * @param jobs the number of threads extracting the data
+ *
+ * @return 0 on success, -1 on error
+ * @see site_archive_write
+ */
+
+int dump_sites_archive(const bitstream_analyzed_t *nlz,
+		       const gchar *filename, const unsigned jobs) {
+  return site_archive_write(filename, nlz->chip, nlz->bitstream,
+			    dump_types, G_N_ELEMENTS(dump_types), jobs);
+}
+
 /*
  * Allocation / unallocation functions
  * Maybe split this into analysis.c
@@ -322,9 +361,10 @@ unfill_analysis(bitstream_analyzed_t *anal) {
   chip_descr_t *chip = anal->chip;
   pip_parsed_dense_t *pipdat = anal->pipdat;
 
-  if (pipdb)
+  /* Shared databases belong to the database set */
+  if (pipdb && !anal->dbs)
     free_pipdb(pipdb);
-  if (chip)
+  if (chip && !anal->dbs)
     release_chip(chip);
   if (pipdat)
     free_pipdat(pipdat);
@@ -336,31 +376,310 @@ free_analysis(bitstream_analyzed_t *anal) {
   g_free(anal);
 }
 
+/*
+ * Databases shared between the analyses of several bitstreams
+ */
+
+struct _analysis_dbs {
+  gchar *datadir;
+  GMutex *lock;
+  pip_db_t *pipdb;
+  /* chip id -> chip_descr_t */
+  GHashTable *chips;
+  /* chip id -> frame_map_t, built on demand */
+  GHashTable *frame_maps;
+  /* base bitstream -> pip_parsed_dense_t, added with
+     analysis_dbs_add_base */
+  GHashTable *base_pips;
+  /* where the snapshots go; NULL when they are off */
+  gchar *snapdir;
+};
+
+static pip_db_t *
+timed_get_pipdb(const gchar *datadir) {
+  pip_db_t *pipdb;
+  stats_mark_t mark;
+
+  stats_begin(&mark);
+  pipdb = get_pipdb(datadir);
+  stats_end(&mark, STATS_PIPDB);
+  return pipdb;
+}
+
+static chip_descr_t *
+timed_get_chip(const gchar *datadir, const unsigned chipid) {
+  chip_descr_t *chip;
+  stats_mark_t mark;
+
+  stats_begin(&mark);
+  chip = get_chip(datadir, chipid);
+  stats_end(&mark, STATS_CHIPDB);
+  return chip;
+}
+
+static inline GMutex *
+new_lock(void) {
+#if GLIB_CHECK_VERSION(2,32,0)
+  GMutex *lock = g_new(GMutex, 1);
+  g_mutex_init(lock);
+  return lock;
+#else
+  return g_mutex_new();
+#endif
+}
+
+static inline void
+free_lock(GMutex *lock) {
+#if GLIB_CHECK_VERSION(2,32,0)
+  g_mutex_clear(lock);
+  g_free(lock);
+#else
+  g_mutex_free(lock);
+#endif
+}
+
+static void
+release_chip_notify(gpointer data) {
+  release_chip(data);
+}
+
+static void
+free_frame_map_notify(gpointer data) {
+  free_frame_map(data);
+}
+
+static void
+free_pipdat_notify(gpointer data) {
+  free_pipdat(data);
+}
+
+analysis_dbs_t *
+new_analysis_dbs(const gchar *datadir) {
+  analysis_dbs_t *dbs = g_new0(analysis_dbs_t, 1);
+  dbs->datadir = g_strdup(datadir);
+  dbs->lock = new_lock();
+  dbs->chips = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+				     NULL, release_chip_notify);
+  dbs->frame_maps = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+					  NULL, free_frame_map_notify);
+  dbs->base_pips = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+					 NULL, free_pipdat_notify);
+  return dbs;
+}
+
+void
+free_analysis_dbs(analysis_dbs_t *dbs) {
+  g_hash_table_destroy(dbs->base_pips);
+  g_hash_table_destroy(dbs->frame_maps);
+  g_hash_table_destroy(dbs->chips);
+  if (dbs->pipdb)
+    free_pipdb(dbs->pipdb);
+  free_lock(dbs->lock);
+  g_free(dbs->snapdir);
+  g_free(dbs->datadir);
+  g_free(dbs);
+}
+
+void
+analysis_dbs_set_snapshots(analysis_dbs_t *dbs, const gchar *dir) {
+  g_free(dbs->snapdir);
+  dbs->snapdir = g_strdup(dir);
+}
+
+/* The databases are loaded on first use. Loading happens with the lock
+   held, so that concurrent analyses of the same chip wait for a single
+   load rather than racing for it */
+static int
+get_shared_dbs(analysis_dbs_t *dbs, const unsigned chipid,
+	       pip_db_t **pipdb, chip_descr_t **chip) {
+  gpointer key = GUINT_TO_POINTER(chipid);
+  int err = -1;
+
+  g_mutex_lock(dbs->lock);
+
+  if (!dbs->pipdb)
+    dbs->pipdb = timed_get_pipdb(dbs->datadir);
+  if (!dbs->pipdb)
+    goto out_unlock;
+
+  *chip = g_hash_table_lookup(dbs->chips, key);
+  if (!*chip) {
+    *chip = timed_get_chip(dbs->datadir, chipid);
+    if (!*chip)
+      goto out_unlock;
+    g_hash_table_insert(dbs->chips, key, *chip);
+  }
+
+  *pipdb = dbs->pipdb;
+  err = 0;
+
+ out_unlock:
+  g_mutex_unlock(dbs->lock);
+  return err;
+}
+
+/* The frame map of a chip, built on first use like the databases */
+static const frame_map_t *
+get_shared_frame_map(analysis_dbs_t *dbs, const pip_db_t *pipdb,
+		     const chip_descr_t *chip,
+		     const bitstream_parsed_t *bitstream) {
+  const chip_struct_t *chip_struct = bitstream->chip_struct;
+  gpointer key = GUINT_TO_POINTER(chip_struct->chip);
+  frame_map_t *map;
+
+  g_mutex_lock(dbs->lock);
+  map = g_hash_table_lookup(dbs->frame_maps, key);
+  if (!map) {
+    map = get_frame_map(pipdb, chip, bitstream);
+    g_hash_table_insert(dbs->frame_maps, key, map);
+  }
+  g_mutex_unlock(dbs->lock);
+
+  return map;
+}
+
+static pip_parsed_dense_t *
+timed_pips_of_bitstream(const pip_db_t *pipdb, const chip_descr_t *chip,
+			const bitstream_parsed_t *bitstream, const unsigned jobs) {
+  pip_parsed_dense_t *pipdat;
+  stats_mark_t mark;
+
+  stats_begin(&mark);
+  pipdat = pips_of_bitstream(pipdb, chip, bitstream, jobs);
+  stats_end(&mark, STATS_PIPS);
+  return pipdat;
+}
+
+/* With a snapshot directory, the pips come from the snapshot of the
+   bitstream if there is one; otherwise they are extracted, and the
+   snapshot is written for the next run */
+static pip_parsed_dense_t *
+get_pipdat(const pip_db_t *pipdb, const chip_descr_t *chip,
+	   const bitstream_parsed_t *bitstream, const gchar *snapdir,
+	   const unsigned jobs) {
+  snapshot_key_t key;
+  pip_parsed_dense_t *pipdat;
+  const gboolean keyed = snapdir &&
+    (snapshot_key(&key, bitstream, pipdb, chip) == 0);
+
+  if (keyed) {
+    pipdat = snapshot_load(&key, snapdir);
+    if (pipdat)
+      goto out;
+  }
+
+  pipdat = timed_pips_of_bitstream(pipdb, chip, bitstream, jobs);
+
+  /* Not being able to write the snapshot is not an error */
+  if (pipdat && keyed && snapshot_save(&key, pipdat, snapdir))
+    g_warning("could not write the design snapshot");
+
+ out:
+  return pipdat;
+}
+
+int
+analysis_dbs_add_base(analysis_dbs_t *dbs, const bitstream_parsed_t *base,
+		      const unsigned jobs) {
+  const chip_struct_t *chip_struct = base->chip_struct;
+  pip_parsed_dense_t *pipdat;
+  pip_db_t *pipdb;
+  chip_descr_t *chip;
+
+  if (get_shared_dbs(dbs, chip_struct->chip, &pipdb, &chip))
+    return -1;
+
+  pipdat = get_pipdat(pipdb, chip, base, dbs->snapdir, jobs);
+  if (!pipdat)
+    return -1;
+
+  g_mutex_lock(dbs->lock);
+  g_hash_table_replace(dbs->base_pips, (gpointer) base, pipdat);
+  g_mutex_unlock(dbs->lock);
+  return 0;
+}
+
+static const pip_parsed_dense_t *
+get_shared_base_pips(analysis_dbs_t *dbs, const bitstream_parsed_t *base) {
+  const pip_parsed_dense_t *pipdat;
+
+  g_mutex_lock(dbs->lock);
+  pipdat = g_hash_table_lookup(dbs->base_pips, base);
+  g_mutex_unlock(dbs->lock);
+
+  return pipdat;
+}
+
+/* Only the sites touched by the differences are extracted again, over
+   the pips of the base bitstream. Extracting those first would cost
+   more than the full extraction, so this is only done when they were
+   added to the databases beforehand */
+static pip_parsed_dense_t *
+get_pipdat_update(analysis_dbs_t *dbs,
+		  const pip_db_t *pipdb, const chip_descr_t *chip,
+		  const bitstream_parsed_t *bitstream,
+		  const bitstream_parsed_t *base,
+		  const bitstream_diff_t *diff, const unsigned jobs) {
+  const pip_parsed_dense_t *previous;
+  pip_parsed_dense_t *pipdat;
+  const frame_map_t *map;
+  stats_mark_t mark;
+
+  previous = get_shared_base_pips(dbs, base);
+  if (!previous)
+    return get_pipdat(pipdb, chip, bitstream, dbs->snapdir, jobs);
+
+  map = get_shared_frame_map(dbs, pipdb, chip, bitstream);
+
+  stats_begin(&mark);
+  pipdat = pips_of_bitstream_update(pipdb, chip, bitstream, map, previous,
+				    diff->frames, diff->nframes);
+  stats_end(&mark, STATS_PIPS);
+
+  return pipdat;
+}
+
 static int
 fill_analysis(bitstream_analyzed_t *anal,
 	      bitstream_parsed_t *bitstream,
-	      const gchar *datadir) {
+	      const bitstream_parsed_t *base,
+	      const bitstream_diff_t *diff,
+	      const gchar *datadir, const unsigned jobs) {
   pip_db_t *pipdb;
   chip_descr_t *chip;
   pip_parsed_dense_t *pipdat;
   const chip_struct_t *chip_struct = bitstream->chip_struct;
 
   anal->bitstream = bitstream;
+  anal->out = stdout;
   /* then fetch the databases */
-  pipdb = get_pipdb(datadir);
-  if (!pipdb)
-    goto err_out;
-  anal->pipdb = pipdb;
-
-  chip = get_chip(datadir, chip_struct->chip);
-  if (!chip)
-    goto err_out;
-  anal->chip = chip;
+  if (anal->dbs) {
+    if (get_shared_dbs(anal->dbs, chip_struct->chip, &pipdb, &chip))
+      goto err_out;
+    anal->pipdb = pipdb;
+    anal->chip = chip;
+  } else {
+    pipdb = timed_get_pipdb(datadir);
+    if (!pipdb)
+      goto err_out;
+    anal->pipdb = pipdb;
+
+    chip = timed_get_chip(datadir, chip_struct->chip);
+    if (!chip)
+      goto err_out;
+    anal->chip = chip;
+  }
 
-  pipdat = pips_of_bitstream(pipdb, chip, bitstream);
+  if (diff)
+    pipdat = get_pipdat_update(anal->dbs, pipdb, chip, bitstream,
+			       base, diff, jobs);
+  else
+    pipdat = get_pipdat(pipdb, chip, bitstream,
+			anal->dbs ? anal->dbs->snapdir : NULL, jobs);
   if (!pipdat)
     goto err_out;
   anal->pipdat = pipdat;
+  stats_count(STATS_NPIPS, pipdat->site_index[chip->width * chip->height]);
 
   return 0;
 
@@ -371,11 +690,45 @@ fill_analysis(bitstream_analyzed_t *anal,
 
 bitstream_analyzed_t *
 analyze_bitstream(bitstream_parsed_t *bitstream,
-		  const gchar *datadir) {
+		  const gchar *datadir, const unsigned jobs) {
+  bitstream_analyzed_t *anal = g_new0(bitstream_analyzed_t, 1);
+  int err;
+
+  err = fill_analysis(anal, bitstream, NULL, NULL, datadir, jobs);
+  if (err) {
+    g_free(anal);
+    return NULL;
+  }
+
+  return anal;
+}
+
+bitstream_analyzed_t *
+analyze_bitstream_shared(bitstream_parsed_t *bitstream,
+			 analysis_dbs_t *dbs, const unsigned jobs) {
+  bitstream_analyzed_t *anal = g_new0(bitstream_analyzed_t, 1);
+  int err;
+
+  anal->dbs = dbs;
+  err = fill_analysis(anal, bitstream, NULL, NULL, dbs->datadir, jobs);
+  if (err) {
+    g_free(anal);
+    return NULL;
+  }
+
+  return anal;
+}
+
+bitstream_analyzed_t *
+analyze_bitstream_update(bitstream_parsed_t *bitstream,
+			 const bitstream_parsed_t *base,
+			 const bitstream_diff_t *diff,
+			 analysis_dbs_t *dbs, const unsigned jobs) {
   bitstream_analyzed_t *anal = g_new0(bitstream_analyzed_t, 1);
   int err;
 
-  err = fill_analysis(anal, bitstream, datadir);
+  anal->dbs = dbs;
+  err = fill_analysis(anal, bitstream, base, diff, dbs->datadir, jobs);
   if (err) {
     g_free(anal);
     return NULL;
@@ -383,3 +736,145 @@ analyze_bitstream(bitstream_parsed_t *bitstream,
 
   return anal;
 }
+
+/*
+ * Bitstream differences
+ */
+
+/* The site holding a configuration bit, if any, and its cfgbit */
+static const csite_descr_t *
+site_of_bit(const chip_descr_t *chip, const frame_map_t *map,
+	    const bitstream_parsed_t *bitstream,
+	    const bit_diff_t *bit, gint *cfgbit) {
+  const site_ref_t *sites;
+  guint i, nsites;
+
+  sites = sites_of_frame(map, bit->frame, &nsites);
+  for (i = 0; i < nsites; i++) {
+    const csite_descr_t *site = get_site(chip, sites[i]);
+    gsize first;
+
+    query_bitstream_site_frames(bitstream, site, &first);
+    *cfgbit = query_bitstream_site_cfgbit(bitstream, site,
+					  bit->frame - first, bit->bit);
+    if (*cfgbit >= 0)
+      return site;
+  }
+
+  return NULL;
+}
+
+/* Partial bitstreams need not have all the frames of a site */
+static gboolean
+site_frames_present(const bitstream_parsed_t *bitstream,
+		    const csite_descr_t *site) {
+  gsize first;
+  const guint nframes = query_bitstream_site_frames(bitstream, site, &first);
+  guint i;
+
+  for (i = 0; i < nframes; i++)
+    if (!bitstream_frame(bitstream, first + i))
+      return FALSE;
+  return TRUE;
+}
+
+static inline gboolean
+pip_in(const pip_t pip, const pip_t *pips, const gsize npips) {
+  gsize i;
+  for (i = 0; i < npips; i++)
+    if (pips[i].source == pip.source && pips[i].target == pip.target)
+      return TRUE;
+  return FALSE;
+}
+
+static void
+print_pips_not_in(FILE *out, const wire_db_t *wiredb, const gchar *site_name,
+		  const gchar sign, const pip_t *pips, const gsize npips,
+		  const pip_t *others, const gsize nothers) {
+  gsize i;
+
+  for (i = 0; i < npips; i++)
+    if (!pip_in(pips[i], others, nothers))
+      g_fprintf(out, "%cpip %s %s -> %s\n", sign, site_name,
+		wire_name(wiredb, pips[i].source),
+		wire_name(wiredb, pips[i].target));
+}
+
+static void
+print_site_pips_diff(FILE *out, const pip_db_t *pipdb,
+		     const chip_descr_t *chip,
+		     const bitstream_parsed_t *base,
+		     const bitstream_parsed_t *bitstream,
+		     const site_ref_t site_ref) {
+  const csite_descr_t *site = get_site(chip, site_ref);
+  gchar site_buf[MAX_SITE_NLEN];
+  pip_t *old, *new;
+  gsize nold, nnew;
+
+  snprint_switch(site_buf, ARRAY_SIZE(site_buf), chip, site_ref);
+  if (!site_frames_present(base, site) ||
+      !site_frames_present(bitstream, site)) {
+    g_warning("Not all frames of site %s are present, "
+	      "skipping its pips", site_buf);
+    return;
+  }
+
+  old = pips_of_site(pipdb, base, site, &nold);
+  new = pips_of_site(pipdb, bitstream, site, &nnew);
+  print_pips_not_in(out, pipdb->wiredb, site_buf, '-', old, nold, new, nnew);
+  print_pips_not_in(out, pipdb->wiredb, site_buf, '+', new, nnew, old, nold);
+  g_free(old);
+  g_free(new);
+}
+
+int
+dump_diff(const bitstream_parsed_t *base,
+	  const bitstream_parsed_t *bitstream,
+	  const bitstream_diff_t *diff,
+	  analysis_dbs_t *dbs, FILE *out) {
+  const chip_struct_t *chip_struct = bitstream->chip_struct;
+  pip_db_t *pipdb = NULL;
+  chip_descr_t *chip = NULL;
+  const frame_map_t *map = NULL;
+  guint8 *touched = NULL;
+  unsigned nsites = 0, i;
+  gsize b;
+
+  if (dbs) {
+    if (get_shared_dbs(dbs, chip_struct->chip, &pipdb, &chip))
+      return -1;
+    map = get_shared_frame_map(dbs, pipdb, chip, bitstream);
+    nsites = chip->width * chip->height;
+    touched = g_new0(guint8, nsites);
+  }
+
+  for (b = 0; b < diff->nbits; b++) {
+    const bit_diff_t *bit = &diff->bits[b];
+    gchar far_name[32];
+
+    snprintf_far(far_name, sizeof(far_name), bit->far);
+    g_fprintf(out, "bit %s %u %u", far_name, bit->bit, bit->set);
+
+    if (map) {
+      gint cfgbit;
+      const csite_descr_t *site = site_of_bit(chip, map, bitstream, bit, &cfgbit);
+      if (site) {
+	const site_ref_t site_ref = get_site_ref(chip, site);
+	gchar site_buf[MAX_SITE_NLEN];
+	snprint_switch(site_buf, ARRAY_SIZE(site_buf), chip, site_ref);
+	g_fprintf(out, " %s %i", site_buf, cfgbit);
+	touched[site_ref] = 1;
+      }
+    }
+
+    g_fprintf(out, "\n");
+  }
+
+  /* Then the pips of the sites touched, in site order */
+  for (i = 0; i < nsites; i++)
+    if (touched[i])
+      print_site_pips_diff(out, pipdb, chip, base, bitstream, i);
+
+  g_free(touched);
+  return 0;
+}
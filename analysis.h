@@ -20,9 +20,44 @@
 #ifndef _HAS_ANALYSIS_H
 #define _HAS_ANALYSIS_H
 
+#include <stdio.h>
 #include <glib.h>
 #include "wiring.h"
 #include "localpips.h"
+#include "bitdiff.h"
+
+/** \brief Set of databases shared between analyses
+ *
+ * The pip database and the chip descriptions are loaded once, on
+ * first use, and can then be used by any number of analyses, possibly
+ * running in different threads.
+ */
+typedef struct _analysis_dbs analysis_dbs_t;
+
+analysis_dbs_t *new_analysis_dbs(const gchar *datadir);
+void free_analysis_dbs(analysis_dbs_t *dbs);
+
+/** \brief Keep snapshots of the analyses in a directory
+ *
+ * The pips of each bitstream analyzed with the set are then saved in
+ * dir, and mapped from there when the same bitstream is analyzed
+ * again. Snapshots are off by default.
+ *
+ * @see snapshot.h
+ */
+void analysis_dbs_set_snapshots(analysis_dbs_t *dbs, const gchar *dir);
+
+/** \brief Extract the pips of a base bitstream once for all analyses
+ *
+ * The analyses of bitstreams from this base with
+ * analyze_bitstream_update then start from these pips. The base must
+ * outlive the set.
+ *
+ * @return 0 on success, -1 if the pips could not be extracted
+ */
+int analysis_dbs_add_base(analysis_dbs_t *dbs,
+			  const bitstream_parsed_t *base,
+			  const unsigned jobs);
 
 typedef struct _bitstream_analyzed {
   /* low-level information */
@@ -31,26 +66,78 @@ typedef struct _bitstream_analyzed {
   /* databases */
   chip_descr_t *chip;
   pip_db_t *pipdb;
+  /* set when the databases are borrowed from a shared set */
+  analysis_dbs_t *dbs;
 
   /* simplified bitstream data */
   pip_parsed_dense_t *pipdat;
 
   /* nets from the bitstream */
 
+  /* where the text dumps go; stdout unless changed */
+  FILE *out;
 } bitstream_analyzed_t;
 
 void free_analysis(bitstream_analyzed_t *anal);
 
 bitstream_analyzed_t *
 analyze_bitstream(bitstream_parsed_t *bitstream,
-		  const gchar *datadir);
+		  const gchar *datadir, const unsigned jobs);
+
+/** \brief Analyze a bitstream with shared databases
+ *
+ * Same as analyze_bitstream, except that the databases are taken from
+ * (and loaded into) the shared set rather than loaded for this
+ * analysis alone.
+ */
+bitstream_analyzed_t *
+analyze_bitstream_shared(bitstream_parsed_t *bitstream,
+			 analysis_dbs_t *dbs, const unsigned jobs);
+
+/** \brief Analyze a bitstream from the analysis of a base bitstream
+ *
+ * Same as analyze_bitstream_shared, except that, if the base was added
+ * to the set with analysis_dbs_add_base, the pips are those of the
+ * base bitstream, with only the sites touched by the differences
+ * between the two bitstreams extracted again.
+ *
+ * @see diff_bitstreams
+ * @see pips_of_bitstream_update
+ */
+bitstream_analyzed_t *
+analyze_bitstream_update(bitstream_parsed_t *bitstream,
+			 const bitstream_parsed_t *base,
+			 const bitstream_diff_t *diff,
+			 analysis_dbs_t *dbs, const unsigned jobs);
 
 void dump_sites(const bitstream_analyzed_t *nlz,
 		const gchar *odir, const gchar *suffix);
+int dump_sites_archive(const bitstream_analyzed_t *nlz,
+		       const gchar *filename, const unsigned jobs);
 
 void dump_pips(bitstream_analyzed_t *bitstream);
 void dump_luts(bitstream_analyzed_t *bitstream);
 void dump_bram(bitstream_analyzed_t *bitstream);
 void dump_nets(const bitstream_analyzed_t *bitstream);
 
+/** \brief Print the configuration bits which differ between two bitstreams
+ *
+ * Each bit is printed with its FAR, its offset in the frame and its new
+ * value. With a database set, the bit is also attributed to its site,
+ * along with its cfgbit, and the pips of the sites touched are compared
+ * between the two bitstreams.
+ *
+ * @param base the reference bitstream
+ * @param bitstream the bitstream compared to it
+ * @param diff the differences between the two
+ * @param dbs the databases, or NULL
+ * @param out the output stream
+ *
+ * @return 0 on success, -1 if the databases could not be loaded
+ */
+int dump_diff(const bitstream_parsed_t *base,
+	      const bitstream_parsed_t *bitstream,
+	      const bitstream_diff_t *diff,
+	      analysis_dbs_t *dbs, FILE *out);
+
 #endif /* _HAS_ANALYSIS_H */
@@ -0,0 +1,396 @@
+/*
+ * Copyright (C) 2006, 2007 Jean-Baptiste Note <jean-baptiste.note@m4x.org>
+ *
+ * This file is part of debit.
+ *
+ * Debit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Debit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with debit.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** \file
+    Microbenchmarks of the decoding hot paths.
+
+    A synthetic bitstream with random frames is generated for the chip
+    asked for, so that no design is needed; then each hot path is run
+    again and again on it until a minimal time has elapsed, and its
+    throughput is reported, one line per benchmark, as the time per
+    item and the number of items processed per second. The items are
+    the unit of work of each benchmark: frames, sites, pips, nodes or
+    wire names.
+*/
+
+#include <string.h>
+#include <unistd.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <glib/gprintf.h>
+
+#include "bitstream_parser.h"
+#include "bitstream_write.h"
+#include "bitstream.h"
+#include "bitsynth.h"
+#include "debitlog.h"
+#include "wiring.h"
+#include "localpips.h"
+#include "connexity.h"
+#include "design.h"
+#include "cfgbit.h"
+
+static gchar *datadir = DATADIR;
+static gint chipid = 0;
+static gint seed = 0;
+static gint sparsity = 3;
+static gint npips = 0;
+static gint mintime = 500;
+static gint jobs = 1;
+static gchar *filter = NULL;
+
+#if DEBIT_DEBUG > 0
+unsigned int debit_debug = 0;
+#else
+static unsigned debit_local_debug;
+#endif
+
+/* Number of cfgbits queried at once, as for a pip endpoint */
+#define BENCH_CFGBITS 32
+
+typedef struct _bench_ctx {
+  bitstream_parsed_t bit;
+  gchar *bitfile;
+  chip_descr_t *chip;
+  pip_db_t *pipdb;
+  pip_parsed_dense_t *pipdat;
+  nets_t *nets;
+  /* for each switch type, some bits of its pip lookup */
+  guint cfgbits[NR_SWITCH_TYPE][BENCH_CFGBITS];
+  gsize ncfgbits[NR_SWITCH_TYPE];
+  /* sinks, so that the results are not optimized away */
+  guint32 bits;
+  gsize found;
+} bench_ctx_t;
+
+/* A benchmark runs once, and returns the number of items processed */
+typedef gsize (*bench_fun_t)(bench_ctx_t *ctx);
+
+static gsize
+bench_parse(bench_ctx_t *ctx) {
+  bitstream_parsed_t *parsed = parse_bitstream(ctx->bitfile);
+  gsize nframes;
+
+  if (!parsed)
+    return 0;
+  nframes = bitstream_frame_count(parsed);
+  free_bitstream(parsed);
+  return nframes;
+}
+
+static void
+query_site(unsigned site_x, unsigned site_y,
+	   csite_descr_t *site, gpointer data) {
+  bench_ctx_t *ctx = data;
+  const switch_type_t sw = sw_of_type(site->type);
+  (void) site_x; (void) site_y;
+
+  if (!ctx->ncfgbits[sw])
+    return;
+
+  ctx->bits ^= query_bitstream_site_bits(&ctx->bit, site, ctx->cfgbits[sw],
+					 ctx->ncfgbits[sw]);
+  ctx->found++;
+}
+
+static gsize
+bench_query(bench_ctx_t *ctx) {
+  const gsize found = ctx->found;
+  iterate_over_sites(ctx->chip, query_site, ctx);
+  return ctx->found - found;
+}
+
+static gsize
+bench_pips(bench_ctx_t *ctx) {
+  const chip_descr_t *chip = ctx->chip;
+  pip_parsed_dense_t *pipdat;
+  gsize count;
+
+  pipdat = pips_of_bitstream(ctx->pipdb, chip, &ctx->bit, jobs);
+  if (!pipdat)
+    return 0;
+  count = pipdat->site_index[chip->width * chip->height];
+  free_pipdat(pipdat);
+  return count;
+}
+
+static void
+startpoint_pip(gpointer data, const pip_t pip, const site_ref_t site) {
+  bench_ctx_t *ctx = data;
+  site_ref_t starget;
+  wire_atom_t wtarget;
+
+  if (get_wire_startpoint(ctx->pipdb->wiredb, ctx->chip,
+			  &starget, &wtarget, site, pip.source))
+    ctx->found++;
+}
+
+static gsize
+bench_startpoint(bench_ctx_t *ctx) {
+  const chip_descr_t *chip = ctx->chip;
+  iterate_over_bitpips(ctx->pipdat, chip, startpoint_pip, ctx);
+  return ctx->pipdat->site_index[chip->width * chip->height];
+}
+
+static gsize
+bench_nets(bench_ctx_t *ctx) {
+  nets_t *nets = build_nets(ctx->pipdb, ctx->chip, ctx->pipdat);
+  gsize nnodes;
+
+  if (!nets)
+    return 0;
+  nnodes = nets->nnodes;
+  free_nets(nets);
+  return nnodes;
+}
+
+/* The nets are built once, the classes and their export every run */
+static gsize
+bench_net_classes(bench_ctx_t *ctx) {
+  nets_csr_t *csr;
+  gsize nnodes;
+
+  if (!ctx->nets)
+    ctx->nets = build_nets(ctx->pipdb, ctx->chip, ctx->pipdat);
+  if (!ctx->nets)
+    return 0;
+
+  build_net_classes(ctx->nets);
+  csr = nets_csr(ctx->nets);
+  nnodes = csr->offsets[csr->nnets];
+  free_nets_csr(csr);
+  return nnodes;
+}
+
+static gsize
+bench_wires(bench_ctx_t *ctx) {
+  const wire_db_t *wiredb = ctx->pipdb->wiredb;
+  wire_atom_t wire;
+  gsize i;
+
+  for (i = 0; i < wiredb->dblen; i++)
+    if (!parse_wire_simple(wiredb, &wire, wire_name(wiredb, i)))
+      ctx->found += wire;
+
+  return wiredb->dblen;
+}
+
+static gsize
+bench_write(bench_ctx_t *ctx) {
+  if (bitstream_write(&ctx->bit, NULL, ctx->bitfile))
+    return 0;
+  return bitstream_frame_count(&ctx->bit);
+}
+
+typedef struct _bench {
+  const gchar *name;
+  bench_fun_t fun;
+} bench_t;
+
+static const bench_t benches[] = {
+  { "parse_bitstream", bench_parse },
+  { "query_bitstream_site_bits", bench_query },
+  { "pips_of_bitstream", bench_pips },
+  { "get_wire_startpoint", bench_startpoint },
+  { "build_nets", bench_nets },
+  { "nets_csr", bench_net_classes },
+  { "parse_wire_simple", bench_wires },
+  { "bitstream_write", bench_write },
+};
+
+static void
+run_bench(const bench_t *bench, bench_ctx_t *ctx) {
+  const gdouble limit = (gdouble) mintime / 1000;
+  GTimer *timer = g_timer_new();
+  gdouble elapsed;
+  gsize items = 0;
+  guint runs = 0;
+
+  do {
+    items += bench->fun(ctx);
+    runs++;
+    elapsed = g_timer_elapsed(timer, NULL);
+  } while (elapsed < limit);
+
+  g_timer_destroy(timer);
+
+  if (!items) {
+    g_printf("%-26s %8u %14s %14s\n", bench->name, runs, "-", "-");
+    return;
+  }
+
+  g_printf("%-26s %8u %14.1f %14.0f\n", bench->name, runs,
+	   elapsed * 1e9 / items, items / elapsed);
+}
+
+/* Take the first bits of the gather plan of each switch type */
+static void
+init_cfgbits(bench_ctx_t *ctx) {
+  switch_type_t sw;
+
+  for (sw = 0; sw < NR_SWITCH_TYPE; sw++) {
+    const gather_plan_t *plan = ctx->pipdb->lookup[sw].plan;
+    gsize n = 0;
+    unsigned i, k;
+
+    if (!plan)
+      continue;
+
+    for (i = 0; i < plan->nbytes && n < BENCH_CFGBITS; i++)
+      for (k = 0; k < 8 && n < BENCH_CFGBITS; k++)
+	ctx->cfgbits[sw][n++] = (plan->cfgbytes[i] & ~CFGBIT_BYTE_OFFSET_MASK) | k;
+
+    ctx->ncfgbits[sw] = n;
+  }
+}
+
+static int
+init_bench(bench_ctx_t *ctx) {
+  GRand *rand;
+  GError *error = NULL;
+  int fd, err;
+
+  ctx->chip = get_chip(datadir, chipid);
+  if (!ctx->chip)
+    return -1;
+
+  ctx->pipdb = get_pipdb(datadir);
+  if (!ctx->pipdb)
+    goto out_err_chip;
+
+  init_cfgbits(ctx);
+
+  rand = g_rand_new_with_seed(seed);
+  err = synth_bitstream(&ctx->bit, chipid, rand, sparsity);
+  if (!err && npips > 0)
+    synth_pips(&ctx->bit, ctx->chip, ctx->pipdb, rand, npips);
+  g_rand_free(rand);
+  if (err)
+    goto out_err_pipdb;
+
+  fd = g_file_open_tmp("debit-bench-XXXXXX.bit", &ctx->bitfile, &error);
+  if (fd < 0) {
+    g_warning("could not create the bitstream file: %s", error->message);
+    g_error_free(error);
+    goto out_err_bit;
+  }
+  close(fd);
+
+  /* The parse benchmark reads it back */
+  if (bitstream_write(&ctx->bit, NULL, ctx->bitfile))
+    goto out_err_file;
+
+  /* Some benchmarks work on the pips of the bitstream */
+  ctx->pipdat = pips_of_bitstream(ctx->pipdb, ctx->chip, &ctx->bit, jobs);
+  if (!ctx->pipdat)
+    goto out_err_file;
+  ctx->nets = NULL;
+
+  return 0;
+
+ out_err_file:
+  g_unlink(ctx->bitfile);
+  g_free(ctx->bitfile);
+ out_err_bit:
+  free_synth_bitstream(&ctx->bit);
+ out_err_pipdb:
+  free_pipdb(ctx->pipdb);
+ out_err_chip:
+  release_chip(ctx->chip);
+  return -1;
+}
+
+static void
+release_bench(bench_ctx_t *ctx) {
+  if (ctx->nets)
+    free_nets(ctx->nets);
+  free_pipdat(ctx->pipdat);
+  free_pipdb(ctx->pipdb);
+  release_chip(ctx->chip);
+  g_unlink(ctx->bitfile);
+  g_free(ctx->bitfile);
+  free_synth_bitstream(&ctx->bit);
+}
+
+static GOptionEntry entries[] =
+{
+  {"datadir", 'd', 0, G_OPTION_ARG_FILENAME, &datadir, "Read data files from directory <datadir>", "<datadir>"},
+  {"chip", 'c', 0, G_OPTION_ARG_INT, &chipid, "Generate the bitstream for chip id <chip>", "<chip>"},
+  {"seed", 'r', 0, G_OPTION_ARG_INT, &seed, "Seed of the random frame contents", "<seed>"},
+  {"sparsity", 'p', 0, G_OPTION_ARG_INT, &sparsity, "Set each bit of the frames with probability 2^-<sparsity>", "<sparsity>"},
+  {"pips", 'n', 0, G_OPTION_ARG_INT, &npips, "Also set <pips> random pips of the database", "<pips>"},
+  {"time", 't', 0, G_OPTION_ARG_INT, &mintime, "Run each benchmark for at least <ms> milliseconds", "<ms>"},
+  {"jobs", 'j', 0, G_OPTION_ARG_INT, &jobs, "Use <jobs> threads for the pip extraction", "<jobs>"},
+  {"bench", 'b', 0, G_OPTION_ARG_STRING, &filter, "Only run the benchmarks whose name contains <name>", "<name>"},
+#if DEBIT_DEBUG > 0
+  {"debug", 'g', 0, G_OPTION_ARG_INT, &debit_debug, "Debug verbosity", NULL},
+#else
+  {"debug", 'g', 0, G_OPTION_ARG_INT, &debit_local_debug, "Debug verbosity", NULL},
+#endif
+  { NULL, '\0', 0, 0, NULL, NULL, NULL }
+};
+
+int
+main(int argc, char *argv[])
+{
+  GError *error = NULL;
+  GOptionContext *context = NULL;
+  bench_ctx_t ctx;
+  unsigned i;
+
+#if !GLIB_CHECK_VERSION(2,32,0)
+  if (!g_thread_supported())
+    g_thread_init(NULL);
+#endif
+
+  context = g_option_context_new ("- benchmark the decoding of xilinx bitstreams");
+  g_option_context_add_main_entries (context, entries, NULL);
+  g_option_context_parse (context, &argc, &argv, &error);
+  if (error != NULL) {
+    g_warning("parse error: %s",error->message);
+    g_error_free (error);
+    return -1;
+  }
+
+  g_option_context_free(context);
+
+  if (jobs < 1) {
+    g_warning("The number of jobs must be positive");
+    return -1;
+  }
+
+  if (sparsity < 0 || npips < 0) {
+    g_warning("The sparsity and the number of pips must not be negative");
+    return -1;
+  }
+
+  memset(&ctx, 0, sizeof(ctx));
+  if (init_bench(&ctx))
+    return -1;
+
+  g_printf("%-26s %8s %14s %14s\n", "benchmark", "runs", "ns/op", "items/s");
+  for (i = 0; i < G_N_ELEMENTS(benches); i++) {
+    if (filter && !strstr(benches[i].name, filter))
+      continue;
+    run_bench(&benches[i], &ctx);
+  }
+
+  release_bench(&ctx);
+  return 0;
+}
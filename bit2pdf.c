@@ -197,7 +197,7 @@ int main (int argc, char **argv) {
     return -1;
   }
 
-  nlz = analyze_bitstream(bit, datadir);
+  nlz = analyze_bitstream(bit, datadir, 1);
   if (!nlz) {
     g_warning("Could not analyze the bitfile");
     return -1;
@@ -62,6 +62,13 @@ size_t bytearray_available(const bytearray_t *ba) {
   return ba->len - ba->pos;
 }
 
+static inline
+void bytearray_skip(bytearray_t *ba, const size_t len)
+{
+  g_assert(bytearray_available(ba) >= len);
+  ba->pos += len;
+}
+
 static inline
 gchar bytearray_get_uint8(bytearray_t *ba)
 {
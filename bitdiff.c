@@ -0,0 +1,248 @@
+/*
+ * Copyright (C) 2006, 2007 Jean-Baptiste Note <jean-baptiste.note@m4x.org>
+ *
+ * This file is part of debit.
+ *
+ * Debit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Debit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with debit.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Frame-level bitstream differences
+ */
+
+#include <string.h>
+#include <glib.h>
+
+#include "debitlog.h"
+#include "bitstream_parser.h"
+#include "bitdiff.h"
+#include "parallel.h"
+
+/* Frames may not be aligned in the bitstream file */
+static inline guint32
+load_word(const gchar *frame, const unsigned i) {
+  guint32 word;
+  memcpy(&word, frame + i * sizeof(guint32), sizeof(word));
+  return word;
+}
+
+/* Most frames do not differ. The whole frame is folded first, in a
+   loop without early exit, which the compiler vectorizes */
+static inline gboolean
+frames_differ(const gchar *a, const gchar *b, const unsigned framelen) {
+  guint32 acc = 0;
+  unsigned i;
+
+  for (i = 0; i < framelen; i++)
+    acc |= load_word(a, i) ^ load_word(b, i);
+
+  return acc != 0;
+}
+
+static void
+append_frame_bits(GArray *bits, const frame_record_t *record,
+		  const gchar *old, const gchar *new) {
+  bit_diff_t diff = { .far = record->far, .frame = record->offset };
+  unsigned i;
+
+  for (i = 0; i < record->framelen; i++) {
+    const guint32 word = GUINT32_FROM_BE(load_word(new, i));
+    guint32 delta = GUINT32_FROM_BE(load_word(old, i)) ^ word;
+
+    while (delta) {
+      const gint n = g_bit_nth_msf(delta, -1);
+      diff.bit = i * 32 + 31 - n;
+      diff.set = (word >> n) & 1;
+      g_array_append_val(bits, diff);
+      delta &= ~(1U << n);
+    }
+  }
+}
+
+/*
+ * Columns are dealt round-robin to the workers, which each append to
+ * their own arrays, and everything is then stitched back in column
+ * order. The frames of a column are consecutive in FAR order.
+ */
+
+typedef struct _diff_worker {
+  const bitstream_parsed_t *old;
+  const frame_record_t *records;
+  /* start of each column in the records, plus the end */
+  const guint *columns;
+  guint ncolumns;
+  guint first_column;
+  guint stride;
+  const gchar *zeros;
+  /* shared, but each worker only touches its own columns */
+  guint *column_bits;
+  guint *column_frames;
+  /* private to the worker */
+  GArray *bits;
+  GArray *frames;
+} diff_worker_t;
+
+static gpointer
+diff_columns(gpointer data) {
+  diff_worker_t *worker = data;
+  guint c, i;
+
+  for (c = worker->first_column; c < worker->ncolumns; c += worker->stride) {
+    worker->column_bits[c] = worker->bits->len;
+    worker->column_frames[c] = worker->frames->len;
+
+    for (i = worker->columns[c]; i < worker->columns[c+1]; i++) {
+      const frame_record_t *record = &worker->records[i];
+      const gchar *old = bitstream_frame(worker->old, record->offset);
+      const gchar *new = record->frame;
+      const guint32 frame = record->offset;
+
+      if (old == new)
+	continue;
+      if (!old)
+	old = worker->zeros;
+      if (!new)
+	new = worker->zeros;
+      if (!frames_differ(old, new, record->framelen))
+	continue;
+
+      g_array_append_val(worker->frames, frame);
+      append_frame_bits(worker->bits, record, old, new);
+    }
+  }
+
+  return NULL;
+}
+
+static void
+append_record(const frame_record_t *record, void *data) {
+  GArray *records = data;
+  g_array_append_val(records, *record);
+}
+
+/* Stitch the per-column results of the workers back in order */
+static gpointer
+stitch_columns(const diff_worker_t *workers, const unsigned jobs,
+	       const guint ncolumns, const guint *column_start,
+	       const gsize esize, const gboolean frames, gsize *len) {
+  gsize total = 0;
+  guchar *result;
+  guint c, i;
+
+  for (i = 0; i < jobs; i++)
+    total += (frames ? workers[i].frames : workers[i].bits)->len;
+  result = g_malloc(total * esize);
+  *len = total;
+
+  total = 0;
+  for (c = 0; c < ncolumns; c++) {
+    const diff_worker_t *worker = &workers[c % jobs];
+    const GArray *array = frames ? worker->frames : worker->bits;
+    const guint start = column_start[c];
+    const guint end = (c + jobs < ncolumns) ?
+      column_start[c + jobs] : array->len;
+
+    memcpy(result + total * esize, array->data + start * esize,
+	   (end - start) * esize);
+    total += end - start;
+  }
+
+  return result;
+}
+
+bitstream_diff_t *
+diff_bitstreams(const bitstream_parsed_t *old,
+		const bitstream_parsed_t *new,
+		unsigned jobs) {
+  GArray *records, *columns;
+  bitstream_diff_t *diff;
+  diff_worker_t *workers;
+  guint *column_bits, *column_frames;
+  const frame_record_t *record;
+  guint ncolumns, i;
+  gchar *zeros;
+
+  if (old->chip_struct != new->chip_struct) {
+    g_warning("The bitstreams are not for the same device");
+    return NULL;
+  }
+
+  records = g_array_new(FALSE, FALSE, sizeof(frame_record_t));
+  iterate_over_frame_records(new, append_record, records);
+
+  columns = g_array_new(FALSE, FALSE, sizeof(guint));
+  for (i = 0; i < records->len; i++) {
+    record = &g_array_index(records, frame_record_t, i);
+    if (i == 0 ||
+	far_of_column(record->far) != far_of_column(record[-1].far))
+      g_array_append_val(columns, i);
+  }
+  ncolumns = columns->len;
+  g_array_append_val(columns, i);
+
+  record = (const frame_record_t *) records->data;
+  zeros = g_malloc0(records->len ? record->framelen * sizeof(guint32) : 0);
+
+  jobs = MAX(1, MIN(jobs, ncolumns));
+  workers = g_new(diff_worker_t, jobs);
+  column_bits = g_new(guint, ncolumns);
+  column_frames = g_new(guint, ncolumns);
+
+  for (i = 0; i < jobs; i++) {
+    diff_worker_t *worker = &workers[i];
+    worker->old = old;
+    worker->records = record;
+    worker->columns = (const guint *) columns->data;
+    worker->ncolumns = ncolumns;
+    worker->first_column = i;
+    worker->stride = jobs;
+    worker->zeros = zeros;
+    worker->column_bits = column_bits;
+    worker->column_frames = column_frames;
+    worker->bits = g_array_new(FALSE, FALSE, sizeof(bit_diff_t));
+    worker->frames = g_array_new(FALSE, FALSE, sizeof(guint32));
+  }
+
+  run_workers("diff", diff_columns, workers, sizeof(diff_worker_t), jobs);
+
+  diff = g_new(bitstream_diff_t, 1);
+  diff->bits = stitch_columns(workers, jobs, ncolumns, column_bits,
+			      sizeof(bit_diff_t), FALSE, &diff->nbits);
+  diff->frames = stitch_columns(workers, jobs, ncolumns, column_frames,
+				sizeof(guint32), TRUE, &diff->nframes);
+
+  debit_log(L_BITSTREAM, "%" G_GSIZE_FORMAT " bits of %" G_GSIZE_FORMAT
+	    " frames differ, using %u threads",
+	    diff->nbits, diff->nframes, jobs);
+
+  for (i = 0; i < jobs; i++) {
+    g_array_free(workers[i].bits, TRUE);
+    g_array_free(workers[i].frames, TRUE);
+  }
+  g_free(column_frames);
+  g_free(column_bits);
+  g_free(workers);
+  g_free(zeros);
+  g_array_free(columns, TRUE);
+  g_array_free(records, TRUE);
+
+  return diff;
+}
+
+void
+free_bitstream_diff(bitstream_diff_t *diff) {
+  g_free(diff->bits);
+  g_free(diff->frames);
+  g_free(diff);
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2006, 2007 Jean-Baptiste Note <jean-baptiste.note@m4x.org>
+ *
+ * This file is part of debit.
+ *
+ * Debit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Debit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with debit.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _HAS_BITDIFF_H
+#define _HAS_BITDIFF_H
+
+/** \file
+ *
+ * Frame-level differences between two bitstreams of the same device.
+ *
+ * Frames are compared a word at a time, and the columns of the device
+ * are shared between several threads. Frames absent from a bitstream
+ * read as zeroes.
+ */
+
+#include <glib.h>
+#include "bitstream_parser.h"
+
+/** \brief A configuration bit which differs */
+typedef struct _bit_diff {
+  guint32 far;
+  /* index of the frame in the frame index */
+  guint32 frame;
+  /* bit of the frame, from the MSB of its first byte */
+  guint32 bit;
+  /* value of the bit in the new bitstream */
+  guint32 set;
+} bit_diff_t;
+
+typedef struct _bitstream_diff {
+  /* in FAR order, then in bit order */
+  bit_diff_t *bits;
+  gsize nbits;
+  /* index of the frames which differ, in FAR order */
+  guint32 *frames;
+  gsize nframes;
+} bitstream_diff_t;
+
+/** \brief Compare two bitstreams frame by frame
+ *
+ * The result does not depend on the number of jobs.
+ *
+ * @param old the reference bitstream
+ * @param new the bitstream compared to it
+ * @param jobs the number of threads to use
+ *
+ * @return the differences, or NULL if the bitstreams are not for the
+ * same device
+ */
+bitstream_diff_t *diff_bitstreams(const bitstream_parsed_t *old,
+				  const bitstream_parsed_t *new,
+				  unsigned jobs);
+void free_bitstream_diff(bitstream_diff_t *diff);
+
+#endif /* _HAS_BITDIFF_H */
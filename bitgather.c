@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2006, 2007 Jean-Baptiste Note <jean-baptiste.note@m4x.org>
+ *
+ * This file is part of debit.
+ *
+ * Debit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Debit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with debit.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include "debitlog.h"
+
+#include "bitgather.h"
+#include "sites.h"
+#include "cfgbit.h"
+
+#define NOBYTE G_MAXUINT
+
+/*
+ * The bits are addressed through a direct table indexed by byte
+ * address, which is small: cfgbits are 16-bit quantities.
+ */
+
+static inline guint
+byte_index(const guint cfgbit) {
+  return cfgbit >> CFGBIT_BYTE_OFFSET_LENGTH;
+}
+
+gather_plan_t *
+gather_plan_new(const guint *cfgbits, const gsize nbits) {
+  gather_plan_t *plan = g_new0(gather_plan_t, 1);
+  guint maxindex = 0, nbytes = 0;
+  guint *index_of;
+  gsize i;
+
+  for (i = 0; i < nbits; i++)
+    maxindex = MAX(maxindex, byte_index(cfgbits[i]));
+
+  index_of = g_new(guint, maxindex + 1);
+  for (i = 0; i <= maxindex; i++)
+    index_of[i] = NOBYTE;
+  for (i = 0; i < nbits; i++)
+    index_of[byte_index(cfgbits[i])] = 0;
+
+  /* Number the bytes in increasing address order */
+  for (i = 0; i <= maxindex; i++)
+    if (index_of[i] != NOBYTE)
+      index_of[i] = nbytes++;
+
+  /* The slots must hold the byte index */
+  if (nbytes > (G_MAXUINT16 >> CFGBIT_BYTE_OFFSET_LENGTH) + 1) {
+    g_warning("Too many configuration bytes (%u) for a gather plan", nbytes);
+    g_free(index_of);
+    g_free(plan);
+    return NULL;
+  }
+
+  plan->nbytes = nbytes;
+  plan->cfgbytes = g_new(guint, nbytes);
+  for (i = 0; i <= maxindex; i++)
+    if (index_of[i] != NOBYTE)
+      plan->cfgbytes[index_of[i]] = byte_addr(i << CFGBIT_BYTE_OFFSET_LENGTH);
+
+  plan->nbits = nbits;
+  plan->slots = g_new(guint16, nbits);
+  for (i = 0; i < nbits; i++) {
+    const guint cfgbit = cfgbits[i];
+    plan->slots[i] = (index_of[byte_index(cfgbit)] << CFGBIT_BYTE_OFFSET_LENGTH)
+      | bit_offset(cfgbit);
+  }
+
+  g_free(index_of);
+
+  debit_log(L_PIPS, "gather plan: %u bits in %u bytes", plan->nbits, plan->nbytes);
+  return plan;
+}
+
+void
+gather_plan_free(gather_plan_t *plan) {
+  if (!plan)
+    return;
+  g_free(plan->cfgbytes);
+  g_free(plan->slots);
+  g_free(plan);
+}
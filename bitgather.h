@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2006, 2007 Jean-Baptiste Note <jean-baptiste.note@m4x.org>
+ *
+ * This file is part of debit.
+ *
+ * Debit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Debit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with debit.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _HAS_BITGATHER_H
+#define _HAS_BITGATHER_H
+
+/** \file
+ *
+ * Gather plans for configuration bits.
+ *
+ * A gather plan is the compiled form of a list of cfgbits that is
+ * queried again and again, on every site of a given type. The distinct
+ * configuration bytes the bits live in are listed once, sorted so that
+ * the bytes of a same frame are contiguous; the bitstream is then read
+ * only once per byte and per site (see query_bitstream_site_gather),
+ * and bits are extracted from this small site-local buffer.
+ */
+
+#include <glib.h>
+
+typedef struct _gather_plan {
+  /** Number of distinct configuration bytes */
+  unsigned nbytes;
+  /** Their addresses, in increasing order */
+  guint *cfgbytes;
+  /** Number of bits of the plan */
+  unsigned nbits;
+  /** Per bit, the index of its byte in the buffer, shifted left by 3,
+      ored with the position of the bit in the byte */
+  guint16 *slots;
+} gather_plan_t;
+
+gather_plan_t *gather_plan_new(const guint *cfgbits, const gsize nbits);
+void gather_plan_free(gather_plan_t *plan);
+
+/** \brief Extract (up to 32) bits from a gathered buffer
+ *
+ * @param plan the gather plan the buffer was filled with
+ * @param bytes the gathered buffer
+ * @param first index in the plan of the first bit to extract
+ * @param nbits the number of bits to extract
+ *
+ * @return the bits, packed into a guint32 in the same way as
+ * query_bitstream_site_bits does
+ */
+static inline guint32
+gather_plan_bits(const gather_plan_t *plan, const guchar *bytes,
+		 const unsigned first, const unsigned nbits) {
+  const guint16 *slots = &plan->slots[first];
+  guint32 result = 0;
+  unsigned i;
+
+  for (i = 0; i < nbits; i++) {
+    const unsigned slot = slots[i];
+    result |= ((bytes[slot >> 3] >> (slot & 7)) & 1) << i;
+  }
+
+  return result;
+}
+
+#endif /* _HAS_BITGATHER_H */
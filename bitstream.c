@@ -270,22 +270,20 @@ const type_bits_t type_bits[NR_SITE_TYPE] = {
  */
 
 
-/** \brief Get one config byte from a site
+/** \brief Get the offset of a site in the frames of its column
  *
  * @param bitstream the bitstream data
  * @param site the site queried
- * @param cfgbyte the bit asked for
  *
- * @return the configuration byte asked for
+ * @return the offset, in bytes, of the first byte of the site in each
+ * frame
  */
 
-static const gchar *
-query_bitstream_site_bytea(const bitstream_parsed_t *bitstream,
-			   const csite_descr_t *site,
-			   const unsigned cfgbit) {
+static inline gsize
+query_bitstream_site_offset(const bitstream_parsed_t *bitstream,
+			    const csite_descr_t *site) {
   const chip_struct_t *chip_struct = bitstream->chip_struct;
   const guint lsite_type = site->type;
-  const guint x = site->type_coord.x;
   const guint y = site->type_coord.y;
   const guint y_width = type_bits[lsite_type].y_width;
   const guint flen = chip_struct->framelen * sizeof(uint32_t);
@@ -293,7 +291,25 @@ query_bitstream_site_bytea(const bitstream_parsed_t *bitstream,
 
   /* site offset in the y axis -- inverted. Should not be done here maybe */
   const guint y_type_offset = (y_offset >= 0) ? (unsigned)y_offset : (flen + y_offset);
-  const off_t site_off = y * y_width + y_type_offset;
+  return y * y_width + y_type_offset;
+}
+
+/** \brief Get one config byte from a site
+ *
+ * @param bitstream the bitstream data
+ * @param site the site queried
+ * @param cfgbyte the bit asked for
+ *
+ * @return the configuration byte asked for
+ */
+
+static const gchar *
+query_bitstream_site_bytea(const bitstream_parsed_t *bitstream,
+			   const csite_descr_t *site,
+			   const unsigned cfgbit) {
+  const guint lsite_type = site->type;
+  const guint x = site->type_coord.x;
+  const gsize site_off = query_bitstream_site_offset(bitstream, site);
 
   /* offset in-site. only this really needs to be computed locally */
   const guint xoff = byte_x(cfgbit);
@@ -317,6 +333,60 @@ query_bitstream_site_byte(const bitstream_parsed_t *bitstream,
   return *query_bitstream_site_bytea(bitstream, site, cfgbit);
 }
 
+void
+query_bitstream_site_gather(const bitstream_parsed_t *bitstream,
+			    const csite_descr_t *site,
+			    const gather_plan_t *plan,
+			    guchar *bytes) {
+  const guint lsite_type = site->type;
+  const guint col_type = type_bits[lsite_type].col_type;
+  const guint idx = site->type_coord.x + type_bits[lsite_type].x_type_off;
+  const gsize site_off = query_bitstream_site_offset(bitstream, site);
+  const gchar *frame = NULL;
+  guint frame_x = G_MAXUINT;
+  unsigned i;
+
+  for (i = 0; i < plan->nbytes; i++) {
+    const guint cfgbyte = plan->cfgbytes[i];
+
+    /* The bytes are sorted, so that the frame only changes once in a
+       while */
+    if (byte_x(cfgbyte) != frame_x) {
+      frame_x = byte_x(cfgbyte);
+      frame = get_frame(bitstream, col_type, idx, frame_x);
+    }
+
+    bytes[i] = frame[site_off + byte_y(cfgbyte)];
+  }
+}
+
+guint
+query_bitstream_site_frames(const bitstream_parsed_t *bitstream,
+			    const csite_descr_t *site,
+			    gsize *first) {
+  const chip_struct_t *chip_struct = bitstream->chip_struct;
+  const guint col_type = type_bits[site->type].col_type;
+  const guint idx = site->type_coord.x + type_bits[site->type].x_type_off;
+
+  *first = get_frame_loc(bitstream, col_type, idx, 0) - bitstream->frames[0];
+  return chip_struct->frame_count[col_type];
+}
+
+gint
+query_bitstream_site_cfgbit(const bitstream_parsed_t *bitstream,
+			    const csite_descr_t *site,
+			    const guint frame_x, const guint bit) {
+  const gsize site_off = query_bitstream_site_offset(bitstream, site);
+  const guint y_width = type_bits[site->type].y_width;
+  /* bits are numbered from the MSB of the first byte of the frame */
+  const gsize byte = bit >> 3;
+
+  if (byte < site_off || byte >= site_off + y_width)
+    return -1;
+
+  return assemble_cfgbit(frame_x, ((byte - site_off) << 3) | (7 - (bit & 7)));
+}
+
 /** \brief Get some (up to 4) config bytes from a site
  *
  * @param bitstream the bitstream data
@@ -22,6 +22,7 @@
 
 #include "bitstream_parser.h"
 #include "sites.h"
+#include "bitgather.h"
 
 /** \file
  *
@@ -40,6 +41,24 @@ guint32
 query_bitstream_site_bits(const bitstream_parsed_t *, const csite_descr_t *,
 			  const guint *, const gsize);
 
+/** \brief Read the configuration bytes of a gather plan from a site
+ *
+ * This resolves the location of the site once, and every frame once,
+ * whatever the number of bits in the plan.
+ *
+ * @param bitstream the bitstream data
+ * @param site the site queried
+ * @param plan the gather plan
+ * @param bytes the buffer to fill, of plan->nbytes bytes
+ *
+ * @see gather_plan_bits
+ */
+void
+query_bitstream_site_gather(const bitstream_parsed_t *bitstream,
+			    const csite_descr_t *site,
+			    const gather_plan_t *plan,
+			    guchar *bytes);
+
 void
 set_bitstream_site_bits(const bitstream_parsed_t *, const csite_descr_t *,
 			const uint32_t vals, const guint cfgbits[], const gsize nbits);
@@ -56,4 +75,38 @@ query_bitstream_site_data(gchar *data, const gsize nbytes,
 	                  const bitstream_parsed_t *bitstream,
 			  const csite_descr_t *site);
 
+/** \brief Get the frames holding the configuration of a site
+ *
+ * The frames of a site are consecutive in the frame index.
+ *
+ * @param bitstream the bitstream data
+ * @param site the site queried
+ * @param first where to return the index of the first frame
+ * @return the number of frames
+ *
+ * @see bitstream_frame
+ */
+guint
+query_bitstream_site_frames(const bitstream_parsed_t *bitstream,
+			    const csite_descr_t *site,
+			    gsize *first);
+
+/** \brief Get the configuration bit of a site at a frame bit
+ *
+ * Bits of a frame are numbered from the most significant bit of its
+ * first byte.
+ *
+ * @param bitstream the bitstream data
+ * @param site the site queried
+ * @param frame_x the frame, relative to the first frame of the site
+ * @param bit the bit of the frame
+ * @return the cfgbit, or -1 if the bit does not belong to the site
+ *
+ * @see query_bitstream_site_frames
+ */
+gint
+query_bitstream_site_cfgbit(const bitstream_parsed_t *bitstream,
+			    const csite_descr_t *site,
+			    const guint frame_x, const guint bit);
+
 #endif /* _BITSTREAM_H */
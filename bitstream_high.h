@@ -20,14 +20,17 @@
 static int
 _parse_bitfile(bitstream_parsed_t *dest,
 	       const char *buf_in, const off_t len) {
-  int offset;
+  int offset, err;
   bitstream_parser_t parser;
+  stats_mark_t mark;
 
   /* memset the parser */
   memset(&parser, 0, sizeof(parser));
 
   /* parse the header */
+  stats_begin(&mark);
   offset = parse_header(&dest->header, buf_in, len);
+  stats_end(&mark, STATS_HEADER);
 
   if (offset < 0) {
     debit_log(L_BITSTREAM,"header parsing error");
@@ -37,7 +40,10 @@ _parse_bitfile(bitstream_parsed_t *dest,
   /* Do some allocations according to the type of the bitfile */
   bytearray_init(&parser.ba, len, offset, buf_in);
 
-  return _parse_bitstream_data(dest, &parser);
+  stats_begin(&mark);
+  err = _parse_bitstream_data(dest, &parser);
+  stats_end(&mark, STATS_PACKETS);
+  return err;
 }
 
 /* High-level functions */
@@ -80,7 +86,10 @@ parse_bitstream(const gchar*filename) {
 void
 free_bitstream(bitstream_parsed_t *bitstream) {
   free_indexer(bitstream);
-  g_mapped_file_free(bitstream->file);
+  if (bitstream->file)
+    g_mapped_file_free(bitstream->file);
+  g_free(bitstream->header_data);
+  g_free(bitstream->frame_data);
   g_free(bitstream);
   return;
 }
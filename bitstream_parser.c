@@ -28,6 +28,7 @@
 #include "bitstream_parser.h"
 #include "bitstream_packets.h"
 #include "debitlog.h"
+#include "stats.h"
 #include "codes/crc-ibm.h"
 
 /* This should be merged into the things below */
@@ -525,6 +526,8 @@ typedef struct _bitstream_parser {
 
   /* Specific FDRI quirks */
   const void *last_frame;
+  /* frames recorded, added to the stats once at the end */
+  unsigned nframes;
 
   /* Bitstream proper */
   bytearray_t ba;
@@ -590,6 +593,7 @@ update_crc(bitstream_parser_t *parser,
      In case of strict checks, this should abort the parsing. */
   if (reg == CRC) {
     debit_log(L_BITSTREAM,"write to CRC register yielded %04x", bcc);
+    stats_count(STATS_NCRC, 1);
   }
 }
 
@@ -893,6 +897,19 @@ default_register_write(bitstream_parser_t *parser,
 
   debit_log(L_BITSTREAM,"Writing %zd words to register %s", length, reg_names[reg]);
 
+  /* The frame data is not interpreted any further, so the CRC goes
+     through all of it in one go */
+  if (reg == FDRI && length > 0) {
+    xil_register_t *crcreg = &parser->registers[CRC];
+    const gchar *words = bytearray_get_ptr(ba);
+    crcreg->value = crc_ibm_words(crcreg->value, (const uint8_t *) words,
+				  length, reg);
+    bytearray_skip(ba, (length - 1) * sizeof(guint32));
+    regp->value = bytearray_get_uint32(ba);
+    parser->active_length -= length;
+    return;
+  }
+
   for (i = 0; i < length; i++) {
     guint32 val = bytearray_get_uint32(ba);
     update_crc(parser, reg, val);
@@ -940,6 +957,7 @@ void record_frame(bitstream_parsed_t *parsed,
   if (*frame_loc != NULL)
 	  g_warning("Overwriting already present frame");
   *frame_loc = dataframe;
+  bitstream->nframes++;
 }
 
 /*
@@ -949,7 +967,7 @@ void record_frame(bitstream_parsed_t *parsed,
  */
 
 static inline gsize
-total_frame_count(bitstream_parsed_t *parsed) {
+total_frame_count(const bitstream_parsed_t *parsed) {
   const chip_struct_t *chip_struct = parsed->chip_struct;
   const unsigned *col_count = chip_struct->col_count;
   const unsigned *frame_count = chip_struct->frame_count;
@@ -1056,6 +1074,24 @@ free_wbitstream(bitstream_parsed_t *parsed) {
   free_indexer(parsed);
 }
 
+gsize
+bitstream_frame_count(const bitstream_parsed_t *parsed) {
+  return total_frame_count(parsed);
+}
+
+gchar *
+bitstream_frame(const bitstream_parsed_t *parsed, const gsize i) {
+  gchar **frame_array = (gchar **) &parsed->frames[V2C__NB_CFG];
+  return frame_array[i];
+}
+
+const gchar *
+bitstream_chip_name(const unsigned chipid) {
+  if (chipid >= CHIPS__NUM)
+    return NULL;
+  return chipfiles[chipid];
+}
+
 /* XXX End-of-burden */
 
 void
@@ -1107,6 +1143,39 @@ iterate_over_frames_far(const bitstream_parsed_t *parsed,
   }
 }
 
+/* Iterate over frames in FAR order, along with their FAR */
+void
+iterate_over_frame_records(const bitstream_parsed_t *parsed,
+			   frame_unk_iterator_t iter, void *itdat) {
+  const chip_struct_t *chip_struct = parsed->chip_struct;
+  const chip_id_t chip_id = chipid(parsed);
+  const gchar **frame_array = (const gchar **) &parsed->frames[V2C__NB_CFG];
+  frame_record_t framerec = { .framelen = chip_struct->framelen };
+  sw_far_t far;
+  fill_swfar(&far, 0);
+
+  while (!_last_frame(chip_id, &far)) {
+    const int type = _type_of_far(chip_id, &far);
+    const int idx = _col_of_far(chip_id, &far);
+    const gchar **frameloc = get_frame_loc(parsed, type, idx, far.mna);
+
+    framerec.far = get_hwfar(&far);
+    framerec.offset = frameloc - frame_array;
+    framerec.frame = *frameloc;
+    iter(&framerec, itdat);
+    _far_increment_mna(chip_id, &far);
+  }
+}
+
+guint32
+far_of_column(const guint32 hwfar) {
+  sw_far_t far;
+  fill_swfar(&far, hwfar);
+  far.mna = 0;
+  far.bn = 0;
+  return get_hwfar(&far);
+}
+
 void iterate_over_unk_frames(const bitstream_parsed_t *parsed,
 			     frame_unk_iterator_t iter, void *itdat) {
   (void) parsed;
@@ -1115,6 +1184,28 @@ void iterate_over_unk_frames(const bitstream_parsed_t *parsed,
   return;
 }
 
+int
+bitstream_compact_frames(bitstream_parsed_t *parsed) {
+  (void) parsed;
+  g_warning("No contiguous frame store for this family");
+  return -1;
+}
+
+int
+check_bitstream_ecc(const bitstream_parsed_t *parsed, FILE *out) {
+  (void) parsed;
+  (void) out;
+  g_warning("Frames of this family carry no ECC");
+  return -1;
+}
+
+bitstream_parsed_t *
+parse_bitstream_file(FILE *in) {
+  (void) in;
+  g_warning("Streamed input is not supported for this family");
+  return NULL;
+}
+
 static gint
 handle_fdri_write(bitstream_parsed_t *parsed,
 		  bitstream_parser_t *parser,
@@ -1203,6 +1294,7 @@ static gint
 idcode_write(bitstream_parsed_t *parsed,
 	     bitstream_parser_t *parser) {
   guint32 idcode = register_read(parser, IDCODE);
+  stats_mark_t mark;
   int i;
 
   for (i = 0; i < CHIPS__NUM; i++)
@@ -1210,7 +1302,9 @@ idcode_write(bitstream_parsed_t *parsed,
       parser->type = i;
       parsed->chip_struct = &bitdescr[i];
       /* Allocate control structures */
+      stats_begin(&mark);
       alloc_indexer(parsed);
+      stats_end(&mark, STATS_FRAMES);
       return flr_check(parser, i);
     }
 
@@ -1262,6 +1356,7 @@ _parse_bitstream_data(bitstream_parsed_t *dest,
     debit_log(L_BITSTREAM,"Error parsing bitstream: %i", advance);
   }
 
+  stats_count(STATS_NFRAMES, parser->nframes);
   return advance;
 }
 
@@ -1347,26 +1442,35 @@ read_next_token(bitstream_parsed_t *parsed,
   case STATE_WAITING_DATA:
     {
       register_index_t reg = parser->active_register;
-      gsize avail = bytearray_available(ba),
+      gsize avail = bytearray_available(ba) / sizeof(guint32),
 	length = parser->active_length;
+      stats_mark_t mark;
+
+      /* FDRI writes are followed by an autoCRC word */
+      if (length + (reg == FDRI) > avail) {
+	debit_log(L_BITSTREAM,"Register length of %zd words while only %zd words remain",
+		  length, avail);
+	return -1;
+      }
 
       offset = length;
 
       /* pre-processing */
       switch (reg) {
-      case FDRI:
-	offset = handle_fdri_write(parsed, parser, length);
+      case FDRI: {
+	gint written;
+	stats_begin(&mark);
+	written = handle_fdri_write(parsed, parser, length);
+	stats_end(&mark, STATS_FRAMES);
+	if (written < 0)
+	  return -1;
+	offset = written;
 	break;
+      }
       default:
 	break;
       }
 
-      if (offset > avail) {
-	debit_log(L_BITSTREAM,"Register length of %zd words while only %zd words remain",
-		  length, avail);
-	return -1;
-      }
-
       /* This function does the CRC update */
       default_register_write(parser, reg, length);
 
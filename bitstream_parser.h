@@ -21,6 +21,7 @@
 #define _BITSTREAM_PARSER_H
 
 #include <stdint.h>
+#include <stdio.h>
 #include <glib.h>
 #include "bitheader.h"
 
@@ -42,11 +43,42 @@ typedef struct _bitstream_parsed {
   /* mmapped file information */
   GMappedFile *file;
 
+  /* or, for streamed bitstreams, data owned by the structure */
+  gchar *header_data;
+  gpointer frame_data;
+
+  /* contiguous frame store, if any: frame i of the frame index is at
+     frame_store + i * frame_stride */
+  gchar *frame_store;
+  gsize frame_stride;
+
 } bitstream_parsed_t;
 
 int alloc_wbitstream(bitstream_parsed_t *bitstream);
 void free_wbitstream(bitstream_parsed_t *parser);
 
+/** \brief Number of frames in the frame index of a bitstream
+ *
+ * This is the number of frames of the whole device, pad frames
+ * included.
+ */
+gsize bitstream_frame_count(const bitstream_parsed_t *bitstream);
+
+/** \brief Get a frame of the frame index by its position
+ *
+ * @param bitstream the bitstream data
+ * @param i the index of the frame, less than bitstream_frame_count
+ * @return the frame data, which is NULL if the frame is absent
+ */
+gchar *bitstream_frame(const bitstream_parsed_t *bitstream, const gsize i);
+
+/** \brief Get the device name of a chip id
+ *
+ * @return the name, suitable for the DEVICE_TYPE header option, or
+ * NULL if the chip id is not known to this family
+ */
+const gchar *bitstream_chip_name(const unsigned chipid);
+
 bitstream_parsed_t *parse_bitstream(const gchar*filename);
 void free_bitstream(bitstream_parsed_t *bitstream);
 
@@ -80,6 +112,22 @@ typedef void (*frame_unk_iterator_t)(const frame_record_t *frame,
 void iterate_over_unk_frames(const bitstream_parsed_t *parsed,
 			     frame_unk_iterator_t iter, void *itdat);
 
+/** \brief Iterate over all frames of the device in FAR order
+ *
+ * Unlike iterate_over_unk_frames, pad frames are included, and the
+ * frame of a record is NULL when it is absent from the bitstream. The
+ * offset of a record is the index of its frame, as given to
+ * bitstream_frame.
+ */
+void iterate_over_frame_records(const bitstream_parsed_t *parsed,
+				frame_unk_iterator_t iter, void *itdat);
+
+/** \brief Get the FAR of the first frame of the column of a frame
+ *
+ * The frames of a column are consecutive in FAR order.
+ */
+guint32 far_of_column(const guint32 hwfar);
+
 /* for v2 */
 void
 typed_frame_name(char *buf, unsigned buf_len,
@@ -92,4 +140,76 @@ int
 snprintf_far(char *buf, const size_t buf_len,
 	     const uint32_t hwfar);
 
+/** \brief Copy the frames into a contiguous store
+ *
+ * The frames are laid out in the order of the frame index, so that the
+ * frames of a column are adjacent, each one starting on a cacheline.
+ * Frame lookups are then plain arithmetic. Bitstreams parsed by the
+ * streaming parser already have such a store.
+ *
+ * The frame records are repointed into the store as well, so that the
+ * input file is not read anymore. As the store holds one frame per
+ * FAR, the records of a frame written several times all point to its
+ * last contents, as with the streaming parser.
+ *
+ * @return 0 on success, -1 if the family has no frame store
+ */
+int bitstream_compact_frames(bitstream_parsed_t *parsed);
+
+/** \brief Check the ECC of every frame of the bitstream
+ *
+ * The frames which fail the check are reported by FAR to the stream
+ * out.
+ *
+ * @return the number of frames which failed, or -1 if the bitstream
+ * has no ECC
+ */
+int check_bitstream_ecc(const bitstream_parsed_t *parsed, FILE *out);
+
+/****
+ * Streaming parser (v4, v5)
+ *
+ * The bitstream is pushed in chunks of any size, as it arrives. Frames
+ * are copied out of the input as soon as they are complete, so that
+ * only a partial packet of input is kept around.
+ ****/
+
+typedef struct _bitstream_stream bitstream_stream_t;
+
+/** \brief Start parsing a streamed bitstream
+ *
+ * @param iter function called on each frame as it is recorded, or NULL
+ * @param itdat data passed to the function
+ */
+bitstream_stream_t *bitstream_stream_new(frame_unk_iterator_t iter, void *itdat);
+
+/** \brief Push some data into the parser
+ *
+ * @return 0 on success, -1 if the bitstream is invalid. In the later
+ * case, the stream must be freed with bitstream_stream_free.
+ */
+int bitstream_stream_feed(bitstream_stream_t *stream,
+			  const gchar *buf, const gsize len);
+
+/** \brief End the parsing of a streamed bitstream
+ *
+ * The stream is freed.
+ *
+ * @return the parsed bitstream, to be freed with free_bitstream, or
+ * NULL if the bitstream was invalid or truncated
+ */
+bitstream_parsed_t *bitstream_stream_finish(bitstream_stream_t *stream);
+
+void bitstream_stream_free(bitstream_stream_t *stream);
+
+/** \brief Parse a bitstream read from a stdio stream
+ *
+ * The input is fed to the streaming parser as it is read, so that it
+ * can come from a pipe.
+ *
+ * @return the parsed bitstream, to be freed with free_bitstream, or
+ * NULL on error
+ */
+bitstream_parsed_t *parse_bitstream_file(FILE *in);
+
 #endif /* _BITSTREAM_PARSER_H */
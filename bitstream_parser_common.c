@@ -17,10 +17,12 @@
  * along with debit.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <errno.h>
 #include <string.h>
 #include <stdio.h>
 
 #include <glib.h>
+#include <glib/gprintf.h>
 
 #include "bitarray.h"
 #include "bitstream_packets.h"
@@ -28,6 +30,7 @@
 #include "bitheader.h"
 #include "bitstream_parser.h"
 #include "debitlog.h"
+#include "stats.h"
 
 #include "codes/crc32-c.h"
 #include "codes/xhamming.h"
@@ -93,9 +96,21 @@ update_crc(bitstream_parser_t *parser,
      In case of strict checks, this should abort the parsing. */
   if (reg == CRC) {
     debit_log(L_BITSTREAM,"write to CRC register yielded %04x", bcc);
+    stats_count(STATS_NCRC, 1);
   }
 }
 
+/* Same as update_crc for a series of writes to a data register, the
+   words being still in bitstream order */
+static inline void
+update_crc_words(bitstream_parser_t *parser,
+		 const register_index_t reg,
+		 const gchar *words, const gsize nwords) {
+  xil_register_t *crcreg = &parser->registers[CRC];
+  crcreg->value = crc32c_words(crcreg->value, (const uint8_t *) words,
+			       nwords, reg);
+}
+
 /***
  * FAR handling
  */
@@ -272,34 +287,6 @@ get_frameloc_from_far(const bitstream_parsed_t *parsed,
   return get_frameloc_from_swfar(parsed, chiptype, &far);
 }
 
-static
-void record_frame(bitstream_parsed_t *parsed,
-		  bitstream_parser_t *bitstream,
-		  const guint32 myfar) {
-  const char *dataframe = bitstream->last_frame;
-  frame_record_t framerec;
-  framerec.far = myfar;
-  framerec.framelen = frame_length;
-  framerec.frame = dataframe;
-
-  /* Check the frame's Hamming Code */
-  /* (void) check_hamming_frame(dataframe, myfar); */
-
-  /* record the framerec, iif the frame is not a pad frame, as pad
-     frames are not present in compressed bitstreams, it seems... */
-  if (far_is_pad(bitstream, myfar) == FALSE)
-    g_array_append_val(parsed->frame_array, framerec);
-
-  /* record the frame in the flat descriptor */
-  {
-    const id_vlx_t chiptype = bitstream->type;
-    const gchar **framepos = get_frameloc_from_far(parsed, chiptype, myfar);
-    if (*framepos)
-      g_warning("Replacing frame already present for far [%08x]", myfar);
-    *framepos = dataframe;
-  }
-}
-
 /* Bitstream frame indexing */
 
 static unsigned
@@ -319,6 +306,102 @@ total_frame_count(const chip_struct_t *chip_struct) {
   return total_size;
 }
 
+/* The frame store holds all frames in the order of the frame index,
+   each one padded to a whole number of cachelines */
+#define FRAME_STORE_ALIGN 64
+
+static void
+alloc_frame_store(bitstream_parsed_t *parsed) {
+  const gsize align = FRAME_STORE_ALIGN - 1;
+  const gsize stride = (frame_length * sizeof(guint32) + align) & ~align;
+  gchar *data;
+
+  data = g_malloc0(total_frame_count(parsed->chip_struct) * stride + align);
+  parsed->frame_data = data;
+  parsed->frame_store = GSIZE_TO_POINTER((GPOINTER_TO_SIZE(data) + align) & ~align);
+  parsed->frame_stride = stride;
+}
+
+/* When the input is not kept around, frames are copied into the frame
+   store, at the position of their FAR. A frame written twice is thus
+   overwritten in place. */
+static const gchar *
+store_frame(bitstream_parsed_t *parsed,
+	    const gchar **framepos, const gchar *dataframe) {
+  const gchar **frame_array = (const gchar **) &parsed->frames[VC__NB_CFG];
+  gchar *dest;
+
+  if (!parsed->frame_store)
+    alloc_frame_store(parsed);
+
+  dest = parsed->frame_store + (framepos - frame_array) * parsed->frame_stride;
+  memcpy(dest, dataframe, frame_length * sizeof(guint32));
+  return dest;
+}
+
+int
+bitstream_compact_frames(bitstream_parsed_t *parsed) {
+  const gchar **frame_array = (const gchar **) &parsed->frames[VC__NB_CFG];
+  const chip_struct_t *chip_struct = parsed->chip_struct;
+  const gsize total_frames = total_frame_count(chip_struct);
+  gsize i;
+
+  if (parsed->frame_store)
+    return 0;
+
+  alloc_frame_store(parsed);
+
+  /* Frames missing from the bitstream stay zeroed in the store */
+  for (i = 0; i < total_frames; i++) {
+    gchar *dest = parsed->frame_store + i * parsed->frame_stride;
+    if (!frame_array[i])
+      continue;
+    memcpy(dest, frame_array[i], frame_length * sizeof(guint32));
+    frame_array[i] = dest;
+  }
+
+  /* The frame records must not point into the input anymore either */
+  for (i = 0; i < parsed->frame_array->len; i++) {
+    frame_record_t *rec = &g_array_index(parsed->frame_array, frame_record_t, i);
+    rec->frame = *get_frameloc_from_far(parsed, chip_struct->chip, rec->far);
+  }
+
+  return 0;
+}
+
+static
+void record_frame(bitstream_parsed_t *parsed,
+		  bitstream_parser_t *bitstream,
+		  const guint32 myfar) {
+  const id_vlx_t chiptype = bitstream->type;
+  const gchar **framepos = get_frameloc_from_far(parsed, chiptype, myfar);
+  const char *dataframe = bitstream->last_frame;
+  frame_record_t framerec;
+
+  /* Check the frame's Hamming Code */
+  /* (void) check_hamming_frame(dataframe, myfar); */
+
+  /* record the frame in the flat descriptor */
+  if (*framepos)
+    g_warning("Replacing frame already present for far [%08x]", myfar);
+  if (bitstream->frame_copy)
+    dataframe = store_frame(parsed, framepos, dataframe);
+  *framepos = dataframe;
+
+  framerec.far = myfar;
+  framerec.framelen = frame_length;
+  framerec.frame = dataframe;
+  bitstream->nframes++;
+
+  /* record the framerec, iif the frame is not a pad frame, as pad
+     frames are not present in compressed bitstreams, it seems... */
+  if (far_is_pad(bitstream, myfar) == FALSE) {
+    g_array_append_val(parsed->frame_array, framerec);
+    if (bitstream->frame_hook)
+      bitstream->frame_hook(&framerec, bitstream->frame_hook_data);
+  }
+}
+
 static void
 alloc_indexer(bitstream_parsed_t *parsed) {
   const chip_struct_t *chip_struct = parsed->chip_struct;
@@ -375,24 +458,21 @@ fill_indexer(bitstream_parsed_t *parsed) {
   gchar **frame_array = (gchar **) &parsed->frames[VC__NB_CFG];
   const chip_struct_t *chip_struct = parsed->chip_struct;
   const unsigned total_frames = total_frame_count(chip_struct);
-  const unsigned framelen = chip_struct->framelen;
-  uint32_t *current_frame;
   unsigned i;
 
-  /* Alloc *all* frames. A bit tedious... */
-  current_frame = g_new0(uint32_t, total_frames * framelen);
+  /* Alloc *all* frames, in the frame store */
+  alloc_frame_store(parsed);
 
-  for(i = 0; i < total_frames; i++) {
-    frame_array[i] = (char *)current_frame;
-    current_frame += framelen;
-  }
+  for(i = 0; i < total_frames; i++)
+    frame_array[i] = parsed->frame_store + i * parsed->frame_stride;
 }
 
 static void
 empty_indexer(bitstream_parsed_t *parsed) {
-  gchar **frame_array = (gchar **) &parsed->frames[VC__NB_CFG];
   /* Free *all* frames at once. Easy... */
-  g_free (frame_array[0]);
+  g_free (parsed->frame_data);
+  parsed->frame_data = NULL;
+  parsed->frame_store = NULL;
 }
 
 int
@@ -420,6 +500,24 @@ free_wbitstream(bitstream_parsed_t *parsed) {
   free_indexer(parsed);
 }
 
+gsize
+bitstream_frame_count(const bitstream_parsed_t *parsed) {
+  return total_frame_count(parsed->chip_struct);
+}
+
+gchar *
+bitstream_frame(const bitstream_parsed_t *parsed, const gsize i) {
+  gchar **frame_array = (gchar **) &parsed->frames[VC__NB_CFG];
+  return frame_array[i];
+}
+
+const gchar *
+bitstream_chip_name(const unsigned chipid) {
+  if (chipid >= CHIPS__NUM)
+    return NULL;
+  return chipfiles[chipid];
+}
+
 /* XXX End-of-burden */
 
 void
@@ -445,6 +543,31 @@ iterate_over_unk_frames(const bitstream_parsed_t *parsed,
   }
 }
 
+/* Check the ECC of all frames, reporting the bad ones to out by FAR */
+int
+check_bitstream_ecc(const bitstream_parsed_t *parsed, FILE *out) {
+  GArray *array = parsed->frame_array;
+  guint nframes = array->len, i;
+  int bad = 0;
+
+  for (i = 0; i < nframes; i++) {
+    const frame_record_t *frame = &g_array_index (array, frame_record_t, i);
+    const unsigned stored = hamming_frame_code(frame->frame);
+    const unsigned computed = hamming_frame_compute(frame->frame);
+
+    if (stored != computed) {
+      gchar far_name[32];
+      snprintf_far(far_name, sizeof(far_name), frame->far);
+      g_fprintf(out, "ecc %s stored %03x computed %03x\n",
+		far_name, stored, computed);
+      bad++;
+    }
+  }
+
+  debit_log(L_BITSTREAM, "%i frames out of %i failed the ECC check", bad, nframes);
+  return bad;
+}
+
 #include <assert.h>
 
 /* Get chip ID directly */
@@ -486,6 +609,34 @@ iterate_over_frames_far(const bitstream_parsed_t *parsed,
   }
 }
 
+/* Iterate over frames in FAR order, along with their FAR */
+void
+iterate_over_frame_records(const bitstream_parsed_t *parsed,
+			   frame_unk_iterator_t iter, void *itdat) {
+  const id_vlx_t chiptype = chipid(parsed);
+  const gchar **frame_array = (const gchar **) &parsed->frames[VC__NB_CFG];
+  frame_record_t framerec = { .framelen = frame_length };
+  sw_far_t far;
+  fill_swfar(&far, 0);
+
+  while (!_last_frame(&far)) {
+    const gchar **frameloc = get_frameloc_from_swfar(parsed, chiptype, &far);
+    framerec.far = get_hwfar(&far);
+    framerec.offset = frameloc - frame_array;
+    framerec.frame = *frameloc;
+    iter(&framerec, itdat);
+    _far_increment_mna(chiptype, &far);
+  }
+}
+
+guint32
+far_of_column(const guint32 hwfar) {
+  sw_far_t far;
+  fill_swfar(&far, hwfar);
+  far.mna = 0;
+  return get_hwfar(&far);
+}
+
 static gint
 handle_fdri_write(bitstream_parsed_t *parsed,
 		  bitstream_parser_t *parser,
@@ -493,13 +644,14 @@ handle_fdri_write(bitstream_parsed_t *parsed,
   bytearray_t *ba = &parser->ba;
   const gchar *frame = bytearray_get_ptr(ba);
   guint i, nrframes;
-  guint32 last_far = 0;
 
-  /* Frame length writes must be a multiple of the flr length */
-  if (length % frame_length) {
+  /* Frame length writes must be a multiple of the flr length. When
+     streaming, only part of the write may be handled here, so check
+     the whole of it */
+  if (parser->active_length % frame_length) {
     debit_log(L_BITSTREAM,"%i bytes in FDRI write, "
 	      "which is inconsistent with the FLR value %i",
-	      length, frame_length);
+	      parser->active_length, frame_length);
     return -1;
   }
 
@@ -507,20 +659,22 @@ handle_fdri_write(bitstream_parsed_t *parsed,
 
   /* We handle here a complete series of writes, so that we have
      the ability to see the start and end frames */
-  last_far = register_read(parser, FAR);
-
   for (i = 0; i < nrframes; i++) {
 
     /* The first write of a FDRI write in WCFG mode does not flush the
        previous writes. As I don't know what other modes may be on, be
        conservative wrt to mode setting */
-    if (i != 0)
+    if (parser->fdri_frames++ != 0)
       /* flush the previous frame into the frame array with the previous
 	 FAR address */
-      record_frame(parsed, parser, last_far);
+      record_frame(parsed, parser, parser->last_far);
 
-    last_far = register_read(parser, FAR);
-    parser->last_frame = frame;
+    parser->last_far = register_read(parser, FAR);
+    if (parser->frame_copy) {
+      memcpy(parser->frame_copy, frame, frame_length * sizeof(guint32));
+      parser->last_frame = parser->frame_copy;
+    } else
+      parser->last_frame = frame;
 
     far_increment(parser);
     frame += frame_length * sizeof(guint32);
@@ -528,6 +682,12 @@ handle_fdri_write(bitstream_parsed_t *parsed,
 
   debit_log(L_BITSTREAM,"%i frames written to fdri", i);
 
+  /* The frame data is not interpreted any further, so the CRC goes
+     through all of it in one go */
+  update_crc_words(parser, FDRI, bytearray_get_ptr(ba), length);
+  bytearray_skip(ba, length * sizeof(guint32));
+  parser->active_length -= length;
+
   return length;
 }
 
@@ -559,6 +719,7 @@ static gint
 idcode_write(bitstream_parsed_t *parsed,
 	     bitstream_parser_t *parser) {
   guint32 idcode = register_read(parser, IDCODE);
+  stats_mark_t mark;
   int i;
 
   for (i = 0; i < XC_VLX__NUM; i++)
@@ -566,7 +727,9 @@ idcode_write(bitstream_parsed_t *parsed,
       parser->type = i;
       parsed->chip_struct = &bitdescr[i];
       /* Allocate control structures */
+      stats_begin(&mark);
       alloc_indexer(parsed);
+      stats_end(&mark, STATS_FRAMES);
       return 0;
     }
 
@@ -618,6 +781,7 @@ _parse_bitstream_data(bitstream_parsed_t *dest,
     debit_log(L_BITSTREAM,"Error parsing bitstream: %i", advance);
   }
 
+  stats_count(STATS_NFRAMES, parser->nframes);
   return advance;
 }
 
@@ -698,37 +862,48 @@ read_next_token(bitstream_parsed_t *parsed,
       }
 
       /* If there is data to read, then switch state */
-      if (parser->active_length > 0)
+      if (parser->active_length > 0) {
 	parser->state = STATE_WAITING_DATA;
+	parser->fdri_frames = 0;
+      }
 
     }
     break;
   case STATE_WAITING_DATA:
     {
       register_index_t reg = parser->active_register;
-      gsize avail = bytearray_available(ba),
+      gsize avail = bytearray_available(ba) / sizeof(guint32),
 	length = parser->active_length;
+      stats_mark_t mark;
+
+      /* When streaming, handle the frames that have already arrived */
+      if (reg == FDRI && parser->frame_copy)
+	length = MIN(length, avail / frame_length * frame_length);
+
+      if (length > avail) {
+	debit_log(L_BITSTREAM,"Register length of %zd words while only %zd words remain",
+		  length, avail);
+	return -1;
+      }
 
       offset = length;
 
-      /* pre-processing */
+      /* pre-processing. These functions do the CRC update */
       switch (reg) {
-      case FDRI:
-	offset = handle_fdri_write(parsed, parser, length);
+      case FDRI: {
+	gint written;
+	stats_begin(&mark);
+	written = handle_fdri_write(parsed, parser, length);
+	stats_end(&mark, STATS_FRAMES);
+	if (written < 0)
+	  return -1;
 	break;
+      }
       default:
+	default_register_write(parser, reg, length);
 	break;
       }
 
-      if (offset > avail) {
-	debit_log(L_BITSTREAM,"Register length of %zd words while only %zd words remain",
-		  length, avail);
-	return -1;
-      }
-
-      /* This function does the CRC update */
-      default_register_write(parser, reg, length);
-
       /* post-processing */
       switch(reg) {
       case FDRI:
@@ -762,4 +937,181 @@ read_next_token(bitstream_parsed_t *parsed,
   return offset;
 }
 
+
+/***
+ * Streaming parser
+ ***/
+
+/* Give up finding the synchronization word after this much data */
+#define STREAM_MAX_HEADER (64 * 1024)
+
+struct _bitstream_stream {
+  bitstream_parsed_t *parsed;
+  bitstream_parser_t parser;
+  /* input not consumed yet, at most one packet */
+  GByteArray *input;
+};
+
+bitstream_stream_t *
+bitstream_stream_new(frame_unk_iterator_t iter, void *itdat) {
+  bitstream_stream_t *stream = g_new0(bitstream_stream_t, 1);
+  bitstream_parser_t *parser = &stream->parser;
+
+  stream->parsed = g_new0(bitstream_parsed_t, 1);
+  stream->input = g_byte_array_new();
+
+  parser->state = STATE_UNSYNCHED;
+  parser->frame_copy = g_new(guint32, frame_length);
+  parser->frame_hook = iter;
+  parser->frame_hook_data = itdat;
+
+  return stream;
+}
+
+void
+bitstream_stream_free(bitstream_stream_t *stream) {
+  stats_count(STATS_NFRAMES, stream->parser.nframes);
+  if (stream->parsed)
+    free_bitstream(stream->parsed);
+  g_byte_array_free(stream->input, TRUE);
+  g_free(stream->parser.frame_copy);
+  g_free(stream);
+}
+
+static inline void
+stream_consume(bitstream_stream_t *stream, const gsize len) {
+  g_byte_array_remove_range(stream->input, 0, len);
+}
+
+/* The header is parsed once the synchronization word has arrived, as
+   it is known to be complete then */
+static int
+stream_synchronize(bitstream_stream_t *stream) {
+  static const guchar synchro[4] = { 0xAA, 0x99, 0x55, 0x66 };
+  bitstream_parsed_t *parsed = stream->parsed;
+  GByteArray *input = stream->input;
+  gsize pos;
+  int offset;
+
+  for (pos = 0; pos + sizeof(synchro) <= input->len; pos++)
+    if (!memcmp(&input->data[pos], synchro, sizeof(synchro)))
+      break;
+
+  if (pos + sizeof(synchro) > input->len) {
+    if (input->len > STREAM_MAX_HEADER) {
+      debit_log(L_BITSTREAM,"Could not synchronize bitstream");
+      return -1;
+    }
+    /* Wait for more data */
+    return 0;
+  }
+
+  /* The header options point into the header, which must outlive the
+     input buffer */
+  parsed->header_data = g_malloc(pos);
+  memcpy(parsed->header_data, input->data, pos);
+  offset = parse_header(&parsed->header, parsed->header_data, pos);
+
+  if (offset < 0 || (gsize) offset > pos ||
+      (pos - offset) % sizeof(guint32)) {
+    debit_log(L_BITSTREAM,"header parsing error");
+    return -1;
+  }
+
+  stream_consume(stream, pos + sizeof(synchro));
+  stream->parser.state = STATE_WAITING_CTRL;
+  return 0;
+}
+
+/* Number of words needed before the next token can be read */
+static inline gsize
+token_words(const bitstream_parser_t *parser) {
+  if (parser->state != STATE_WAITING_DATA)
+    return 1;
+  /* FDRI writes are handled a few frames at a time */
+  if (parser->active_register == FDRI && parser->active_length > frame_length)
+    return frame_length;
+  return parser->active_length;
+}
+
+int
+bitstream_stream_feed(bitstream_stream_t *stream,
+		      const gchar *buf, const gsize len) {
+  bitstream_parser_t *parser = &stream->parser;
+  bytearray_t *ba = &parser->ba;
+  gint advance = 0;
+
+  g_byte_array_append(stream->input, (const guint8 *) buf, len);
+
+  if (parser->state == STATE_UNSYNCHED) {
+    if (stream_synchronize(stream))
+      return -1;
+    if (parser->state == STATE_UNSYNCHED)
+      return 0;
+  }
+
+  bytearray_init(ba, stream->input->len, 0, (const gchar *) stream->input->data);
+
+  while (bytearray_available(ba) >= token_words(parser) * sizeof(guint32)) {
+    advance = read_next_token(stream->parsed, parser);
+    if (advance < 0) {
+      debit_log(L_BITSTREAM,"Error parsing bitstream: %i", advance);
+      return -1;
+    }
+  }
+
+  stream_consume(stream, bytearray_offset(ba));
+  return 0;
+}
+
+bitstream_parsed_t *
+bitstream_stream_finish(bitstream_stream_t *stream) {
+  bitstream_parsed_t *parsed = stream->parsed;
+  const bitstream_parser_t *parser = &stream->parser;
+
+  if (parser->state != STATE_WAITING_CTRL || stream->input->len != 0 ||
+      parsed->chip_struct == NULL) {
+    debit_log(L_BITSTREAM,"Truncated bitstream");
+    bitstream_stream_free(stream);
+    return NULL;
+  }
+
+  debit_log(L_BITSTREAM,"End-of-bitstream reached");
+  stream->parsed = NULL;
+  bitstream_stream_free(stream);
+  return parsed;
+}
+
+/* Read size of the streamed input */
+#define STREAM_CHUNK (64 * 1024)
+
+bitstream_parsed_t *
+parse_bitstream_file(FILE *in) {
+  bitstream_stream_t *stream = bitstream_stream_new(NULL, NULL);
+  bitstream_parsed_t *parsed;
+  gchar *buf = g_malloc(STREAM_CHUNK);
+  stats_mark_t mark;
+  gsize len;
+
+  stats_begin(&mark);
+  while ((len = fread(buf, 1, STREAM_CHUNK, in)) > 0)
+    if (bitstream_stream_feed(stream, buf, len))
+      goto out_err;
+
+  if (ferror(in)) {
+    debit_log(L_BITSTREAM,"could not read bitstream: %s", g_strerror(errno));
+    goto out_err;
+  }
+
+  parsed = bitstream_stream_finish(stream);
+  stats_end(&mark, STATS_PACKETS);
+  g_free(buf);
+  return parsed;
+
+ out_err:
+  bitstream_stream_free(stream);
+  g_free(buf);
+  return NULL;
+}
+
 #include "bitstream_high.h"
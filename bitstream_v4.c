@@ -110,6 +110,9 @@ const type_bits_t type_bits[NR_SITE_TYPE] = {
 
 #if defined (VIRTEX4)
 
+/* Rows are packed by groups of 16 */
+#define ROW_SITES 16
+
 /*
  * Helper function
  */
@@ -135,6 +138,95 @@ mirror_byte(const unsigned char dat) {
 /*   return result; */
 /* } */
 
+/* We must skip 4 bytes of SECDED and CLK information in the middle of
+ * the frame */
+static inline unsigned
+row_second_half(const unsigned row_local) {
+  return (row_local >> 1) & 0x4;
+}
+
+/* When top is one, the frame is read backwards; otherwise bits are
+   mirrored. The adressing is a bit strange, due to the frame byte
+   order */
+static inline unsigned
+frame_byte_index(const unsigned frame_y, const unsigned top) {
+  return (top ? (164 - 1 - frame_y) : frame_y) ^ 0x3;
+}
+
+static inline guchar
+frame_byte(const gchar *frame, const unsigned frame_y, const unsigned top) {
+  const unsigned char byte = frame[frame_byte_index(frame_y, top)];
+  return top ? byte : mirror_byte(byte);
+}
+
+/* Mask of a bit of a byte returned by frame_byte, in the frame */
+static inline guchar
+frame_bit_mask(const unsigned offset, const unsigned top) {
+  return 1 << (top ? offset : 7 - offset);
+}
+
+#elif defined(VIRTEX5)
+
+/* Rows are packed by groups of 20 */
+#define ROW_SITES 20
+
+static inline unsigned
+row_second_half(const unsigned row_local) {
+  return (row_local >= 10) ? 4 : 0;
+}
+
+/* The adressing here is a bit strange, due to the frame byte order */
+static inline unsigned
+frame_byte_index(const unsigned frame_y, const unsigned top) {
+  (void) top;
+  return frame_y ^ 0x3;
+}
+
+static inline guchar
+frame_byte(const gchar *frame, const unsigned frame_y, const unsigned top) {
+  return frame[frame_byte_index(frame_y, top)];
+}
+
+static inline guchar
+frame_bit_mask(const unsigned offset, const unsigned top) {
+  (void) top;
+  return 1 << offset;
+}
+
+#endif
+
+/* Location of the frames of a site */
+typedef struct _site_loc {
+  guint col_type;
+  unsigned x;
+  unsigned row;
+  unsigned top;
+  /* Offset of the site in its frames */
+  unsigned frame_y;
+} site_loc_t;
+
+static inline void
+locate_site(site_loc_t *loc,
+	    const bitstream_parsed_t *bitstream,
+	    const csite_descr_t *site) {
+  const chip_struct_t *chip_struct = bitstream->chip_struct;
+  const unsigned y = site->type_coord.y;
+  const unsigned ymid = chip_struct->row_count;
+  const unsigned row = y / ROW_SITES;
+  const unsigned row_local = y % ROW_SITES;
+  /* a bittest should be sufficient for top, but is hard to compute
+     (depends on bitlength of the value, which is costly to compute) */
+  const unsigned top = (row >= ymid) ? 0 : 1;
+
+  loc->col_type = type_bits[site->type].col_type;
+  loc->x = site->type_coord.x;
+  loc->top = top;
+  /* When top is one, the row numbering is inverted */
+  loc->row = top ? (ymid - 1 - row) : row - ymid;
+  /* Middle word contains SECDED and clk information, so we skip it sometimes */
+  loc->frame_y = row_local * STDWIDTH + row_second_half(row_local);
+}
+
 /** \brief Get one config byte from a site
  *
  * @param bitstream the bitstream data
@@ -148,70 +240,79 @@ static guchar
 query_bitstream_site_byte(const bitstream_parsed_t *bitstream,
 			  const csite_descr_t *site,
 			  const int cfgbyte) {
-  const chip_struct_t *chip_struct = bitstream->chip_struct;
-  const site_type_t lsite_type = site->type;
-  const unsigned x = site->type_coord.x;
-  const unsigned y = site->type_coord.y;
-  const unsigned ymid = chip_struct->row_count;
-  /* Rows are packed by groups of 16 */
-  unsigned row = (y >> 4);
-  /* a bittest should be sufficient for top, but is hard to compute
-     (depends on bitlength of the value, which is costly to compute) */
-  const unsigned top = (row >= ymid) ? 0 : 1;
-  const unsigned row_local = y & 0xF;
-  /* We must skip 4 bytes of SECDED and CLK information in the middle of
-   * the frame */
-  const unsigned row_second_half = (y >> 1) & 0x4;
-  const guint frame_x = byte_x(cfgbyte);
-  /* Middle word contains SECDED and clk information, so we skip it sometimes */
-  guint frame_y = row_local * STDWIDTH + row_second_half + byte_y(cfgbyte);
+  site_loc_t loc;
   const gchar *frame;
-  unsigned char byte;
 
-  /* When top is one, the row numbering is inverted, and bits are mirrored */
-  row = top ? (ymid - 1 - row) : row - ymid;
-  frame = get_frame(bitstream, type_bits[lsite_type].col_type, row, top, x, frame_x);
-  frame_y = top ? (164 - 1 - frame_y) : frame_y;
-
-  /* The adressing here is a bit strange, due to the frame byte order */
-  byte = frame[frame_y ^ 0x3];
-  return top ? byte : mirror_byte(byte);
+  locate_site(&loc, bitstream, site);
+  frame = get_frame(bitstream, loc.col_type, loc.row, loc.top, loc.x, byte_x(cfgbyte));
+  return frame_byte(frame, loc.frame_y + byte_y(cfgbyte), loc.top);
 }
 
-#elif defined(VIRTEX5)
+void
+query_bitstream_site_gather(const bitstream_parsed_t *bitstream,
+			    const csite_descr_t *site,
+			    const gather_plan_t *plan,
+			    guchar *bytes) {
+  const gchar *frame = NULL;
+  guint frame_x = G_MAXUINT;
+  site_loc_t loc;
+  unsigned i;
+
+  locate_site(&loc, bitstream, site);
+
+  for (i = 0; i < plan->nbytes; i++) {
+    const guint cfgbyte = plan->cfgbytes[i];
+
+    /* The bytes are sorted, so that the frame only changes once in a
+       while */
+    if (byte_x(cfgbyte) != frame_x) {
+      frame_x = byte_x(cfgbyte);
+      frame = get_frame(bitstream, loc.col_type, loc.row, loc.top, loc.x, frame_x);
+    }
+
+    bytes[i] = frame_byte(frame, loc.frame_y + byte_y(cfgbyte), loc.top);
+  }
+}
 
-static guchar
-query_bitstream_site_byte(const bitstream_parsed_t *bitstream,
-			  const csite_descr_t *site,
-			  const int cfgbyte) {
+guint
+query_bitstream_site_frames(const bitstream_parsed_t *bitstream,
+			    const csite_descr_t *site,
+			    gsize *first) {
   const chip_struct_t *chip_struct = bitstream->chip_struct;
-  const site_type_t lsite_type = site->type;
-  const unsigned x = site->type_coord.x;
-  const unsigned y = site->type_coord.y;
-  const unsigned ymid = chip_struct->row_count;
-  /* Rows are packed by groups of 20 */
-  unsigned row = (y / 20);
-  /* a bittest should be sufficient for top, but is hard to compute
-     (depends on bitlength of the value, which is costly to compute) */
-  const unsigned top = (row >= ymid) ? 0 : 1;
-  const unsigned row_local = y % 20;
-  const unsigned row_second_half = (row_local >= 10) ? 4 : 0;
+  site_loc_t loc;
 
-  const guint frame_x = byte_x(cfgbyte);
-  /* Middle word contains SECDED and clk information, so we skip it sometimes */
-  guint frame_y = row_local * STDWIDTH + row_second_half + byte_y(cfgbyte);
-  const gchar *frame;
+  locate_site(&loc, bitstream, site);
+  *first = get_frame_loc(bitstream, loc.col_type, loc.row, loc.top, loc.x, 0)
+    - bitstream->frames[0];
+  return type_frame_count(chip_struct, loc.col_type);
+}
 
-  /* When top is one, the row numbering is inverted */
-  row = top ? (ymid - 1 - row) : row - ymid;
-  frame = get_frame(bitstream, type_bits[lsite_type].col_type, row, top, x, frame_x);
+gint
+query_bitstream_site_cfgbit(const bitstream_parsed_t *bitstream,
+			    const csite_descr_t *site,
+			    const guint frame_x, const guint bit) {
+  /* bits are numbered from the MSB of the first byte of the frame */
+  const unsigned byte = bit >> 3, raw = 7 - (bit & 7);
+  unsigned frame_y, offset;
+  site_loc_t loc;
 
-  /* The adressing here is a bit strange, due to the frame byte order */
-  return frame[frame_y ^ 0x3];
-}
+  locate_site(&loc, bitstream, site);
 
+  /* Invert frame_byte_index and frame_bit_mask */
+#if defined(VIRTEX4)
+  frame_y = loc.top ? (164 - 1 - (byte ^ 0x3)) : (byte ^ 0x3);
+  offset = loc.top ? raw : 7 - raw;
+#else
+  frame_y = byte ^ 0x3;
+  offset = raw;
 #endif
 
+  if (frame_y < loc.frame_y || frame_y >= loc.frame_y + STDWIDTH)
+    return -1;
+
+  return assemble_cfgbit(frame_x, ((frame_y - loc.frame_y) << 3) | offset);
+}
+
 /** \brief Get some (up to 4) config bytes from a site
  *
  * @param bitstream the bitstream data
@@ -342,15 +443,30 @@ set_bitstream_lut(const bitstream_parsed_t *bitstream,
   (void) lut_i;
 }
 
+/* Bitstream bit setting function, the converse of
+   query_bitstream_site_bits. The frames must be writable, as those of
+   a bitstream allocated with alloc_wbitstream are. */
 void set_bitstream_site_bits(const bitstream_parsed_t * bitstream,
 			     const csite_descr_t *site,
 			     const uint32_t vals,
 			     const guint cfgbits[], const gsize nbits) {
-  (void) bitstream;
-  (void) site;
-  (void) vals;
-  (void) cfgbits;
-  (void) nbits;
+  site_loc_t loc;
+  gsize i;
+
+  locate_site(&loc, bitstream, site);
+
+  for (i = 0; i < nbits; i++) {
+    const guint cfgbit = cfgbits[i];
+    gchar *frame = (gchar *) get_frame(bitstream, loc.col_type, loc.row,
+				       loc.top, loc.x, byte_x(cfgbit));
+    const unsigned idx = frame_byte_index(loc.frame_y + byte_y(cfgbit), loc.top);
+    const guchar mask = frame_bit_mask(bit_offset(cfgbit), loc.top);
+
+    if ((vals >> i) & 1)
+      frame[idx] |= mask;
+    else
+      frame[idx] &= ~mask;
+  }
 }
 
 typedef int property_t;
@@ -440,7 +556,6 @@ query_bitstream_site_data(gchar *data, const gsize nbytes,
 
   for (i = 0; i < nbytes; i++) {
     unsigned pos = bitpos_to_cfgbit(i << 3, width);
-    g_print("From site, getting pos %i ", pos);
     data[i] = query_bitstream_site_byte(parsed, site, pos);
   }
 
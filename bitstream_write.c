@@ -32,71 +32,109 @@
 /* For config.h */
 #include "bitarray.h"
 
-#undef HAVE_MMAP
-
-#ifdef HAVE_MMAP
-#include <sys/mman.h>
-#endif /* HAVE_MMAP */
-
 /* Dirty hack for w32 support */
 #ifndef O_NDELAY
 #define O_NDELAY 0
 #endif /* O_NDELAY */
 
-#include <unistd.h>
-
 #include "bitstream_parser.h"
 #include "bitheader.h"
 #include "bitstream_packets.h"
 #include "design.h"
 #include "bitstream_write.h"
 
+/* Size of the output buffer. Packets and frames are assembled there,
+   and reach the file in writes of this size. */
+#define WRITER_BUFSIZE (1 << 20)
+
 /* State necessary for bitstream computation */
 typedef struct _bitstream_writer {
   int fd;
+  /* output buffer */
+  gchar *buf;
+  gsize len;
+  /* number of bytes emitted */
+  gsize total;
+  /* When sizing, nothing is output and no CRC is computed; the
+     length of the output is only accounted for in total */
+  gboolean sizing;
+  int err;
   uint32_t crc;
   const bitstream_parsed_t *bit;
+  /* one frame of zeros, for the padding */
+  gchar *zeros;
+  gsize zeros_len;
 } bitstream_writer_t;
 
-static inline void write_s(int fd, const void *buf, size_t count) {
+static void
+write_fd(bitstream_writer_t *writer, const void *buf, size_t count) {
   const char *dat = buf;
-  do {
-    ssize_t written = write(fd, dat, count);
+
+  if (writer->err)
+    return;
+
+  while (count != 0) {
+    ssize_t written = write(writer->fd, dat, count);
     if (written < 0) {
       perror("writing buffer");
+      writer->err = -1;
       return;
     }
     count -= written;
     dat += written;
-  } while (count != 0);
+  }
+}
+
+static void
+flush_writer(bitstream_writer_t *writer) {
+  write_fd(writer, writer->buf, writer->len);
+  writer->len = 0;
 }
 
-static inline void write_u8(int fd, const uint8_t dat) {
-  write_s(fd, &dat, sizeof(dat));
+static inline void write_s(bitstream_writer_t *writer, const void *buf, size_t count) {
+  writer->total += count;
+  if (writer->sizing)
+    return;
+
+  if (G_UNLIKELY(writer->len + count > WRITER_BUFSIZE)) {
+    flush_writer(writer);
+    /* do not bother copying large chunks */
+    if (count >= WRITER_BUFSIZE) {
+      write_fd(writer, buf, count);
+      return;
+    }
+  }
+
+  memcpy(writer->buf + writer->len, buf, count);
+  writer->len += count;
 }
 
-static inline void write_u16(int fd, const uint16_t dat) {
+static inline void write_u8(bitstream_writer_t *writer, const uint8_t dat) {
+  write_s(writer, &dat, sizeof(dat));
+}
+
+static inline void write_u16(bitstream_writer_t *writer, const uint16_t dat) {
   const uint16_t wdat = GUINT16_TO_BE(dat);
-  write_s(fd, &wdat, sizeof(wdat));
+  write_s(writer, &wdat, sizeof(wdat));
 }
 
-static inline void write_u32(int fd, const uint32_t dat) {
+static inline void write_u32(bitstream_writer_t *writer, const uint32_t dat) {
   const uint32_t wdat = GUINT32_TO_BE(dat);
-  write_s(fd, &wdat, sizeof(wdat));
+  write_s(writer, &wdat, sizeof(wdat));
 }
 
 /* Write data buffer with host to bitstream conversion of words */
 static inline void
-write_words(int fd, const uint32_t *buf, const size_t wordc) {
+write_words(bitstream_writer_t *writer, const uint32_t *buf, const size_t wordc) {
   size_t i;
   for (i = 0; i < wordc; i++)
-    write_u32(fd, buf[i]);
+    write_u32(writer, buf[i]);
 }
 
 /* Write data buffer without host to bitstream conversion of words */
 static inline void
-write_buf(int fd, const void *buf, const size_t len) {
-  write_s(fd, buf, len);
+write_buf(bitstream_writer_t *writer, const void *buf, const size_t len) {
+  write_s(writer, buf, len);
 }
 
 /*
@@ -105,28 +143,28 @@ write_buf(int fd, const void *buf, const size_t len) {
  */
 
 static void
-bs_write_option(const int fd, const uint8_t code,
+bs_write_option(bitstream_writer_t *writer, const uint8_t code,
 		const void *payload, const uint16_t length) {
-  write_u8(fd,code);
-  write_u16(fd,length);
-  write_s(fd, payload, length);
+  write_u8(writer,code);
+  write_u16(writer,length);
+  write_s(writer, payload, length);
 }
 
+/* The payload of the long option, the bitstream body, follows */
 static void
-bs_write_long_option(const int fd, const uint8_t code,
-		     const void *payload, const uint32_t length) {
-  write_u8(fd,code);
-  write_u32(fd,length);
-  write_s(fd, payload, length);
+bs_write_long_option(bitstream_writer_t *writer, const uint8_t code,
+		     const uint32_t length) {
+  write_u8(writer,code);
+  write_u32(writer,length);
 }
 
 static void
-bs_write_header(const int fd, const bitstream_parsed_t *bit) {
+bs_write_header(bitstream_writer_t *writer, const bitstream_parsed_t *bit) {
   const parsed_header_t *header = &bit->header;
 
 #define REWRITE(opt)   do {				\
   const header_option_p *hopt = get_option(header,opt); \
-  bs_write_option(fd, opt,				\
+  bs_write_option(writer, opt,				\
 		  hopt->data, hopt->len); }		\
   while(0)
 
@@ -138,68 +176,14 @@ bs_write_header(const int fd, const bitstream_parsed_t *bit) {
 }
 
 static void
-bs_write_magic(const int fd) {
-  write_u16(fd, 9);
-  write_u16(fd, 0x0ff0);
-  write_u16(fd, 0x0ff0);
-  write_u16(fd, 0x0ff0);
-  write_u16(fd, 0x0ff0);
-  write_u16(fd, 0x0);
-  write_u8(fd,  0x1);
-}
-
-#ifdef HAVE_MMAP
-static void
-bs_write_data(int fd, int fd_data, const char *tmp) {
-  struct stat statistics;
-  void *data_buf;
-  off_t size;
-  (void) tmp;
-
-  fstat(fd_data, &statistics);
-  size = statistics.st_size;
-
-  data_buf = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd_data, 0);
-  if (!data_buf) {
-    fprintf(stderr, "MMAP FAILED");
-    return;
-  }
-  bs_write_long_option(fd, CODE, data_buf, size);
-  munmap(data_buf, size);
-}
-#else /* HAVE_MMAP */
-/* Non-mmap suboptimal implementation, which goes through the file
-   path -- which must not have been unlinked. */
-static void
-bs_write_data(int fd, int fd_data, const char *tmp) {
-  GError *error = NULL;
-  GMappedFile *file = NULL;
-  (void) fd_data;
-
-  file = g_mapped_file_new(tmp, FALSE, &error);
-  if (error != NULL) {
-    g_warning("could not map file %s: %s", tmp, error->message);
-    g_error_free (error);
-    return;
-  }
-
-  bs_write_long_option(fd, CODE,
-		       g_mapped_file_get_contents (file),
-		       g_mapped_file_get_length (file));
-
-  g_mapped_file_free(file);
-}
-#endif /* HAVE_MMAP */
-
-/* Only depends on ? */
-/* A bit complicated, as this must be computed after the file output */
-static void
-bs_add_header(const bitstream_writer_t *writer,
-	      int fd, int data, const char *tmp) {
-  (void) writer;
-  bs_write_magic(fd);
-  bs_write_header(fd, writer->bit);
-  bs_write_data(fd, data, tmp);
+bs_write_magic(bitstream_writer_t *writer) {
+  write_u16(writer, 9);
+  write_u16(writer, 0x0ff0);
+  write_u16(writer, 0x0ff0);
+  write_u16(writer, 0x0ff0);
+  write_u16(writer, 0x0ff0);
+  write_u16(writer, 0x0);
+  write_u8(writer,  0x1);
 }
 
 /* packet writing functions */
@@ -406,11 +390,13 @@ setfiel(const uint32_t val,
 #include "codes/crc-ibm.h"
 #define crc_byte crc_ibm_byte
 #define crc_addr5 crc_ibm_addr5
+#define crc_words crc_ibm_words
 #else
 #if defined (VIRTEX4) || defined (VIRTEX5)
 #include "codes/crc32-c.h"
 #define crc_byte crc32c_byte
 #define crc_addr5 crc32c_addr5
+#define crc_words crc32c_words
 #endif
 #endif
 
@@ -422,6 +408,9 @@ update_crc_h(bitstream_writer_t *writer, const register_index_t reg,
   guint32 bcc = writer->crc;
   size_t i;
 
+  if (writer->sizing)
+    return;
+
   for (i = 0; i < wordc; i++) {
     uint32_t val = dat[i];
     bcc = crc_byte(bcc, val);
@@ -447,23 +436,19 @@ update_crc_w(bitstream_writer_t *writer,
   update_crc_h(writer, reg, &word, 1);
 }
 
-/* crc update function from bitstream-ordered data */
+/* crc update function from bitstream-ordered data, shared with the
+   parser, which goes through several words per step */
 static inline void
 update_crc_b(bitstream_writer_t *bit,
 	     const register_index_t reg,
 	     const char *val, const size_t len) {
   guint32 bcc = bit->crc;
-  size_t i;
   assert(len % 4 == 0);
 
-  for (i = 0; i < len; i+=4) {
-    bcc = crc_byte(bcc, val[i+3]);
-    bcc = crc_byte(bcc, val[i+2]);
-    bcc = crc_byte(bcc, val[i+1]);
-    bcc = crc_byte(bcc, val[i+0]);
-    /* the 5 bits of register address */
-    bcc = crc_addr5(bcc, reg);
-  }
+  if (bit->sizing)
+    return;
+
+  bcc = crc_words(bcc, (const uint8_t *) val, len / sizeof(uint32_t), reg);
 
   /* write back the new CRC register */
   bit->crc = bcc;
@@ -477,49 +462,49 @@ update_crc_b(bitstream_writer_t *bit,
 /* Low-level packet write functions */
 
 static inline void
-write_pkt1(const int fd, const unsigned wordc, const unsigned rega, const io_type_t io) {
+write_pkt1(bitstream_writer_t *writer, const unsigned wordc, const unsigned rega, const io_type_t io) {
   const uint32_t pkt1 = build_pkt1(wordc, rega, (io == PKT_READ), (io == PKT_WRITE));
-  write_u32(fd, pkt1);
+  write_u32(writer, pkt1);
 }
 
 static inline void
-write_pkt2(const int fd, const unsigned wordc, const io_type_t io) {
+write_pkt2(bitstream_writer_t *writer, const unsigned wordc, const io_type_t io) {
   const uint32_t pkt2 = build_pkt2(wordc, (io == PKT_READ), (io == PKT_WRITE));
-  write_u32(fd, pkt2);
+  write_u32(writer, pkt2);
 }
 
 static inline void
-bs_write_noop(const int fd) {
-  write_u32(fd, NOOP);
+bs_write_noop(bitstream_writer_t *writer) {
+  write_u32(writer, NOOP);
 }
 
 static inline void
-bs_write_synchro(int fd) {
+bs_write_synchro(bitstream_writer_t *writer) {
 #if defined(VIRTEX5)
-  write_u32(fd, (unsigned)-1);
-  write_u32(fd, SYNCHRO_0);
-  write_u32(fd, SYNCHRO_1);
-  write_u32(fd, (unsigned)-1);
-  write_u32(fd, (unsigned)-1);
-  write_u32(fd, SYNCHRO);
+  write_u32(writer, (unsigned)-1);
+  write_u32(writer, SYNCHRO_0);
+  write_u32(writer, SYNCHRO_1);
+  write_u32(writer, (unsigned)-1);
+  write_u32(writer, (unsigned)-1);
+  write_u32(writer, SYNCHRO);
 #else
-  write_u32(fd, (unsigned)-1);
-  write_u32(fd, SYNCHRO);
+  write_u32(writer, (unsigned)-1);
+  write_u32(writer, SYNCHRO);
 #endif /* VIRTEX5 */
 }
 
 /* High-level register operation functions */
 static void
-bs_write_wreg(const int fd, const cmd_pkt_ver_t type, const unsigned rega, const unsigned wordc) {
+bs_write_wreg(bitstream_writer_t *writer, const cmd_pkt_ver_t type, const unsigned rega, const unsigned wordc) {
   switch(type) {
   case TYPE_V1:
-    write_pkt1(fd, wordc, rega, PKT_WRITE);
+    write_pkt1(writer, wordc, rega, PKT_WRITE);
     break;
   case TYPE_V2:
-    write_pkt1(fd, 0, rega, PKT_WRITE);
+    write_pkt1(writer, 0, rega, PKT_WRITE);
     /* XXX hotfix for pkt2 generation: invert read and write.
        See in ug002 where the correct fix should happen */
-    write_pkt2(fd, wordc, PKT_READ);
+    write_pkt2(writer, wordc, PKT_READ);
     break;
   }
   /* Register rega for future CRC updates */
@@ -527,31 +512,32 @@ bs_write_wreg(const int fd, const cmd_pkt_ver_t type, const unsigned rega, const
 
 static void
 bs_write_wreg_data(bitstream_writer_t *writer,
-		   const int fd, const unsigned rega, const unsigned wordc, const uint32_t *data) {
+		   const unsigned rega, const unsigned wordc, const uint32_t *data) {
   /* Actually we could decide here on what type of write we'd need.
    * For now simply do an heuristic of what Xlx does.
    */
   const cmd_pkt_ver_t type = ((wordc >> V1_PKT_WORDC_LEN) == 0) ? TYPE_V1 : TYPE_V2;
-  bs_write_wreg(fd, type, rega, wordc);
+  bs_write_wreg(writer, type, rega, wordc);
   /* Actually write the data, with host-to-bitstream reordering */
-  write_words(fd, data, wordc);
+  write_words(writer, data, wordc);
   /* Update the running CRC */
   update_crc_h(writer, rega, data, wordc);
 }
 
 static void
 bs_write_wreg_u32(bitstream_writer_t *writer,
-		  const int fd, const unsigned rega, const uint32_t word) {
-  bs_write_wreg_data(writer, fd, rega, 1, &word);
+		  const unsigned rega, const uint32_t word) {
+  bs_write_wreg_data(writer, rega, 1, &word);
 }
 
 static inline void
 bs_write_padding(bitstream_writer_t *writer, const unsigned rega, const unsigned count) {
-  const int fd = writer->fd;
-  unsigned i;
-  for (i = 0; i < count; i++) {
-    write_u32(fd, 0);
-    update_crc_w(writer, rega, 0);
+  gsize len = count * sizeof(uint32_t);
+  while (len) {
+    const gsize chunk = MIN(len, writer->zeros_len);
+    write_buf(writer, writer->zeros, chunk);
+    update_crc_b(writer, rega, writer->zeros, chunk);
+    len -= chunk;
   }
 }
 
@@ -568,7 +554,9 @@ write_frame(const char *frame, guint type, guint idx, guint frameidx, void *data
     return;
   }
 
-  write_buf(writer->fd, frame, frame_len);
+  /* The CRC goes through the frame right after its copy, while it is
+     still in cache */
+  write_buf(writer, frame, frame_len);
   update_crc_b(writer, FDRI, frame, frame_len);
 }
 
@@ -590,9 +578,20 @@ static inline unsigned nframes(const chip_struct_t *chip_struct) {
 
 #define S2U(x) GUINT32_FROM_BE(*((uint32_t *)x))
 
+#define CMD_LFRM DGHIGH_LFRM
+#define CMD_MFW C_MFWR
+
+/* V2 expects an AutoCRC word after each FDRI write */
+static void
+bs_write_autocrc(bitstream_writer_t *writer) {
+  debit_log(L_WRITE,"ACRC is %04x", writer->crc);
+  write_u32(writer, writer->crc);
+  update_crc_w(writer, CRC, writer->crc);
+  /* This yields zero in CRC register */
+}
+
 static void
 bs_fdri_write_frames(bitstream_writer_t *writer) {
-  int fd = writer->fd;
   const bitstream_parsed_t *bit = writer->bit;
   const chip_struct_t *chip = bit->chip_struct;
   /* Compute total word count */
@@ -601,11 +600,11 @@ bs_fdri_write_frames(bitstream_writer_t *writer) {
 
   /* prepare for FRDI write */
   /* FAR initialization. For non-compressed bitstream, it is set to be zero */
-  bs_write_wreg_u32(writer, fd, FAR, 0);
-  bs_write_wreg_u32(writer, fd, CMD, WCFG);
+  bs_write_wreg_u32(writer, FAR, 0);
+  bs_write_wreg_u32(writer, CMD, WCFG);
 
   /* Prepare long FDRI write */
-  bs_write_wreg(fd, TYPE_V2, FDRI, wordc);
+  bs_write_wreg(writer, TYPE_V2, FDRI, wordc);
 
   /* simply write *all* frames, in FAR order */
   iterate_over_frames_far(bit, write_frame, writer);
@@ -614,25 +613,20 @@ bs_fdri_write_frames(bitstream_writer_t *writer) {
   bs_write_padding(writer, FDRI, chip->framelen);
 
   /* write AutoCRC word and update CRC accordingly */
-
-  debit_log(L_WRITE,"ACRC is %04x", writer->crc);
-  write_u32(fd, writer->crc);
-  update_crc_w(writer, CRC, writer->crc);
-  /* This yields zero in CRC register */
+  bs_write_autocrc(writer);
 }
 
 static void
 bs_write_cmd_header(bitstream_writer_t *writer) {
-  int fd = writer->fd;
   const bitstream_parsed_t *bit = writer->bit;
   const chip_struct_t *chip = bit->chip_struct;
   uint32_t cor_val;
 
-  bs_write_wreg_u32(writer, fd, CMD, RCRC);
+  bs_write_wreg_u32(writer, CMD, RCRC);
   /* reset the CRC appropriately */
   writer->crc = 0;
 
-  bs_write_wreg_u32(writer, fd, FLR, chip->framelen-1);
+  bs_write_wreg_u32(writer, FLR, chip->framelen-1);
   /* These values are meaningless for me now */
   cor_val = COR_F(GWE_CYCLE, 5) | COR_F(GTS_CYCLE, 4) |
 	  COR_F(LOCK_CYCLE, 7) | COR_F(MATCH_CYCLE, 7) |
@@ -643,48 +637,55 @@ bs_write_cmd_header(bitstream_writer_t *writer) {
   /* spartan 3, see UG */
   cor_val |= 0x40000000;
 #endif
-  bs_write_wreg_u32(writer, fd, COR, cor_val);
+  bs_write_wreg_u32(writer, COR, cor_val);
 
-  bs_write_wreg_u32(writer, fd, IDCODE, chip->idcode);
-  bs_write_wreg_u32(writer, fd, MASK, 0);
-  bs_write_wreg_u32(writer, fd, CMD, SWITCH);
+  bs_write_wreg_u32(writer, IDCODE, chip->idcode);
+  bs_write_wreg_u32(writer, MASK, 0);
+  bs_write_wreg_u32(writer, CMD, SWITCH);
 
   /* Start-of-write */
 }
 
 static void
 bs_write_cmd_footer(bitstream_writer_t *writer) {
-  int fd = writer->fd;
   const bitstream_parsed_t *bit = writer->bit;
   const chip_struct_t *chip = bit->chip_struct;
   unsigned i;
   (void) chip;
   /* All frames have been written */
-  bs_write_wreg_u32(writer, fd, CMD, GRESTORE);
-  bs_write_wreg_u32(writer, fd, CMD, DGHIGH_LFRM);
+  bs_write_wreg_u32(writer, CMD, GRESTORE);
+  bs_write_wreg_u32(writer, CMD, DGHIGH_LFRM);
 
   /* Series of noop packets, waiting for flush of the last written
      frame */
   for (i = 0; i < chip->framelen; i++)
-    bs_write_noop(fd);
+    bs_write_noop(writer);
 
-  bs_write_wreg_u32(writer, fd, CMD, START);
-  bs_write_wreg_u32(writer, fd, CTL, 0);
+  bs_write_wreg_u32(writer, CMD, START);
+  bs_write_wreg_u32(writer, CTL, 0);
 
   /* CRC check. We should fuck this up big time intentionally. We don't
      want anyone to load our bitstreams for now... */
   debit_log(L_WRITE,"CRC is %04x", writer->crc);
-  bs_write_wreg_u32(writer, fd, CRC, writer->crc);
+  bs_write_wreg_u32(writer, CRC, writer->crc);
 
-  bs_write_wreg_u32(writer, fd, CMD, DESYNCH);
+  bs_write_wreg_u32(writer, CMD, DESYNCH);
   for (i = 0; i < 4; i++)
-    bs_write_noop(fd);
+    bs_write_noop(writer);
 }
 
 #elif defined(VIRTEX4)
 
 #include "design_v4.h"
 
+#define CMD_LFRM C_LFRM
+#define CMD_MFW C_MFWR
+
+static inline void
+bs_write_autocrc(bitstream_writer_t *writer) {
+  (void) writer;
+}
+
 static inline unsigned nframes(const chip_struct_t *chip) {
   const unsigned *frame_count = chip->frame_count;
   const unsigned *col_count = chip->col_count;
@@ -697,51 +698,49 @@ static inline unsigned nframes(const chip_struct_t *chip) {
 
 static void
 bs_write_cmd_header(bitstream_writer_t *writer) {
-  int fd = writer->fd;
   const bitstream_parsed_t *bit = writer->bit;
   const chip_struct_t *chip = bit->chip_struct;
   int nop;
 
   /* V4 inserts noops */
-  bs_write_noop(fd);
+  bs_write_noop(writer);
 
-  bs_write_wreg_u32(writer, fd, CMD, RCRC);
+  bs_write_wreg_u32(writer, CMD, RCRC);
   /* reset the CRC appropriately */
   writer->crc = 0;
 
-  bs_write_noop(fd);
-  bs_write_noop(fd);
+  bs_write_noop(writer);
+  bs_write_noop(writer);
 
   /* These values are meaningless for me now */
-  bs_write_wreg_u32(writer, fd, COR,
+  bs_write_wreg_u32(writer, COR,
 		    COR_F(GWE_CYCLE, 5) | COR_F(GTS_CYCLE, 4) |
 		    COR_F(LOCK_CYCLE, 7) | COR_F(MATCH_CYCLE, 0) |
 		    COR_F(DONE_CYCLE, 3) | COR_F(OSCFSEL, 2));
-  bs_write_wreg_u32(writer, fd, IDCODE, chip->idcode);
-  bs_write_wreg_u32(writer, fd, CMD, SWITCH);
-  bs_write_noop(fd);
+  bs_write_wreg_u32(writer, IDCODE, chip->idcode);
+  bs_write_wreg_u32(writer, CMD, SWITCH);
+  bs_write_noop(writer);
 
   /* Set unknown bits */
-  bs_write_wreg_u32(writer, fd, MASK, CTL_F(RSV2, 0x3));
-  bs_write_wreg_u32(writer, fd, CTL, CTL_F(RSV2, 0x3));
+  bs_write_wreg_u32(writer, MASK, CTL_F(RSV2, 0x3));
+  bs_write_wreg_u32(writer, CTL, CTL_F(RSV2, 0x3));
 
 #define NOOPS_SYNC 1150
   for(nop = 0; nop < NOOPS_SYNC; nop++)
-    bs_write_noop(fd);
+    bs_write_noop(writer);
 
   /* Clear those same bits */
-  bs_write_wreg_u32(writer, fd, MASK, CTL_F(RSV2, 0x3));
-  bs_write_wreg_u32(writer, fd, CTL, 0);
+  bs_write_wreg_u32(writer, MASK, CTL_F(RSV2, 0x3));
+  bs_write_wreg_u32(writer, CTL, 0);
 
-  bs_write_wreg_u32(writer, fd, CMD, C_NULL);
-  bs_write_noop(fd);
+  bs_write_wreg_u32(writer, CMD, C_NULL);
+  bs_write_noop(writer);
 
   /* Start-of-write */
 }
 
 static void
 bs_fdri_write_frames(bitstream_writer_t *writer) {
-  int fd = writer->fd;
   const bitstream_parsed_t *bit = writer->bit;
   const chip_struct_t *chip = bit->chip_struct;
   /* Compute total word count */
@@ -750,69 +749,76 @@ bs_fdri_write_frames(bitstream_writer_t *writer) {
 
   /* prepare for FRDI write */
   /* FAR initialization. For non-compressed bitstream, it is set to be zero */
-  bs_write_wreg_u32(writer, fd, FAR, 0);
-  bs_write_wreg_u32(writer, fd, CMD, WCFG);
-  bs_write_noop(fd);
+  bs_write_wreg_u32(writer, FAR, 0);
+  bs_write_wreg_u32(writer, CMD, WCFG);
+  bs_write_noop(writer);
 
   /* Prepare long FDRI write */
-  bs_write_wreg(fd, TYPE_V2, FDRI, wordc);
+  bs_write_wreg(writer, TYPE_V2, FDRI, wordc);
 
   /* simply write *all* frames, in FAR order. Along with noop padding */
   iterate_over_frames_far(bit, write_frame, writer);
 
   /* explicit CRC check for v4 */
-  bs_write_wreg_u32(writer, fd, CRC, writer->crc);
+  bs_write_wreg_u32(writer, CRC, writer->crc);
 }
 
 static void
 bs_write_cmd_footer(bitstream_writer_t *writer) {
-  int fd = writer->fd;
   const bitstream_parsed_t *bit = writer->bit;
   const chip_struct_t *chip = bit->chip_struct;
   unsigned final_far, i;
   (void) chip;
   /* All frames have been written */
 
-  bs_write_wreg_u32(writer, fd, CMD, GRESTORE);
-  bs_write_noop(fd);
+  bs_write_wreg_u32(writer, CMD, GRESTORE);
+  bs_write_noop(writer);
 
-  bs_write_wreg_u32(writer, fd, CMD, C_LFRM);
-  bs_write_noop(fd);
+  bs_write_wreg_u32(writer, CMD, C_LFRM);
+  bs_write_noop(writer);
 
   /* Series of noop packets, waiting for flush */
   for (i = 0; i < 99; i++)
-    bs_write_noop(fd);
+    bs_write_noop(writer);
 
-  bs_write_wreg_u32(writer, fd, CMD, GRESTORE);
-  bs_write_noop(fd);
+  bs_write_wreg_u32(writer, CMD, GRESTORE);
+  bs_write_noop(writer);
 
-  bs_write_wreg_u32(writer, fd, CMD, C_NULL);
-  bs_write_noop(fd);
+  bs_write_wreg_u32(writer, CMD, C_NULL);
+  bs_write_noop(writer);
 
   final_far = (chip->col_count[V4_TYPE_CLB] << FAR_V4_COL_OFFSET) |
     (chip->row_count << FAR_V4_ROW_OFFSET);
-  bs_write_wreg_u32(writer, fd, FAR, final_far);
+  bs_write_wreg_u32(writer, FAR, final_far);
 
-  bs_write_wreg_u32(writer, fd, CMD, START);
-  bs_write_noop(fd);
+  bs_write_wreg_u32(writer, CMD, START);
+  bs_write_noop(writer);
 
-  bs_write_wreg_u32(writer, fd, MASK, 0);
-  bs_write_wreg_u32(writer, fd, CTL, 0);
+  bs_write_wreg_u32(writer, MASK, 0);
+  bs_write_wreg_u32(writer, CTL, 0);
 
   /* CRC check. We should fuck this up big time intentionally. We don't
      want anyone to load our bitstreams for now... */
   debit_log(L_WRITE,"CRC is %04x", writer->crc);
-  bs_write_wreg_u32(writer, fd, CRC, writer->crc);
+  bs_write_wreg_u32(writer, CRC, writer->crc);
 
-  bs_write_wreg_u32(writer, fd, CMD, DESYNCH);
+  bs_write_wreg_u32(writer, CMD, DESYNCH);
   for (i = 0; i < 16; i++)
-    bs_write_noop(fd);
+    bs_write_noop(writer);
 }
 
 #elif defined(VIRTEX5)
 
 #include "design_v5.h"
 
+#define CMD_LFRM DGHIGH_LFRM
+#define CMD_MFW MFW
+
+static inline void
+bs_write_autocrc(bitstream_writer_t *writer) {
+  (void) writer;
+}
+
 static inline unsigned nframes(const chip_struct_t *chip) {
   const unsigned *frame_count = chip->frame_count;
   const unsigned *col_count = chip->col_count;
@@ -825,54 +831,52 @@ static inline unsigned nframes(const chip_struct_t *chip) {
 
 static void
 bs_write_cmd_header(bitstream_writer_t *writer) {
-  int fd = writer->fd;
   const bitstream_parsed_t *bit = writer->bit;
   const chip_struct_t *chip = bit->chip_struct;
   int nop;
 
   /* V5 inserts noops too */
-  bs_write_noop(fd);
+  bs_write_noop(writer);
 
   /* V5-specific */
-  bs_write_wreg_u32(writer, fd, WBSTAR, 0);
-  bs_write_wreg_u32(writer, fd, CMD, CMD_NULL);
-  bs_write_noop(fd);
+  bs_write_wreg_u32(writer, WBSTAR, 0);
+  bs_write_wreg_u32(writer, CMD, CMD_NULL);
+  bs_write_noop(writer);
 
-  bs_write_wreg_u32(writer, fd, CMD, RCRC);
+  bs_write_wreg_u32(writer, CMD, RCRC);
   /* reset the CRC appropriately */
   writer->crc = 0;
 
-  bs_write_noop(fd);
-  bs_write_noop(fd);
+  bs_write_noop(writer);
+  bs_write_noop(writer);
 
   /* V5-specific */
-  bs_write_wreg_u32(writer, fd, TIMER, 0);
-  bs_write_wreg_u32(writer, fd, REG19, 0);
+  bs_write_wreg_u32(writer, TIMER, 0);
+  bs_write_wreg_u32(writer, REG19, 0);
 
   /* These values are meaningless for me now */
-  bs_write_wreg_u32(writer, fd, COR0, 0x431e5);
-  bs_write_wreg_u32(writer, fd, COR1, 0);
+  bs_write_wreg_u32(writer, COR0, 0x431e5);
+  bs_write_wreg_u32(writer, COR1, 0);
 
-  bs_write_wreg_u32(writer, fd, IDCODE, chip->idcode);
-  bs_write_wreg_u32(writer, fd, CMD, SWITCH);
-  bs_write_noop(fd);
+  bs_write_wreg_u32(writer, IDCODE, chip->idcode);
+  bs_write_wreg_u32(writer, CMD, SWITCH);
+  bs_write_noop(writer);
 
   /* Set unknown bits */
-  bs_write_wreg_u32(writer, fd, MASK, 0x00400000);
-  bs_write_wreg_u32(writer, fd, CTL0, 0x00400000);
-  bs_write_wreg_u32(writer, fd, MASK, 0);
-  bs_write_wreg_u32(writer, fd, CTL1, 0);
+  bs_write_wreg_u32(writer, MASK, 0x00400000);
+  bs_write_wreg_u32(writer, CTL0, 0x00400000);
+  bs_write_wreg_u32(writer, MASK, 0);
+  bs_write_wreg_u32(writer, CTL1, 0);
 
 #define NOOPS_SYNC 8
   for(nop = 0; nop < NOOPS_SYNC; nop++)
-    bs_write_noop(fd);
+    bs_write_noop(writer);
 
   /* Start-of-write */
 }
 
 static void
 bs_fdri_write_frames(bitstream_writer_t *writer) {
-  int fd = writer->fd;
   const bitstream_parsed_t *bit = writer->bit;
   const chip_struct_t *chip = bit->chip_struct;
   /* Compute total word count */
@@ -881,138 +885,463 @@ bs_fdri_write_frames(bitstream_writer_t *writer) {
 
   /* prepare for FRDI write */
   /* FAR initialization. For non-compressed bitstream, it is set to be zero */
-  bs_write_wreg_u32(writer, fd, FAR, 0);
-  bs_write_wreg_u32(writer, fd, CMD, WCFG);
-  bs_write_noop(fd);
+  bs_write_wreg_u32(writer, FAR, 0);
+  bs_write_wreg_u32(writer, CMD, WCFG);
+  bs_write_noop(writer);
 
   /* Prepare long FDRI write */
-  bs_write_wreg(fd, TYPE_V2, FDRI, wordc);
+  bs_write_wreg(writer, TYPE_V2, FDRI, wordc);
 
   /* simply write *all* frames, in FAR order. Along with noop padding */
   iterate_over_frames_far(bit, write_frame, writer);
 
   /* explicit CRC check for v4 */
   /* and v5 */
-  bs_write_wreg_u32(writer, fd, CRC, writer->crc);
+  bs_write_wreg_u32(writer, CRC, writer->crc);
 }
 
 /* only slightly different from V4 */
 static void
 bs_write_cmd_footer(bitstream_writer_t *writer) {
-  int fd = writer->fd;
   const bitstream_parsed_t *bit = writer->bit;
   const chip_struct_t *chip = bit->chip_struct;
   unsigned final_far, i;
   (void) chip;
   /* All frames have been written */
 
-  bs_write_wreg_u32(writer, fd, CMD, GRESTORE);
-  bs_write_noop(fd);
+  bs_write_wreg_u32(writer, CMD, GRESTORE);
+  bs_write_noop(writer);
 
-  bs_write_wreg_u32(writer, fd, CMD, DGHIGH_LFRM);
-  bs_write_noop(fd);
+  bs_write_wreg_u32(writer, CMD, DGHIGH_LFRM);
+  bs_write_noop(writer);
 
   /* Series of noop packets, waiting for flush */
   for (i = 0; i < 99; i++)
-    bs_write_noop(fd);
+    bs_write_noop(writer);
 
-  bs_write_wreg_u32(writer, fd, CMD, START);
-  bs_write_noop(fd);
+  bs_write_wreg_u32(writer, CMD, START);
+  bs_write_noop(writer);
 
   final_far = FAR_V5_TYPE_MASK | FAR_V5_ROW_MASK;
-  bs_write_wreg_u32(writer, fd, FAR, final_far);
+  bs_write_wreg_u32(writer, FAR, final_far);
 
-  bs_write_wreg_u32(writer, fd, MASK, 0x400000);
-  bs_write_wreg_u32(writer, fd, CTL0, 0x400000);
+  bs_write_wreg_u32(writer, MASK, 0x400000);
+  bs_write_wreg_u32(writer, CTL0, 0x400000);
 
   /* CRC check. We should fuck this up big time intentionally. We don't
      want anyone to load our bitstreams for now... */
   debit_log(L_WRITE,"CRC is %04x", writer->crc);
-  bs_write_wreg_u32(writer, fd, CRC, writer->crc);
+  bs_write_wreg_u32(writer, CRC, writer->crc);
 
-  bs_write_wreg_u32(writer, fd, CMD, DESYNCH);
+  bs_write_wreg_u32(writer, CMD, DESYNCH);
   for (i = 0; i < 100; i++)
-    bs_write_noop(fd);
+    bs_write_noop(writer);
 }
 
 #endif
 
+typedef void (*body_writer_t)(bitstream_writer_t *writer, const void *data);
+
 static void
-bs_write_body(bitstream_writer_t *writer) {
+bs_write_body(bitstream_writer_t *writer, const void *data) {
+  (void) data;
   /* write all raw bitstream data to disk */
-  bs_write_synchro(writer->fd);
+  bs_write_synchro(writer);
   bs_write_cmd_header(writer);
   bs_fdri_write_frames(writer);
   bs_write_cmd_footer(writer);
 }
 
+/* The body is generated twice: once to size it, as its length is
+   needed in the header, which comes first, then for real. The sizing
+   pass does not touch the frame data, so that the frames are only read
+   once, and the file is written in one sequential pass. */
+static int
+write_bitstream_file(const bitstream_parsed_t *bit, const char *ofile,
+		     body_writer_t body, const void *data) {
+  const chip_struct_t *chip = bit->chip_struct;
+  bitstream_writer_t writer = { .bit = bit };
+  gsize body_len;
+  int err;
+
+  writer.zeros_len = chip->framelen * sizeof(uint32_t);
+  writer.zeros = g_malloc0(writer.zeros_len);
+
+  writer.sizing = TRUE;
+  body(&writer, data);
+  body_len = writer.total;
+  debit_log(L_WRITE,"Bitstream body is %" G_GSIZE_FORMAT " bytes", body_len);
+
+  writer.fd = g_open(ofile, O_CREAT | O_TRUNC | O_NDELAY | O_WRONLY, S_IRWXU);
+  if (writer.fd < 0) {
+    perror("Opening bitstream file");
+    g_free(writer.zeros);
+    return -1;
+  }
+
+  writer.buf = g_malloc(WRITER_BUFSIZE);
+  writer.sizing = FALSE;
+  writer.total = 0;
+  writer.crc = 0;
+
+  bs_write_magic(&writer);
+  bs_write_header(&writer, bit);
+  bs_write_long_option(&writer, CODE, body_len);
+  body(&writer, data);
+  flush_writer(&writer);
+
+  g_free(writer.buf);
+  g_free(writer.zeros);
+  err = writer.err;
+
+  if (close(writer.fd)) {
+    perror("Closing bitstream file");
+    err = -1;
+  }
+
+  return err;
+}
+
 int
 bitstream_write(const bitstream_parsed_t *bit,
 		const char *output_dir,
 		const char *ofile) {
-  int file, data, err = 0;
-  bitstream_writer_t writer = { .bit = bit };
-  gchar *tmpname = NULL;
   (void) output_dir;
+  return write_bitstream_file(bit, ofile, bs_write_body, NULL);
+}
 
-  /* open bitstream data file */
-  data = g_file_open_tmp(NULL,&tmpname,NULL);
-  if (data < 0)
-    return data;
-  debit_log(L_WRITE,"Temporary datafile is %s", tmpname);
-  writer.fd = data;
-
-  /* unlink the temp file from the filesystem early if we can directly
-     mmap from a fd instead of a filename */
-#ifdef HAVE_MMAP
-  (void) unlink(tmpname);
-  g_free(tmpname);
-  tmpname = NULL;
-#endif /* HAVE_MMAP */
-
-  bs_write_body(&writer);
-
-  /* open bitstream itself */
-  file = g_open(ofile, O_CREAT | O_TRUNC | O_NDELAY | O_WRONLY, S_IRWXU);
-  if (file < 0) {
-    err = file;
-    perror("Opening bitstream file");
-    goto err_data;
+/*
+ * Partial bitstreams. Only the frames which differ from those of a
+ * base bitstream are written. Runs of consecutive frames in FAR order
+ * are written with one FAR write and one FDRI write each, followed by
+ * a pad frame which flushes the last frame of the run. Frames whose
+ * contents repeat are written once, then copied to all their FARs with
+ * multi-frame writes.
+ */
+
+typedef enum _frame_diff {
+  FRAME_SAME = 0,
+  FRAME_RUN,
+  FRAME_MFW,
+} frame_diff_t;
+
+typedef struct _partial_plan {
+  /* both of frame_record_t, in FAR order */
+  GArray *base;
+  GArray *frames;
+  /* frame_diff_t of each frame */
+  guint8 *diff;
+  /* offsets of the frames written by multi-frame writes, grouped
+     by contents, and the size of each group */
+  GArray *mfw;
+  GArray *mfw_groups;
+  unsigned framelen;
+  /* stands for absent frames */
+  gchar *zeros;
+} partial_plan_t;
+
+/* Rough cost in words of the packets of a run, besides its frames:
+   FAR, CMD and FDRI writes, and the pad frame */
+#define RUN_OVERHEAD(framelen) (7 + (framelen))
+/* ... of a multi-frame write, besides its frame, then for each FAR:
+   FAR and MFWR writes */
+#define MFW_OVERHEAD 13
+#define MFW_FAR_OVERHEAD 4
+
+static void
+append_record(const frame_record_t *frame, void *data) {
+  GArray *array = data;
+  g_array_append_vals(array, frame, 1);
+}
+
+static GArray *
+get_frame_records(const bitstream_parsed_t *bit) {
+  GArray *array = g_array_sized_new(FALSE, FALSE, sizeof(frame_record_t),
+				    bitstream_frame_count(bit));
+  iterate_over_frame_records(bit, append_record, array);
+  return array;
+}
+
+static inline const gchar *
+plan_frame(const partial_plan_t *plan, const GArray *array, const guint i) {
+  const gchar *frame = g_array_index(array, frame_record_t, i).frame;
+  return frame ? frame : plan->zeros;
+}
+
+static gint
+compare_frames(gconstpointer a, gconstpointer b, gpointer data) {
+  const partial_plan_t *plan = data;
+  const guint ia = *(const guint *)a, ib = *(const guint *)b;
+  const gint cmp = memcmp(plan_frame(plan, plan->frames, ia),
+			  plan_frame(plan, plan->frames, ib),
+			  plan->framelen * sizeof(uint32_t));
+  if (cmp)
+    return cmp;
+  /* keep the groups in FAR order */
+  return ia < ib ? -1 : 1;
+}
+
+static inline gboolean
+is_run(const partial_plan_t *plan, const guint i) {
+  return i < plan->frames->len && plan->diff[i] == FRAME_RUN;
+}
+
+/* Move a group of identical frames out of the runs, if the multi-frame
+   write is cheaper than what it saves in the runs */
+static gboolean
+try_mfw_group(partial_plan_t *plan, const guint *group, const guint count) {
+  const long framelen = plan->framelen;
+  long runs = 0, cost;
+  guint i;
+
+  for (i = 0; i < count; i++) {
+    const guint off = group[i];
+    const gboolean left = off > 0 && is_run(plan, off - 1);
+    const gboolean right = is_run(plan, off + 1);
+    /* splitting a run makes one more, dropping a lone frame one less */
+    runs += (left && right) - (!left && !right);
+    plan->diff[off] = FRAME_MFW;
   }
 
-  /* Close the fd_data so that data will appear in mmap */
-#ifndef HAVE_MMAP
-  err = close(data);
-  data = -1;
-  if (err) {
-    perror("Closing tmp data file");
-    goto err_data;
+  cost = runs * RUN_OVERHEAD(framelen) - count * framelen +
+    MFW_OVERHEAD + framelen + count * MFW_FAR_OVERHEAD;
+
+  if (cost < 0)
+    return TRUE;
+
+  for (i = 0; i < count; i++)
+    plan->diff[group[i]] = FRAME_RUN;
+  return FALSE;
+}
+
+static void
+plan_mfw(partial_plan_t *plan, GArray *changed) {
+  const guint *offsets = (const guint *) changed->data;
+  const gsize frame_bytes = plan->framelen * sizeof(uint32_t);
+  guint start, end;
+
+  g_qsort_with_data(changed->data, changed->len, sizeof(guint),
+		    compare_frames, plan);
+
+  for (start = 0; start < changed->len; start = end) {
+    const gchar *frame = plan_frame(plan, plan->frames, offsets[start]);
+    const guint *group = &offsets[start];
+    guint count;
+
+    for (end = start + 1; end < changed->len; end++)
+      if (memcmp(frame, plan_frame(plan, plan->frames, offsets[end]),
+		 frame_bytes))
+	break;
+
+    count = end - start;
+    if (count < 2 || !try_mfw_group(plan, group, count))
+      continue;
+
+    g_array_append_vals(plan->mfw, group, count);
+    g_array_append_val(plan->mfw_groups, count);
   }
-#endif
+}
 
-  /* Prepend header to raw bitstream data */
-  bs_add_header(&writer, file, data, tmpname);
-  err = close(file);
-  if (err) {
-    perror("Closing bitstream file");
-    goto err_data;
+static void
+free_partial_plan(partial_plan_t *plan) {
+  if (plan->base)
+    g_array_free(plan->base, TRUE);
+  if (plan->frames)
+    g_array_free(plan->frames, TRUE);
+  if (plan->mfw)
+    g_array_free(plan->mfw, TRUE);
+  if (plan->mfw_groups)
+    g_array_free(plan->mfw_groups, TRUE);
+  g_free(plan->diff);
+  g_free(plan->zeros);
+}
+
+static int
+get_partial_plan(partial_plan_t *plan,
+		 const bitstream_parsed_t *base,
+		 const bitstream_parsed_t *bit) {
+  const chip_struct_t *chip = bit->chip_struct;
+  GArray *changed;
+  guint i, nframes;
+
+  memset(plan, 0, sizeof(*plan));
+
+  if (base->chip_struct != chip) {
+    g_warning("The bitstreams are not for the same device");
+    return -1;
   }
 
- err_data:
-#ifdef HAVE_MMAP
-  err = close(data);
-  data = -1;
-  if (err) {
-    perror("Closing bitstream file");
-    goto err_data;
+  plan->framelen = chip->framelen;
+  plan->zeros = g_malloc0(plan->framelen * sizeof(uint32_t));
+  plan->base = get_frame_records(base);
+  plan->frames = get_frame_records(bit);
+  plan->mfw = g_array_new(FALSE, FALSE, sizeof(guint));
+  plan->mfw_groups = g_array_new(FALSE, FALSE, sizeof(guint));
+
+  nframes = plan->frames->len;
+  g_assert(plan->base->len == nframes);
+  plan->diff = g_new0(guint8, nframes);
+
+  changed = g_array_new(FALSE, FALSE, sizeof(guint));
+  for (i = 0; i < nframes; i++) {
+    const gchar *old = g_array_index(plan->base, frame_record_t, i).frame;
+    const gchar *new = g_array_index(plan->frames, frame_record_t, i).frame;
+
+    if (old == new ||
+	!memcmp(plan_frame(plan, plan->base, i),
+		plan_frame(plan, plan->frames, i),
+		plan->framelen * sizeof(uint32_t)))
+      continue;
+
+    plan->diff[i] = FRAME_RUN;
+    g_array_append_val(changed, i);
   }
+
+  debit_log(L_WRITE,"%u frames out of %u differ", changed->len, nframes);
+  plan_mfw(plan, changed);
+  debit_log(L_WRITE,"%u frames are written in %u multi-frame writes",
+	    plan->mfw->len, plan->mfw_groups->len);
+
+  g_array_free(changed, TRUE);
+  return 0;
+}
+
+/* FAR writes reexecute the command in the CMD register, so that the
+   command of the previous write must be replaced first */
+static void
+bs_write_frame_start(bitstream_writer_t *writer, const guint32 far,
+		     const unsigned wordc) {
+  bs_write_wreg_u32(writer, CMD, WCFG);
+  bs_write_wreg_u32(writer, FAR, far);
+  bs_write_noop(writer);
+  bs_write_wreg(writer, TYPE_V2, FDRI, wordc);
+}
+
+/* Multi-frame write sequence: the frame is loaded into the frame
+   buffer, without any pad frame, then the MFWR command is issued, and
+   the frame is copied to each FAR by a write to the MFWR register
+   after the FAR write */
+static void
+bs_write_mfw_far(bitstream_writer_t *writer, const guint32 far) {
+  bs_write_wreg_u32(writer, FAR, far);
+  bs_write_wreg_u32(writer, MFWR, 0);
+}
+
+static void
+bs_write_mfw_frames(bitstream_writer_t *writer, const partial_plan_t *plan) {
+  const guint *offsets = (const guint *) plan->mfw->data;
+  const frame_record_t *frames = (const frame_record_t *) plan->frames->data;
+  guint group, i = 0;
+
+  for (group = 0; group < plan->mfw_groups->len; group++) {
+    const guint count = g_array_index(plan->mfw_groups, guint, group);
+    const guint end = i + count;
+
+    bs_write_frame_start(writer, frames[offsets[i]].far, plan->framelen);
+    write_frame(frames[offsets[i]].frame, 0, 0, 0, writer);
+    bs_write_autocrc(writer);
+
+    /* The FAR is rewritten before the command, as the FDRI write has
+       moved it past the frame */
+    bs_write_wreg_u32(writer, FAR, frames[offsets[i]].far);
+    bs_write_wreg_u32(writer, CMD, CMD_MFW);
+    bs_write_wreg_u32(writer, MFWR, 0);
+    for (i++; i < end; i++)
+      bs_write_mfw_far(writer, frames[offsets[i]].far);
+  }
+}
+
+static void
+bs_write_run_frames(bitstream_writer_t *writer, const partial_plan_t *plan) {
+  const frame_record_t *frames = (const frame_record_t *) plan->frames->data;
+  const guint nframes = plan->frames->len;
+  guint start, end;
+
+  for (start = 0; start < nframes; start = end) {
+    if (!is_run(plan, start)) {
+      end = start + 1;
+      continue;
+    }
+
+    for (end = start + 1; is_run(plan, end); end++)
+      ;
+
+    debit_log(L_WRITE,"Writing run of %u frames at %08x",
+	      end - start, frames[start].far);
+
+    bs_write_frame_start(writer, frames[start].far,
+			 (end - start + 1) * plan->framelen);
+    for (; start < end; start++)
+      write_frame(frames[start].frame, 0, 0, 0, writer);
+    bs_write_padding(writer, FDRI, plan->framelen);
+    bs_write_autocrc(writer);
+  }
+}
+
+/* The device is already configured and keeps running: its options
+   are left alone, and only the CRC is reset and the device checked */
+static void
+bs_write_partial_header(bitstream_writer_t *writer) {
+  const chip_struct_t *chip = writer->bit->chip_struct;
+
+#if defined(VIRTEX2) || defined(SPARTAN3)
+  bs_write_wreg_u32(writer, CMD, RCRC);
+  writer->crc = 0;
+  bs_write_wreg_u32(writer, FLR, chip->framelen-1);
 #else
-  (void) unlink(tmpname);
-  g_free(tmpname);
-  tmpname = NULL;
-#endif /* HAVE_MMAP */
-  return err;
+  bs_write_noop(writer);
+  bs_write_wreg_u32(writer, CMD, RCRC);
+  writer->crc = 0;
+  bs_write_noop(writer);
+  bs_write_noop(writer);
+#endif
+  bs_write_wreg_u32(writer, IDCODE, chip->idcode);
 }
 
+/* No global restore nor startup sequence, the device keeps running */
+static void
+bs_write_partial_footer(bitstream_writer_t *writer) {
+  const chip_struct_t *chip = writer->bit->chip_struct;
+  unsigned i;
+
+  bs_write_wreg_u32(writer, CMD, CMD_LFRM);
+  for (i = 0; i < chip->framelen; i++)
+    bs_write_noop(writer);
+
+  debit_log(L_WRITE,"CRC is %04x", writer->crc);
+  bs_write_wreg_u32(writer, CRC, writer->crc);
+
+  bs_write_wreg_u32(writer, CMD, DESYNCH);
+  for (i = 0; i < 16; i++)
+    bs_write_noop(writer);
+}
+
+static void
+bs_write_partial_body(bitstream_writer_t *writer, const void *data) {
+  const partial_plan_t *plan = data;
+
+  bs_write_synchro(writer);
+  bs_write_partial_header(writer);
+  bs_write_mfw_frames(writer, plan);
+  bs_write_run_frames(writer, plan);
+  bs_write_partial_footer(writer);
+}
+
+int
+bitstream_write_partial(const bitstream_parsed_t *base,
+			const bitstream_parsed_t *bit,
+			const char *output_dir,
+			const char *ofile) {
+  partial_plan_t plan;
+  int err;
+  (void) output_dir;
+
+  err = get_partial_plan(&plan, base, bit);
+  if (!err)
+    err = write_bitstream_file(bit, ofile, bs_write_partial_body, &plan);
+
+  free_partial_plan(&plan);
+  return err;
+}
 
 /* XXX no FreezeDCI option for now */
@@ -25,4 +25,20 @@ bitstream_write(const bitstream_parsed_t *bit,
 		const char *output_dir,
 		const char *ofile);
 
+/** \brief Write a partial bitstream
+ *
+ * Only the frames of bit which differ from those of base are written,
+ * so that loading the partial bitstream into a device configured with
+ * base yields the configuration of bit.
+ *
+ * @param base the bitstream already loaded into the device
+ * @param bit the bitstream to reach, for the same device
+ * @return 0 on success, -1 on error
+ */
+int
+bitstream_write_partial(const bitstream_parsed_t *base,
+			const bitstream_parsed_t *bit,
+			const char *output_dir,
+			const char *ofile);
+
 #endif /* _HAS_BISTREAM_WRITE */
@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2006, 2007 Jean-Baptiste Note <jean-baptiste.note@m4x.org>
+ *
+ * This file is part of debit.
+ *
+ * Debit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Debit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with debit.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Synthetic bitstream generation
+ */
+
+#include <string.h>
+#include <glib.h>
+
+#include "bitstream_parser.h"
+#include "bitheader.h"
+#include "design.h"
+#include "bitstream.h"
+#include "bitsynth.h"
+
+/* Give up setting pips after this many sites without any, in a row */
+#define SYNTH_MAX_MISSES 4096
+
+static const gchar synth_filename[] = "synth.ncd";
+static const gchar synth_date[] = "2007/01/01";
+static const gchar synth_time[] = "00:00:00";
+
+/* Each bit of the result is set with probability 2^-sparsity */
+static inline guint32
+random_word(GRand *rand, const unsigned sparsity) {
+  guint32 word = 0xffffffff;
+  unsigned i;
+
+  if (sparsity >= 32)
+    return 0;
+
+  for (i = 0; i < sparsity && word; i++)
+    word &= g_rand_int(rand);
+
+  return word;
+}
+
+int
+synth_bitstream(bitstream_parsed_t *bit, const unsigned chipid,
+		GRand *rand, const unsigned sparsity) {
+  const gchar *devname = bitstream_chip_name(chipid);
+  const chip_struct_t *chip_struct;
+  gsize nframes, i;
+  unsigned j;
+
+  if (!devname) {
+    g_warning("Unknown chip id %u", chipid);
+    return -1;
+  }
+
+  memset(bit, 0, sizeof(*bit));
+
+  /* The lengths of the options count the terminating NUL */
+  write_option(&bit->header, FILENAME, synth_filename, sizeof(synth_filename));
+  write_option(&bit->header, DEVICE_TYPE, devname, strlen(devname) + 1);
+  write_option(&bit->header, BUILD_DATE, synth_date, sizeof(synth_date));
+  write_option(&bit->header, BUILD_TIME, synth_time, sizeof(synth_time));
+
+  if (alloc_wbitstream(bit))
+    return -1;
+
+  chip_struct = bit->chip_struct;
+  nframes = bitstream_frame_count(bit);
+
+  for (i = 0; i < nframes; i++) {
+    guint32 *frame = (guint32 *) bitstream_frame(bit, i);
+    for (j = 0; j < chip_struct->framelen; j++)
+      frame[j] = random_word(rand, sparsity);
+  }
+
+  return 0;
+}
+
+/* Draw a pip of the database of the site */
+static gboolean
+random_pip(sited_pip_t *spip, const chip_descr_t *chip,
+	   const pip_db_t *pipdb, GRand *rand) {
+  const switch_type_t sw = sw_of_type(site_type(chip, spip->site));
+  const pipdb_control_t *memorydb = &pipdb->memorydb[sw];
+  const pip_control_t *ctrl;
+  const pip_data_t *data;
+
+  if (!memorydb->pipctrl_len)
+    return FALSE;
+
+  ctrl = &memorydb->pipctrl[g_rand_int_range(rand, 0, memorydb->pipctrl_len)];
+  if (!ctrl->datasize)
+    return FALSE;
+
+  data = &memorydb->pipdatadata[ctrl->dataoffset +
+				g_rand_int_range(rand, 0, ctrl->datasize)];
+  spip->pip.source = data->startwire;
+  spip->pip.target = ctrl->endwire;
+  return TRUE;
+}
+
+unsigned
+synth_pips(bitstream_parsed_t *bit, const chip_descr_t *chip,
+	   const pip_db_t *pipdb, GRand *rand, const unsigned npips) {
+  const gint32 nsites = chip->width * chip->height;
+  unsigned set = 0, misses = 0;
+
+  while (set < npips && misses < SYNTH_MAX_MISSES) {
+    sited_pip_t spip;
+    const unsigned *cfgbits;
+    size_t nbits;
+    uint32_t vals;
+
+    spip.site = g_rand_int_range(rand, 0, nsites);
+    if (!random_pip(&spip, chip, pipdb, rand) ||
+	bitpip_lookup(spip, chip, pipdb, &cfgbits, &nbits, &vals)) {
+      misses++;
+      continue;
+    }
+
+    set_bitstream_site_bits(bit, get_site(chip, spip.site), vals, cfgbits, nbits);
+    misses = 0;
+    set++;
+  }
+
+  return set;
+}
+
+void
+synth_blank_frames(bitstream_parsed_t *bit, GRand *rand, const unsigned nblank) {
+  const chip_struct_t *chip_struct = bit->chip_struct;
+  const gsize nframes = bitstream_frame_count(bit);
+  unsigned i;
+
+  for (i = 0; i < nblank; i++) {
+    gchar *frame = bitstream_frame(bit, g_rand_int_range(rand, 0, nframes));
+    memset(frame, 0, chip_struct->framelen * sizeof(guint32));
+  }
+}
+
+void
+free_synth_bitstream(bitstream_parsed_t *bit) {
+  free_wbitstream(bit);
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2006, 2007 Jean-Baptiste Note <jean-baptiste.note@m4x.org>
+ *
+ * This file is part of debit.
+ *
+ * Debit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Debit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with debit.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _HAS_BITSYNTH_H
+#define _HAS_BITSYNTH_H
+
+/** \file
+ *
+ * Synthetic bitstreams.
+ *
+ * A synthetic bitstream is a write bitstream covering the whole device,
+ * with random frame contents. Its header is well-formed, so that it
+ * can be written with bitstream_write and read back by the parser;
+ * this allows the processing of any part of a family to be measured
+ * without a design of the right size at hand.
+ */
+
+#include <glib.h>
+#include "bitstream_parser.h"
+#include "sites.h"
+#include "localpips.h"
+
+/** \brief Fill a bitstream with random frames
+ *
+ * The bitstream is allocated with alloc_wbitstream, and must be
+ * released with free_synth_bitstream.
+ *
+ * @param bit the bitstream to fill
+ * @param chipid the chip id of the device
+ * @param rand the random number generator
+ * @param sparsity every bit of the frames is set with probability
+ * 2^-sparsity; from 32 on, the frames are left blank
+ *
+ * @return 0 on success, -1 if the chip id is unknown
+ */
+int synth_bitstream(bitstream_parsed_t *bit, const unsigned chipid,
+		    GRand *rand, const unsigned sparsity);
+
+/** \brief Set random pips in a bitstream
+ *
+ * Each pip is drawn from the pip database of a random site, and set
+ * through bitpip_lookup, as the xdl compiler does. Pips set later
+ * override those of the same endpoint set earlier.
+ *
+ * @param bit the bitstream, filled by synth_bitstream
+ * @param chip the chip description of the bitstream
+ * @param pipdb the pip database
+ * @param rand the random number generator
+ * @param npips the number of pips to set
+ *
+ * @return the number of pips set, which is less than npips only if the
+ * database has no pips for the sites of the chip
+ */
+unsigned synth_pips(bitstream_parsed_t *bit, const chip_descr_t *chip,
+		    const pip_db_t *pipdb, GRand *rand, const unsigned npips);
+
+/** \brief Blank random frames of a bitstream
+ *
+ * Drawn last, with the same seed, the blanked frames are the only
+ * difference from the bitstream without them.
+ *
+ * @param bit the bitstream, filled by synth_bitstream
+ * @param rand the random number generator
+ * @param nblank the number of frames to blank, some of which may be
+ * drawn more than once
+ */
+void synth_blank_frames(bitstream_parsed_t *bit, GRand *rand,
+			const unsigned nblank);
+
+void free_synth_bitstream(bitstream_parsed_t *bit);
+
+#endif /* _HAS_BITSYNTH_H */
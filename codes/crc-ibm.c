@@ -78,6 +78,150 @@ const uint16_t crc_ibm_table_addr5[32] = {
   0x5000, 0x9601, 0x9c01, 0x5a00, 0x8801, 0x4e00, 0x4400, 0x8201,
 };
 
+/*
+ * CRC lookup tables for whole register writes: table t gives the CRC,
+ * from zero, of a write of a word whose only non-zero byte is byte t
+ * (LSB first), to the register at address zero.
+ */
+const uint16_t crc_ibm_table_words[4][256] = {
+ {
+ 0x0000, 0xc1e1, 0xc3c1, 0x0220, 0xc781, 0x0660, 0x0440, 0xc5a1,
+ 0xcf01, 0x0ee0, 0x0cc0, 0xcd21, 0x0880, 0xc961, 0xcb41, 0x0aa0,
+ 0xde01, 0x1fe0, 0x1dc0, 0xdc21, 0x1980, 0xd861, 0xda41, 0x1ba0,
+ 0x1100, 0xd0e1, 0xd2c1, 0x1320, 0xd681, 0x1760, 0x1540, 0xd4a1,
+ 0xfc01, 0x3de0, 0x3fc0, 0xfe21, 0x3b80, 0xfa61, 0xf841, 0x39a0,
+ 0x3300, 0xf2e1, 0xf0c1, 0x3120, 0xf481, 0x3560, 0x3740, 0xf6a1,
+ 0x2200, 0xe3e1, 0xe1c1, 0x2020, 0xe581, 0x2460, 0x2640, 0xe7a1,
+ 0xed01, 0x2ce0, 0x2ec0, 0xef21, 0x2a80, 0xeb61, 0xe941, 0x28a0,
+ 0xb801, 0x79e0, 0x7bc0, 0xba21, 0x7f80, 0xbe61, 0xbc41, 0x7da0,
+ 0x7700, 0xb6e1, 0xb4c1, 0x7520, 0xb081, 0x7160, 0x7340, 0xb2a1,
+ 0x6600, 0xa7e1, 0xa5c1, 0x6420, 0xa181, 0x6060, 0x6240, 0xa3a1,
+ 0xa901, 0x68e0, 0x6ac0, 0xab21, 0x6e80, 0xaf61, 0xad41, 0x6ca0,
+ 0x4400, 0x85e1, 0x87c1, 0x4620, 0x8381, 0x4260, 0x4040, 0x81a1,
+ 0x8b01, 0x4ae0, 0x48c0, 0x8921, 0x4c80, 0x8d61, 0x8f41, 0x4ea0,
+ 0x9a01, 0x5be0, 0x59c0, 0x9821, 0x5d80, 0x9c61, 0x9e41, 0x5fa0,
+ 0x5500, 0x94e1, 0x96c1, 0x5720, 0x9281, 0x5360, 0x5140, 0x90a1,
+ 0x3001, 0xf1e0, 0xf3c0, 0x3221, 0xf780, 0x3661, 0x3441, 0xf5a0,
+ 0xff00, 0x3ee1, 0x3cc1, 0xfd20, 0x3881, 0xf960, 0xfb40, 0x3aa1,
+ 0xee00, 0x2fe1, 0x2dc1, 0xec20, 0x2981, 0xe860, 0xea40, 0x2ba1,
+ 0x2101, 0xe0e0, 0xe2c0, 0x2321, 0xe680, 0x2761, 0x2541, 0xe4a0,
+ 0xcc00, 0x0de1, 0x0fc1, 0xce20, 0x0b81, 0xca60, 0xc840, 0x09a1,
+ 0x0301, 0xc2e0, 0xc0c0, 0x0121, 0xc480, 0x0561, 0x0741, 0xc6a0,
+ 0x1201, 0xd3e0, 0xd1c0, 0x1021, 0xd580, 0x1461, 0x1641, 0xd7a0,
+ 0xdd00, 0x1ce1, 0x1ec1, 0xdf20, 0x1a81, 0xdb60, 0xd940, 0x18a1,
+ 0x8800, 0x49e1, 0x4bc1, 0x8a20, 0x4f81, 0x8e60, 0x8c40, 0x4da1,
+ 0x4701, 0x86e0, 0x84c0, 0x4521, 0x8080, 0x4161, 0x4341, 0x82a0,
+ 0x5601, 0x97e0, 0x95c0, 0x5421, 0x9180, 0x5061, 0x5241, 0x93a0,
+ 0x9900, 0x58e1, 0x5ac1, 0x9b20, 0x5e81, 0x9f60, 0x9d40, 0x5ca1,
+ 0x7401, 0xb5e0, 0xb7c0, 0x7621, 0xb380, 0x7261, 0x7041, 0xb1a0,
+ 0xbb00, 0x7ae1, 0x78c1, 0xb920, 0x7c81, 0xbd60, 0xbf40, 0x7ea1,
+ 0xaa00, 0x6be1, 0x69c1, 0xa820, 0x6d81, 0xac60, 0xae40, 0x6fa1,
+ 0x6501, 0xa4e0, 0xa6c0, 0x6721, 0xa280, 0x6361, 0x6141, 0xa0a0,
+ },
+ {
+ 0x0000, 0x6002, 0xc004, 0xa006, 0xc00b, 0xa009, 0x000f, 0x600d,
+ 0xc015, 0xa017, 0x0011, 0x6013, 0x001e, 0x601c, 0xc01a, 0xa018,
+ 0xc029, 0xa02b, 0x002d, 0x602f, 0x0022, 0x6020, 0xc026, 0xa024,
+ 0x003c, 0x603e, 0xc038, 0xa03a, 0xc037, 0xa035, 0x0033, 0x6031,
+ 0xc051, 0xa053, 0x0055, 0x6057, 0x005a, 0x6058, 0xc05e, 0xa05c,
+ 0x0044, 0x6046, 0xc040, 0xa042, 0xc04f, 0xa04d, 0x004b, 0x6049,
+ 0x0078, 0x607a, 0xc07c, 0xa07e, 0xc073, 0xa071, 0x0077, 0x6075,
+ 0xc06d, 0xa06f, 0x0069, 0x606b, 0x0066, 0x6064, 0xc062, 0xa060,
+ 0xc0a1, 0xa0a3, 0x00a5, 0x60a7, 0x00aa, 0x60a8, 0xc0ae, 0xa0ac,
+ 0x00b4, 0x60b6, 0xc0b0, 0xa0b2, 0xc0bf, 0xa0bd, 0x00bb, 0x60b9,
+ 0x0088, 0x608a, 0xc08c, 0xa08e, 0xc083, 0xa081, 0x0087, 0x6085,
+ 0xc09d, 0xa09f, 0x0099, 0x609b, 0x0096, 0x6094, 0xc092, 0xa090,
+ 0x00f0, 0x60f2, 0xc0f4, 0xa0f6, 0xc0fb, 0xa0f9, 0x00ff, 0x60fd,
+ 0xc0e5, 0xa0e7, 0x00e1, 0x60e3, 0x00ee, 0x60ec, 0xc0ea, 0xa0e8,
+ 0xc0d9, 0xa0db, 0x00dd, 0x60df, 0x00d2, 0x60d0, 0xc0d6, 0xa0d4,
+ 0x00cc, 0x60ce, 0xc0c8, 0xa0ca, 0xc0c7, 0xa0c5, 0x00c3, 0x60c1,
+ 0xc141, 0xa143, 0x0145, 0x6147, 0x014a, 0x6148, 0xc14e, 0xa14c,
+ 0x0154, 0x6156, 0xc150, 0xa152, 0xc15f, 0xa15d, 0x015b, 0x6159,
+ 0x0168, 0x616a, 0xc16c, 0xa16e, 0xc163, 0xa161, 0x0167, 0x6165,
+ 0xc17d, 0xa17f, 0x0179, 0x617b, 0x0176, 0x6174, 0xc172, 0xa170,
+ 0x0110, 0x6112, 0xc114, 0xa116, 0xc11b, 0xa119, 0x011f, 0x611d,
+ 0xc105, 0xa107, 0x0101, 0x6103, 0x010e, 0x610c, 0xc10a, 0xa108,
+ 0xc139, 0xa13b, 0x013d, 0x613f, 0x0132, 0x6130, 0xc136, 0xa134,
+ 0x012c, 0x612e, 0xc128, 0xa12a, 0xc127, 0xa125, 0x0123, 0x6121,
+ 0x01e0, 0x61e2, 0xc1e4, 0xa1e6, 0xc1eb, 0xa1e9, 0x01ef, 0x61ed,
+ 0xc1f5, 0xa1f7, 0x01f1, 0x61f3, 0x01fe, 0x61fc, 0xc1fa, 0xa1f8,
+ 0xc1c9, 0xa1cb, 0x01cd, 0x61cf, 0x01c2, 0x61c0, 0xc1c6, 0xa1c4,
+ 0x01dc, 0x61de, 0xc1d8, 0xa1da, 0xc1d7, 0xa1d5, 0x01d3, 0x61d1,
+ 0xc1b1, 0xa1b3, 0x01b5, 0x61b7, 0x01ba, 0x61b8, 0xc1be, 0xa1bc,
+ 0x01a4, 0x61a6, 0xc1a0, 0xa1a2, 0xc1af, 0xa1ad, 0x01ab, 0x61a9,
+ 0x0198, 0x619a, 0xc19c, 0xa19e, 0xc193, 0xa191, 0x0197, 0x6195,
+ 0xc18d, 0xa18f, 0x0189, 0x618b, 0x0186, 0x6184, 0xc182, 0xa180,
+ },
+ {
+ 0x0000, 0xc281, 0xc501, 0x0780, 0xca01, 0x0880, 0x0f00, 0xcd81,
+ 0xd401, 0x1680, 0x1100, 0xd381, 0x1e00, 0xdc81, 0xdb01, 0x1980,
+ 0xe801, 0x2a80, 0x2d00, 0xef81, 0x2200, 0xe081, 0xe701, 0x2580,
+ 0x3c00, 0xfe81, 0xf901, 0x3b80, 0xf601, 0x3480, 0x3300, 0xf181,
+ 0x9001, 0x5280, 0x5500, 0x9781, 0x5a00, 0x9881, 0x9f01, 0x5d80,
+ 0x4400, 0x8681, 0x8101, 0x4380, 0x8e01, 0x4c80, 0x4b00, 0x8981,
+ 0x7800, 0xba81, 0xbd01, 0x7f80, 0xb201, 0x7080, 0x7700, 0xb581,
+ 0xac01, 0x6e80, 0x6900, 0xab81, 0x6600, 0xa481, 0xa301, 0x6180,
+ 0x6001, 0xa280, 0xa500, 0x6781, 0xaa00, 0x6881, 0x6f01, 0xad80,
+ 0xb400, 0x7681, 0x7101, 0xb380, 0x7e01, 0xbc80, 0xbb00, 0x7981,
+ 0x8800, 0x4a81, 0x4d01, 0x8f80, 0x4201, 0x8080, 0x8700, 0x4581,
+ 0x5c01, 0x9e80, 0x9900, 0x5b81, 0x9600, 0x5481, 0x5301, 0x9180,
+ 0xf000, 0x3281, 0x3501, 0xf780, 0x3a01, 0xf880, 0xff00, 0x3d81,
+ 0x2401, 0xe680, 0xe100, 0x2381, 0xee00, 0x2c81, 0x2b01, 0xe980,
+ 0x1801, 0xda80, 0xdd00, 0x1f81, 0xd200, 0x1081, 0x1701, 0xd580,
+ 0xcc00, 0x0e81, 0x0901, 0xcb80, 0x0601, 0xc480, 0xc300, 0x0181,
+ 0xc002, 0x0283, 0x0503, 0xc782, 0x0a03, 0xc882, 0xcf02, 0x0d83,
+ 0x1403, 0xd682, 0xd102, 0x1383, 0xde02, 0x1c83, 0x1b03, 0xd982,
+ 0x2803, 0xea82, 0xed02, 0x2f83, 0xe202, 0x2083, 0x2703, 0xe582,
+ 0xfc02, 0x3e83, 0x3903, 0xfb82, 0x3603, 0xf482, 0xf302, 0x3183,
+ 0x5003, 0x9282, 0x9502, 0x5783, 0x9a02, 0x5883, 0x5f03, 0x9d82,
+ 0x8402, 0x4683, 0x4103, 0x8382, 0x4e03, 0x8c82, 0x8b02, 0x4983,
+ 0xb802, 0x7a83, 0x7d03, 0xbf82, 0x7203, 0xb082, 0xb702, 0x7583,
+ 0x6c03, 0xae82, 0xa902, 0x6b83, 0xa602, 0x6483, 0x6303, 0xa182,
+ 0xa003, 0x6282, 0x6502, 0xa783, 0x6a02, 0xa883, 0xaf03, 0x6d82,
+ 0x7402, 0xb683, 0xb103, 0x7382, 0xbe03, 0x7c82, 0x7b02, 0xb983,
+ 0x4802, 0x8a83, 0x8d03, 0x4f82, 0x8203, 0x4082, 0x4702, 0x8583,
+ 0x9c03, 0x5e82, 0x5902, 0x9b83, 0x5602, 0x9483, 0x9303, 0x5182,
+ 0x3002, 0xf283, 0xf503, 0x3782, 0xfa03, 0x3882, 0x3f02, 0xfd83,
+ 0xe403, 0x2682, 0x2102, 0xe383, 0x2e02, 0xec83, 0xeb03, 0x2982,
+ 0xd803, 0x1a82, 0x1d02, 0xdf83, 0x1202, 0xd083, 0xd703, 0x1582,
+ 0x0c02, 0xce83, 0xc903, 0x0b82, 0xc603, 0x0482, 0x0302, 0xc183,
+ },
+ {
+ 0x0000, 0xc007, 0xc00d, 0x000a, 0xc019, 0x001e, 0x0014, 0xc013,
+ 0xc031, 0x0036, 0x003c, 0xc03b, 0x0028, 0xc02f, 0xc025, 0x0022,
+ 0xc061, 0x0066, 0x006c, 0xc06b, 0x0078, 0xc07f, 0xc075, 0x0072,
+ 0x0050, 0xc057, 0xc05d, 0x005a, 0xc049, 0x004e, 0x0044, 0xc043,
+ 0xc0c1, 0x00c6, 0x00cc, 0xc0cb, 0x00d8, 0xc0df, 0xc0d5, 0x00d2,
+ 0x00f0, 0xc0f7, 0xc0fd, 0x00fa, 0xc0e9, 0x00ee, 0x00e4, 0xc0e3,
+ 0x00a0, 0xc0a7, 0xc0ad, 0x00aa, 0xc0b9, 0x00be, 0x00b4, 0xc0b3,
+ 0xc091, 0x0096, 0x009c, 0xc09b, 0x0088, 0xc08f, 0xc085, 0x0082,
+ 0xc181, 0x0186, 0x018c, 0xc18b, 0x0198, 0xc19f, 0xc195, 0x0192,
+ 0x01b0, 0xc1b7, 0xc1bd, 0x01ba, 0xc1a9, 0x01ae, 0x01a4, 0xc1a3,
+ 0x01e0, 0xc1e7, 0xc1ed, 0x01ea, 0xc1f9, 0x01fe, 0x01f4, 0xc1f3,
+ 0xc1d1, 0x01d6, 0x01dc, 0xc1db, 0x01c8, 0xc1cf, 0xc1c5, 0x01c2,
+ 0x0140, 0xc147, 0xc14d, 0x014a, 0xc159, 0x015e, 0x0154, 0xc153,
+ 0xc171, 0x0176, 0x017c, 0xc17b, 0x0168, 0xc16f, 0xc165, 0x0162,
+ 0xc121, 0x0126, 0x012c, 0xc12b, 0x0138, 0xc13f, 0xc135, 0x0132,
+ 0x0110, 0xc117, 0xc11d, 0x011a, 0xc109, 0x010e, 0x0104, 0xc103,
+ 0xc301, 0x0306, 0x030c, 0xc30b, 0x0318, 0xc31f, 0xc315, 0x0312,
+ 0x0330, 0xc337, 0xc33d, 0x033a, 0xc329, 0x032e, 0x0324, 0xc323,
+ 0x0360, 0xc367, 0xc36d, 0x036a, 0xc379, 0x037e, 0x0374, 0xc373,
+ 0xc351, 0x0356, 0x035c, 0xc35b, 0x0348, 0xc34f, 0xc345, 0x0342,
+ 0x03c0, 0xc3c7, 0xc3cd, 0x03ca, 0xc3d9, 0x03de, 0x03d4, 0xc3d3,
+ 0xc3f1, 0x03f6, 0x03fc, 0xc3fb, 0x03e8, 0xc3ef, 0xc3e5, 0x03e2,
+ 0xc3a1, 0x03a6, 0x03ac, 0xc3ab, 0x03b8, 0xc3bf, 0xc3b5, 0x03b2,
+ 0x0390, 0xc397, 0xc39d, 0x039a, 0xc389, 0x038e, 0x0384, 0xc383,
+ 0x0280, 0xc287, 0xc28d, 0x028a, 0xc299, 0x029e, 0x0294, 0xc293,
+ 0xc2b1, 0x02b6, 0x02bc, 0xc2bb, 0x02a8, 0xc2af, 0xc2a5, 0x02a2,
+ 0xc2e1, 0x02e6, 0x02ec, 0xc2eb, 0x02f8, 0xc2ff, 0xc2f5, 0x02f2,
+ 0x02d0, 0xc2d7, 0xc2dd, 0x02da, 0xc2c9, 0x02ce, 0x02c4, 0xc2c3,
+ 0xc241, 0x0246, 0x024c, 0xc24b, 0x0258, 0xc25f, 0xc255, 0x0252,
+ 0x0270, 0xc277, 0xc27d, 0x027a, 0xc269, 0x026e, 0x0264, 0xc263,
+ 0x0220, 0xc227, 0xc22d, 0x022a, 0xc239, 0x023e, 0x0234, 0xc233,
+ 0xc211, 0x0216, 0x021c, 0xc21b, 0x0208, 0xc20f, 0xc205, 0x0202,
+ },
+};
+
 
 /**
  * crc_ibm - recompute the CRC for the data buffer
@@ -91,3 +235,36 @@ uint16_t crc_ibm(uint16_t crc, uint8_t const *buffer, size_t len)
 		crc = crc_ibm_byte(crc, *buffer++);
 	return crc;
 }
+
+static inline uint32_t
+crc_ibm_load_be(const uint8_t *p) {
+	return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+		((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+/**
+ * crc_ibm_words - update the CRC with a series of register writes
+ * @crc - previous CRC value
+ * @words - the words written, big-endian as in the bitstream
+ * @nwords - number of words
+ * @addr - address of the register written
+ *
+ * This is equivalent to four crc_ibm_byte and one crc_ibm_addr5 per
+ * word, with four table lookups per word. The address goes in last,
+ * and by linearity its contribution is the same for all words.
+ */
+uint16_t crc_ibm_words(uint16_t crc, const uint8_t *words, size_t nwords,
+		       uint8_t addr)
+{
+	const uint16_t k = crc_ibm_table_addr5[addr & 0x1F];
+
+	for (; nwords; nwords--, words += 4) {
+		const uint32_t x = crc ^ crc_ibm_load_be(words);
+		crc = crc_ibm_table_words[0][x & 0xFF] ^
+			crc_ibm_table_words[1][(x >> 8) & 0xFF] ^
+			crc_ibm_table_words[2][(x >> 16) & 0xFF] ^
+			crc_ibm_table_words[3][x >> 24] ^ k;
+	}
+
+	return crc;
+}
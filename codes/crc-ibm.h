@@ -35,7 +35,11 @@
 extern const uint16_t crc_ibm_table[256];
 extern const uint16_t crc_ibm_table_addr5[32];
 
+extern const uint16_t crc_ibm_table_words[4][256];
+
 extern uint16_t crc_ibm(uint16_t crc, const uint8_t *buffer, size_t len);
+extern uint16_t crc_ibm_words(uint16_t crc, const uint8_t *words, size_t nwords,
+			      uint8_t addr);
 
 /*
  * Shift-register implementation of the IBM CRC.
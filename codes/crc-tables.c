@@ -25,11 +25,12 @@
 #include <stdint.h>
 
 #include "crc32-c.h"
+#include "crc-ibm.h"
 
 #define POLY_CRC16_IBM 0x8005
 #define POLY_CRC16_IBM_REFLEX 0xa001
 
-static uint32_t g[8];
+static uint32_t g[32];
 /* Compute the basis polynomials */
 
 static void
@@ -101,6 +102,67 @@ crc32_dump_table(unsigned nbits, uint32_t poly, FILE *out) {
   }
 }
 
+/* One write to a configuration register: the 32 bits of the word,
+   then the 5 bits of the register address, here zero */
+static uint32_t
+crc32c_shift_word(uint32_t crc) {
+  crc = crc32c_byte(crc, 0);
+  crc = crc32c_byte(crc, 0);
+  crc = crc32c_byte(crc, 0);
+  crc = crc32c_byte(crc, 0);
+  return crc32c_addr5(crc, 0);
+}
+
+/* dumps the tables for slicing-by-8 over pairs of register writes:
+   the first four tables shift a byte of the first word through two
+   writes, the last four a byte of the second word through one */
+static void
+crc32c_dump_word_tables(FILE *out) {
+  unsigned t, i;
+
+  for (t = 0; t < 8; t++) {
+    fprintf(out, " {\n");
+    for (i = 0; i < 256; i++) {
+      uint32_t f = crc32c_shift_word(i << (8 * (t % 4)));
+      if (t < 4)
+	f = crc32c_shift_word(f);
+      fprintf(out, " 0x%08xL,", f);
+      if (i % 8 == 7)
+	fprintf(out, "\n");
+    }
+    fprintf(out, " },\n");
+  }
+}
+
+/* One write to a configuration register, from a zero CRC: the 32 bits
+   of the word, then the 5 bits of the register address, here zero */
+static uint16_t
+crc_ibm_shift_word(uint32_t val) {
+  uint16_t crc = 0;
+  crc = crc_ibm_byte(crc, val);
+  crc = crc_ibm_byte(crc, val >> 8);
+  crc = crc_ibm_byte(crc, val >> 16);
+  crc = crc_ibm_byte(crc, val >> 24);
+  return crc_ibm_addr5(crc, 0);
+}
+
+/* dumps the tables for slicing-by-4 over register writes: table t
+   shifts byte t of the word, xored with the CRC, through one write */
+static void
+crc_ibm_dump_word_tables(FILE *out) {
+  unsigned t, i;
+
+  for (t = 0; t < 4; t++) {
+    fprintf(out, " {\n");
+    for (i = 0; i < 256; i++) {
+      fprintf(out, " 0x%04x,", crc_ibm_shift_word(i << (8 * t)));
+      if (i % 8 == 7)
+	fprintf(out, "\n");
+    }
+    fprintf(out, " },\n");
+  }
+}
+
 int main(int argc, char *argv[], char **env) {
   FILE *out = stdout;
   fprintf(out, "crc_table_ibm[256] = {\n");
@@ -111,6 +173,10 @@ int main(int argc, char *argv[], char **env) {
   crc16_dump_table(5, POLY_CRC16_IBM_REFLEX, out);
   fprintf(out, "};\n");
 
+  fprintf(out, "crc_ibm_table_words[4][256] = {\n");
+  crc_ibm_dump_word_tables(out);
+  fprintf(out, "};\n");
+
   fprintf(out, "crc32c_table[256] = {\n");
   crc32_dump_table(8, CRC32C_POLY_REFLEX, out);
   fprintf(out, "};\n");
@@ -119,5 +185,13 @@ int main(int argc, char *argv[], char **env) {
   crc32_dump_table(5, CRC32C_POLY_REFLEX, out);
   fprintf(out, "};\n");
 
+  fprintf(out, "crc32c_table_shift10[1024] = {\n");
+  crc32_dump_table(10, CRC32C_POLY_REFLEX, out);
+  fprintf(out, "};\n");
+
+  fprintf(out, "crc32c_table_words[8][256] = {\n");
+  crc32c_dump_word_tables(out);
+  fprintf(out, "};\n");
+
   return 0;
 }
@@ -23,6 +23,12 @@
 
 #include "crc32-c.h"
 
+/* The SSE4.2 crc32 instruction is used when the CPU has it */
+#if defined(__x86_64__) && defined(__GNUC__) && \
+  (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#define CRC32C_HAVE_SSE42
+#endif
+
 const uint32_t crc32c_table[256] = {
  0x00000000L, 0xf26b8303L, 0xe13b70f7L, 0x1350f3f4L, 0xc79a971fL, 0x35f1141cL, 0x26a1e7e8L, 0xd4ca64ebL,
  0x8ad958cfL, 0x78b2dbccL, 0x6be22838L, 0x9989ab3bL, 0x4d43cfd0L, 0xbf284cd3L, 0xac78bf27L, 0x5e133c24L,
@@ -65,6 +71,412 @@ const uint32_t crc32c_table_addr5[32] = {
  0xc38d26c4L, 0x49547e0bL, 0xd3d3e1abL, 0x590ab964L, 0xe330a81aL, 0x69e9f0d5L, 0xf36e6f75L, 0x79b737baL,
 };
 
+const uint32_t crc32c_table_shift10[1024] = {
+ 0x00000000L, 0xff17c604L, 0xfbc3faf9L, 0x04d43cfdL, 0xf26b8303L, 0x0d7c4507L, 0x09a879faL, 0xf6bfbffeL,
+ 0xe13b70f7L, 0x1e2cb6f3L, 0x1af88a0eL, 0xe5ef4c0aL, 0x1350f3f4L, 0xec4735f0L, 0xe893090dL, 0x1784cf09L,
+ 0xc79a971fL, 0x388d511bL, 0x3c596de6L, 0xc34eabe2L, 0x35f1141cL, 0xcae6d218L, 0xce32eee5L, 0x312528e1L,
+ 0x26a1e7e8L, 0xd9b621ecL, 0xdd621d11L, 0x2275db15L, 0xd4ca64ebL, 0x2bdda2efL, 0x2f099e12L, 0xd01e5816L,
+ 0x8ad958cfL, 0x75ce9ecbL, 0x711aa236L, 0x8e0d6432L, 0x78b2dbccL, 0x87a51dc8L, 0x83712135L, 0x7c66e731L,
+ 0x6be22838L, 0x94f5ee3cL, 0x9021d2c1L, 0x6f3614c5L, 0x9989ab3bL, 0x669e6d3fL, 0x624a51c2L, 0x9d5d97c6L,
+ 0x4d43cfd0L, 0xb25409d4L, 0xb6803529L, 0x4997f32dL, 0xbf284cd3L, 0x403f8ad7L, 0x44ebb62aL, 0xbbfc702eL,
+ 0xac78bf27L, 0x536f7923L, 0x57bb45deL, 0xa8ac83daL, 0x5e133c24L, 0xa104fa20L, 0xa5d0c6ddL, 0x5ac700d9L,
+ 0x105ec76fL, 0xef49016bL, 0xeb9d3d96L, 0x148afb92L, 0xe235446cL, 0x1d228268L, 0x19f6be95L, 0xe6e17891L,
+ 0xf165b798L, 0x0e72719cL, 0x0aa64d61L, 0xf5b18b65L, 0x030e349bL, 0xfc19f29fL, 0xf8cdce62L, 0x07da0866L,
+ 0xd7c45070L, 0x28d39674L, 0x2c07aa89L, 0xd3106c8dL, 0x25afd373L, 0xdab81577L, 0xde6c298aL, 0x217bef8eL,
+ 0x36ff2087L, 0xc9e8e683L, 0xcd3cda7eL, 0x322b1c7aL, 0xc494a384L, 0x3b836580L, 0x3f57597dL, 0xc0409f79L,
+ 0x9a879fa0L, 0x659059a4L, 0x61446559L, 0x9e53a35dL, 0x68ec1ca3L, 0x97fbdaa7L, 0x932fe65aL, 0x6c38205eL,
+ 0x7bbcef57L, 0x84ab2953L, 0x807f15aeL, 0x7f68d3aaL, 0x89d76c54L, 0x76c0aa50L, 0x721496adL, 0x8d0350a9L,
+ 0x5d1d08bfL, 0xa20acebbL, 0xa6def246L, 0x59c93442L, 0xaf768bbcL, 0x50614db8L, 0x54b57145L, 0xaba2b741L,
+ 0xbc267848L, 0x4331be4cL, 0x47e582b1L, 0xb8f244b5L, 0x4e4dfb4bL, 0xb15a3d4fL, 0xb58e01b2L, 0x4a99c7b6L,
+ 0x20bd8edeL, 0xdfaa48daL, 0xdb7e7427L, 0x2469b223L, 0xd2d60dddL, 0x2dc1cbd9L, 0x2915f724L, 0xd6023120L,
+ 0xc186fe29L, 0x3e91382dL, 0x3a4504d0L, 0xc552c2d4L, 0x33ed7d2aL, 0xccfabb2eL, 0xc82e87d3L, 0x373941d7L,
+ 0xe72719c1L, 0x1830dfc5L, 0x1ce4e338L, 0xe3f3253cL, 0x154c9ac2L, 0xea5b5cc6L, 0xee8f603bL, 0x1198a63fL,
+ 0x061c6936L, 0xf90baf32L, 0xfddf93cfL, 0x02c855cbL, 0xf477ea35L, 0x0b602c31L, 0x0fb410ccL, 0xf0a3d6c8L,
+ 0xaa64d611L, 0x55731015L, 0x51a72ce8L, 0xaeb0eaecL, 0x580f5512L, 0xa7189316L, 0xa3ccafebL, 0x5cdb69efL,
+ 0x4b5fa6e6L, 0xb44860e2L, 0xb09c5c1fL, 0x4f8b9a1bL, 0xb93425e5L, 0x4623e3e1L, 0x42f7df1cL, 0xbde01918L,
+ 0x6dfe410eL, 0x92e9870aL, 0x963dbbf7L, 0x692a7df3L, 0x9f95c20dL, 0x60820409L, 0x645638f4L, 0x9b41fef0L,
+ 0x8cc531f9L, 0x73d2f7fdL, 0x7706cb00L, 0x88110d04L, 0x7eaeb2faL, 0x81b974feL, 0x856d4803L, 0x7a7a8e07L,
+ 0x30e349b1L, 0xcff48fb5L, 0xcb20b348L, 0x3437754cL, 0xc288cab2L, 0x3d9f0cb6L, 0x394b304bL, 0xc65cf64fL,
+ 0xd1d83946L, 0x2ecfff42L, 0x2a1bc3bfL, 0xd50c05bbL, 0x23b3ba45L, 0xdca47c41L, 0xd87040bcL, 0x276786b8L,
+ 0xf779deaeL, 0x086e18aaL, 0x0cba2457L, 0xf3ade253L, 0x05125dadL, 0xfa059ba9L, 0xfed1a754L, 0x01c66150L,
+ 0x1642ae59L, 0xe955685dL, 0xed8154a0L, 0x129692a4L, 0xe4292d5aL, 0x1b3eeb5eL, 0x1fead7a3L, 0xe0fd11a7L,
+ 0xba3a117eL, 0x452dd77aL, 0x41f9eb87L, 0xbeee2d83L, 0x4851927dL, 0xb7465479L, 0xb3926884L, 0x4c85ae80L,
+ 0x5b016189L, 0xa416a78dL, 0xa0c29b70L, 0x5fd55d74L, 0xa96ae28aL, 0x567d248eL, 0x52a91873L, 0xadbede77L,
+ 0x7da08661L, 0x82b74065L, 0x86637c98L, 0x7974ba9cL, 0x8fcb0562L, 0x70dcc366L, 0x7408ff9bL, 0x8b1f399fL,
+ 0x9c9bf696L, 0x638c3092L, 0x67580c6fL, 0x984fca6bL, 0x6ef07595L, 0x91e7b391L, 0x95338f6cL, 0x6a244968L,
+ 0x417b1dbcL, 0xbe6cdbb8L, 0xbab8e745L, 0x45af2141L, 0xb3109ebfL, 0x4c0758bbL, 0x48d36446L, 0xb7c4a242L,
+ 0xa0406d4bL, 0x5f57ab4fL, 0x5b8397b2L, 0xa49451b6L, 0x522bee48L, 0xad3c284cL, 0xa9e814b1L, 0x56ffd2b5L,
+ 0x86e18aa3L, 0x79f64ca7L, 0x7d22705aL, 0x8235b65eL, 0x748a09a0L, 0x8b9dcfa4L, 0x8f49f359L, 0x705e355dL,
+ 0x67dafa54L, 0x98cd3c50L, 0x9c1900adL, 0x630ec6a9L, 0x95b17957L, 0x6aa6bf53L, 0x6e7283aeL, 0x916545aaL,
+ 0xcba24573L, 0x34b58377L, 0x3061bf8aL, 0xcf76798eL, 0x39c9c670L, 0xc6de0074L, 0xc20a3c89L, 0x3d1dfa8dL,
+ 0x2a993584L, 0xd58ef380L, 0xd15acf7dL, 0x2e4d0979L, 0xd8f2b687L, 0x27e57083L, 0x23314c7eL, 0xdc268a7aL,
+ 0x0c38d26cL, 0xf32f1468L, 0xf7fb2895L, 0x08ecee91L, 0xfe53516fL, 0x0144976bL, 0x0590ab96L, 0xfa876d92L,
+ 0xed03a29bL, 0x1214649fL, 0x16c05862L, 0xe9d79e66L, 0x1f682198L, 0xe07fe79cL, 0xe4abdb61L, 0x1bbc1d65L,
+ 0x5125dad3L, 0xae321cd7L, 0xaae6202aL, 0x55f1e62eL, 0xa34e59d0L, 0x5c599fd4L, 0x588da329L, 0xa79a652dL,
+ 0xb01eaa24L, 0x4f096c20L, 0x4bdd50ddL, 0xb4ca96d9L, 0x42752927L, 0xbd62ef23L, 0xb9b6d3deL, 0x46a115daL,
+ 0x96bf4dccL, 0x69a88bc8L, 0x6d7cb735L, 0x926b7131L, 0x64d4cecfL, 0x9bc308cbL, 0x9f173436L, 0x6000f232L,
+ 0x77843d3bL, 0x8893fb3fL, 0x8c47c7c2L, 0x735001c6L, 0x85efbe38L, 0x7af8783cL, 0x7e2c44c1L, 0x813b82c5L,
+ 0xdbfc821cL, 0x24eb4418L, 0x203f78e5L, 0xdf28bee1L, 0x2997011fL, 0xd680c71bL, 0xd254fbe6L, 0x2d433de2L,
+ 0x3ac7f2ebL, 0xc5d034efL, 0xc1040812L, 0x3e13ce16L, 0xc8ac71e8L, 0x37bbb7ecL, 0x336f8b11L, 0xcc784d15L,
+ 0x1c661503L, 0xe371d307L, 0xe7a5effaL, 0x18b229feL, 0xee0d9600L, 0x111a5004L, 0x15ce6cf9L, 0xead9aafdL,
+ 0xfd5d65f4L, 0x024aa3f0L, 0x069e9f0dL, 0xf9895909L, 0x0f36e6f7L, 0xf02120f3L, 0xf4f51c0eL, 0x0be2da0aL,
+ 0x61c69362L, 0x9ed15566L, 0x9a05699bL, 0x6512af9fL, 0x93ad1061L, 0x6cbad665L, 0x686eea98L, 0x97792c9cL,
+ 0x80fde395L, 0x7fea2591L, 0x7b3e196cL, 0x8429df68L, 0x72966096L, 0x8d81a692L, 0x89559a6fL, 0x76425c6bL,
+ 0xa65c047dL, 0x594bc279L, 0x5d9ffe84L, 0xa2883880L, 0x5437877eL, 0xab20417aL, 0xaff47d87L, 0x50e3bb83L,
+ 0x4767748aL, 0xb870b28eL, 0xbca48e73L, 0x43b34877L, 0xb50cf789L, 0x4a1b318dL, 0x4ecf0d70L, 0xb1d8cb74L,
+ 0xeb1fcbadL, 0x14080da9L, 0x10dc3154L, 0xefcbf750L, 0x197448aeL, 0xe6638eaaL, 0xe2b7b257L, 0x1da07453L,
+ 0x0a24bb5aL, 0xf5337d5eL, 0xf1e741a3L, 0x0ef087a7L, 0xf84f3859L, 0x0758fe5dL, 0x038cc2a0L, 0xfc9b04a4L,
+ 0x2c855cb2L, 0xd3929ab6L, 0xd746a64bL, 0x2851604fL, 0xdeeedfb1L, 0x21f919b5L, 0x252d2548L, 0xda3ae34cL,
+ 0xcdbe2c45L, 0x32a9ea41L, 0x367dd6bcL, 0xc96a10b8L, 0x3fd5af46L, 0xc0c26942L, 0xc41655bfL, 0x3b0193bbL,
+ 0x7198540dL, 0x8e8f9209L, 0x8a5baef4L, 0x754c68f0L, 0x83f3d70eL, 0x7ce4110aL, 0x78302df7L, 0x8727ebf3L,
+ 0x90a324faL, 0x6fb4e2feL, 0x6b60de03L, 0x94771807L, 0x62c8a7f9L, 0x9ddf61fdL, 0x990b5d00L, 0x661c9b04L,
+ 0xb602c312L, 0x49150516L, 0x4dc139ebL, 0xb2d6ffefL, 0x44694011L, 0xbb7e8615L, 0xbfaabae8L, 0x40bd7cecL,
+ 0x5739b3e5L, 0xa82e75e1L, 0xacfa491cL, 0x53ed8f18L, 0xa55230e6L, 0x5a45f6e2L, 0x5e91ca1fL, 0xa1860c1bL,
+ 0xfb410cc2L, 0x0456cac6L, 0x0082f63bL, 0xff95303fL, 0x092a8fc1L, 0xf63d49c5L, 0xf2e97538L, 0x0dfeb33cL,
+ 0x1a7a7c35L, 0xe56dba31L, 0xe1b986ccL, 0x1eae40c8L, 0xe811ff36L, 0x17063932L, 0x13d205cfL, 0xecc5c3cbL,
+ 0x3cdb9bddL, 0xc3cc5dd9L, 0xc7186124L, 0x380fa720L, 0xceb018deL, 0x31a7dedaL, 0x3573e227L, 0xca642423L,
+ 0xdde0eb2aL, 0x22f72d2eL, 0x262311d3L, 0xd934d7d7L, 0x2f8b6829L, 0xd09cae2dL, 0xd44892d0L, 0x2b5f54d4L,
+ 0x82f63b78L, 0x7de1fd7cL, 0x7935c181L, 0x86220785L, 0x709db87bL, 0x8f8a7e7fL, 0x8b5e4282L, 0x74498486L,
+ 0x63cd4b8fL, 0x9cda8d8bL, 0x980eb176L, 0x67197772L, 0x91a6c88cL, 0x6eb10e88L, 0x6a653275L, 0x9572f471L,
+ 0x456cac67L, 0xba7b6a63L, 0xbeaf569eL, 0x41b8909aL, 0xb7072f64L, 0x4810e960L, 0x4cc4d59dL, 0xb3d31399L,
+ 0xa457dc90L, 0x5b401a94L, 0x5f942669L, 0xa083e06dL, 0x563c5f93L, 0xa92b9997L, 0xadffa56aL, 0x52e8636eL,
+ 0x082f63b7L, 0xf738a5b3L, 0xf3ec994eL, 0x0cfb5f4aL, 0xfa44e0b4L, 0x055326b0L, 0x01871a4dL, 0xfe90dc49L,
+ 0xe9141340L, 0x1603d544L, 0x12d7e9b9L, 0xedc02fbdL, 0x1b7f9043L, 0xe4685647L, 0xe0bc6abaL, 0x1fabacbeL,
+ 0xcfb5f4a8L, 0x30a232acL, 0x34760e51L, 0xcb61c855L, 0x3dde77abL, 0xc2c9b1afL, 0xc61d8d52L, 0x390a4b56L,
+ 0x2e8e845fL, 0xd199425bL, 0xd54d7ea6L, 0x2a5ab8a2L, 0xdce5075cL, 0x23f2c158L, 0x2726fda5L, 0xd8313ba1L,
+ 0x92a8fc17L, 0x6dbf3a13L, 0x696b06eeL, 0x967cc0eaL, 0x60c37f14L, 0x9fd4b910L, 0x9b0085edL, 0x641743e9L,
+ 0x73938ce0L, 0x8c844ae4L, 0x88507619L, 0x7747b01dL, 0x81f80fe3L, 0x7eefc9e7L, 0x7a3bf51aL, 0x852c331eL,
+ 0x55326b08L, 0xaa25ad0cL, 0xaef191f1L, 0x51e657f5L, 0xa759e80bL, 0x584e2e0fL, 0x5c9a12f2L, 0xa38dd4f6L,
+ 0xb4091bffL, 0x4b1eddfbL, 0x4fcae106L, 0xb0dd2702L, 0x466298fcL, 0xb9755ef8L, 0xbda16205L, 0x42b6a401L,
+ 0x1871a4d8L, 0xe76662dcL, 0xe3b25e21L, 0x1ca59825L, 0xea1a27dbL, 0x150de1dfL, 0x11d9dd22L, 0xeece1b26L,
+ 0xf94ad42fL, 0x065d122bL, 0x02892ed6L, 0xfd9ee8d2L, 0x0b21572cL, 0xf4369128L, 0xf0e2add5L, 0x0ff56bd1L,
+ 0xdfeb33c7L, 0x20fcf5c3L, 0x2428c93eL, 0xdb3f0f3aL, 0x2d80b0c4L, 0xd29776c0L, 0xd6434a3dL, 0x29548c39L,
+ 0x3ed04330L, 0xc1c78534L, 0xc513b9c9L, 0x3a047fcdL, 0xccbbc033L, 0x33ac0637L, 0x37783acaL, 0xc86ffcceL,
+ 0xa24bb5a6L, 0x5d5c73a2L, 0x59884f5fL, 0xa69f895bL, 0x502036a5L, 0xaf37f0a1L, 0xabe3cc5cL, 0x54f40a58L,
+ 0x4370c551L, 0xbc670355L, 0xb8b33fa8L, 0x47a4f9acL, 0xb11b4652L, 0x4e0c8056L, 0x4ad8bcabL, 0xb5cf7aafL,
+ 0x65d122b9L, 0x9ac6e4bdL, 0x9e12d840L, 0x61051e44L, 0x97baa1baL, 0x68ad67beL, 0x6c795b43L, 0x936e9d47L,
+ 0x84ea524eL, 0x7bfd944aL, 0x7f29a8b7L, 0x803e6eb3L, 0x7681d14dL, 0x89961749L, 0x8d422bb4L, 0x7255edb0L,
+ 0x2892ed69L, 0xd7852b6dL, 0xd3511790L, 0x2c46d194L, 0xdaf96e6aL, 0x25eea86eL, 0x213a9493L, 0xde2d5297L,
+ 0xc9a99d9eL, 0x36be5b9aL, 0x326a6767L, 0xcd7da163L, 0x3bc21e9dL, 0xc4d5d899L, 0xc001e464L, 0x3f162260L,
+ 0xef087a76L, 0x101fbc72L, 0x14cb808fL, 0xebdc468bL, 0x1d63f975L, 0xe2743f71L, 0xe6a0038cL, 0x19b7c588L,
+ 0x0e330a81L, 0xf124cc85L, 0xf5f0f078L, 0x0ae7367cL, 0xfc588982L, 0x034f4f86L, 0x079b737bL, 0xf88cb57fL,
+ 0xb21572c9L, 0x4d02b4cdL, 0x49d68830L, 0xb6c14e34L, 0x407ef1caL, 0xbf6937ceL, 0xbbbd0b33L, 0x44aacd37L,
+ 0x532e023eL, 0xac39c43aL, 0xa8edf8c7L, 0x57fa3ec3L, 0xa145813dL, 0x5e524739L, 0x5a867bc4L, 0xa591bdc0L,
+ 0x758fe5d6L, 0x8a9823d2L, 0x8e4c1f2fL, 0x715bd92bL, 0x87e466d5L, 0x78f3a0d1L, 0x7c279c2cL, 0x83305a28L,
+ 0x94b49521L, 0x6ba35325L, 0x6f776fd8L, 0x9060a9dcL, 0x66df1622L, 0x99c8d026L, 0x9d1cecdbL, 0x620b2adfL,
+ 0x38cc2a06L, 0xc7dbec02L, 0xc30fd0ffL, 0x3c1816fbL, 0xcaa7a905L, 0x35b06f01L, 0x316453fcL, 0xce7395f8L,
+ 0xd9f75af1L, 0x26e09cf5L, 0x2234a008L, 0xdd23660cL, 0x2b9cd9f2L, 0xd48b1ff6L, 0xd05f230bL, 0x2f48e50fL,
+ 0xff56bd19L, 0x00417b1dL, 0x049547e0L, 0xfb8281e4L, 0x0d3d3e1aL, 0xf22af81eL, 0xf6fec4e3L, 0x09e902e7L,
+ 0x1e6dcdeeL, 0xe17a0beaL, 0xe5ae3717L, 0x1ab9f113L, 0xec064eedL, 0x131188e9L, 0x17c5b414L, 0xe8d27210L,
+ 0xc38d26c4L, 0x3c9ae0c0L, 0x384edc3dL, 0xc7591a39L, 0x31e6a5c7L, 0xcef163c3L, 0xca255f3eL, 0x3532993aL,
+ 0x22b65633L, 0xdda19037L, 0xd975accaL, 0x26626aceL, 0xd0ddd530L, 0x2fca1334L, 0x2b1e2fc9L, 0xd409e9cdL,
+ 0x0417b1dbL, 0xfb0077dfL, 0xffd44b22L, 0x00c38d26L, 0xf67c32d8L, 0x096bf4dcL, 0x0dbfc821L, 0xf2a80e25L,
+ 0xe52cc12cL, 0x1a3b0728L, 0x1eef3bd5L, 0xe1f8fdd1L, 0x1747422fL, 0xe850842bL, 0xec84b8d6L, 0x13937ed2L,
+ 0x49547e0bL, 0xb643b80fL, 0xb29784f2L, 0x4d8042f6L, 0xbb3ffd08L, 0x44283b0cL, 0x40fc07f1L, 0xbfebc1f5L,
+ 0xa86f0efcL, 0x5778c8f8L, 0x53acf405L, 0xacbb3201L, 0x5a048dffL, 0xa5134bfbL, 0xa1c77706L, 0x5ed0b102L,
+ 0x8ecee914L, 0x71d92f10L, 0x750d13edL, 0x8a1ad5e9L, 0x7ca56a17L, 0x83b2ac13L, 0x876690eeL, 0x787156eaL,
+ 0x6ff599e3L, 0x90e25fe7L, 0x9436631aL, 0x6b21a51eL, 0x9d9e1ae0L, 0x6289dce4L, 0x665de019L, 0x994a261dL,
+ 0xd3d3e1abL, 0x2cc427afL, 0x28101b52L, 0xd707dd56L, 0x21b862a8L, 0xdeafa4acL, 0xda7b9851L, 0x256c5e55L,
+ 0x32e8915cL, 0xcdff5758L, 0xc92b6ba5L, 0x363cada1L, 0xc083125fL, 0x3f94d45bL, 0x3b40e8a6L, 0xc4572ea2L,
+ 0x144976b4L, 0xeb5eb0b0L, 0xef8a8c4dL, 0x109d4a49L, 0xe622f5b7L, 0x193533b3L, 0x1de10f4eL, 0xe2f6c94aL,
+ 0xf5720643L, 0x0a65c047L, 0x0eb1fcbaL, 0xf1a63abeL, 0x07198540L, 0xf80e4344L, 0xfcda7fb9L, 0x03cdb9bdL,
+ 0x590ab964L, 0xa61d7f60L, 0xa2c9439dL, 0x5dde8599L, 0xab613a67L, 0x5476fc63L, 0x50a2c09eL, 0xafb5069aL,
+ 0xb831c993L, 0x47260f97L, 0x43f2336aL, 0xbce5f56eL, 0x4a5a4a90L, 0xb54d8c94L, 0xb199b069L, 0x4e8e766dL,
+ 0x9e902e7bL, 0x6187e87fL, 0x6553d482L, 0x9a441286L, 0x6cfbad78L, 0x93ec6b7cL, 0x97385781L, 0x682f9185L,
+ 0x7fab5e8cL, 0x80bc9888L, 0x8468a475L, 0x7b7f6271L, 0x8dc0dd8fL, 0x72d71b8bL, 0x76032776L, 0x8914e172L,
+ 0xe330a81aL, 0x1c276e1eL, 0x18f352e3L, 0xe7e494e7L, 0x115b2b19L, 0xee4ced1dL, 0xea98d1e0L, 0x158f17e4L,
+ 0x020bd8edL, 0xfd1c1ee9L, 0xf9c82214L, 0x06dfe410L, 0xf0605beeL, 0x0f779deaL, 0x0ba3a117L, 0xf4b46713L,
+ 0x24aa3f05L, 0xdbbdf901L, 0xdf69c5fcL, 0x207e03f8L, 0xd6c1bc06L, 0x29d67a02L, 0x2d0246ffL, 0xd21580fbL,
+ 0xc5914ff2L, 0x3a8689f6L, 0x3e52b50bL, 0xc145730fL, 0x37faccf1L, 0xc8ed0af5L, 0xcc393608L, 0x332ef00cL,
+ 0x69e9f0d5L, 0x96fe36d1L, 0x922a0a2cL, 0x6d3dcc28L, 0x9b8273d6L, 0x6495b5d2L, 0x6041892fL, 0x9f564f2bL,
+ 0x88d28022L, 0x77c54626L, 0x73117adbL, 0x8c06bcdfL, 0x7ab90321L, 0x85aec525L, 0x817af9d8L, 0x7e6d3fdcL,
+ 0xae7367caL, 0x5164a1ceL, 0x55b09d33L, 0xaaa75b37L, 0x5c18e4c9L, 0xa30f22cdL, 0xa7db1e30L, 0x58ccd834L,
+ 0x4f48173dL, 0xb05fd139L, 0xb48bedc4L, 0x4b9c2bc0L, 0xbd23943eL, 0x4234523aL, 0x46e06ec7L, 0xb9f7a8c3L,
+ 0xf36e6f75L, 0x0c79a971L, 0x08ad958cL, 0xf7ba5388L, 0x0105ec76L, 0xfe122a72L, 0xfac6168fL, 0x05d1d08bL,
+ 0x12551f82L, 0xed42d986L, 0xe996e57bL, 0x1681237fL, 0xe03e9c81L, 0x1f295a85L, 0x1bfd6678L, 0xe4eaa07cL,
+ 0x34f4f86aL, 0xcbe33e6eL, 0xcf370293L, 0x3020c497L, 0xc69f7b69L, 0x3988bd6dL, 0x3d5c8190L, 0xc24b4794L,
+ 0xd5cf889dL, 0x2ad84e99L, 0x2e0c7264L, 0xd11bb460L, 0x27a40b9eL, 0xd8b3cd9aL, 0xdc67f167L, 0x23703763L,
+ 0x79b737baL, 0x86a0f1beL, 0x8274cd43L, 0x7d630b47L, 0x8bdcb4b9L, 0x74cb72bdL, 0x701f4e40L, 0x8f088844L,
+ 0x988c474dL, 0x679b8149L, 0x634fbdb4L, 0x9c587bb0L, 0x6ae7c44eL, 0x95f0024aL, 0x91243eb7L, 0x6e33f8b3L,
+ 0xbe2da0a5L, 0x413a66a1L, 0x45ee5a5cL, 0xbaf99c58L, 0x4c4623a6L, 0xb351e5a2L, 0xb785d95fL, 0x48921f5bL,
+ 0x5f16d052L, 0xa0011656L, 0xa4d52aabL, 0x5bc2ecafL, 0xad7d5351L, 0x526a9555L, 0x56bea9a8L, 0xa9a96facL,
+};
+
+const uint32_t crc32c_table_words[8][256] = {
+ {
+ 0x00000000L, 0x3d0fb592L, 0x7a1f6b24L, 0x4710deb6L, 0xf43ed648L, 0xc93163daL, 0x8e21bd6cL, 0xb32e08feL,
+ 0xed91da61L, 0xd09e6ff3L, 0x978eb145L, 0xaa8104d7L, 0x19af0c29L, 0x24a0b9bbL, 0x63b0670dL, 0x5ebfd29fL,
+ 0xdecfc233L, 0xe3c077a1L, 0xa4d0a917L, 0x99df1c85L, 0x2af1147bL, 0x17fea1e9L, 0x50ee7f5fL, 0x6de1cacdL,
+ 0x335e1852L, 0x0e51adc0L, 0x49417376L, 0x744ec6e4L, 0xc760ce1aL, 0xfa6f7b88L, 0xbd7fa53eL, 0x807010acL,
+ 0xb873f297L, 0x857c4705L, 0xc26c99b3L, 0xff632c21L, 0x4c4d24dfL, 0x7142914dL, 0x36524ffbL, 0x0b5dfa69L,
+ 0x55e228f6L, 0x68ed9d64L, 0x2ffd43d2L, 0x12f2f640L, 0xa1dcfebeL, 0x9cd34b2cL, 0xdbc3959aL, 0xe6cc2008L,
+ 0x66bc30a4L, 0x5bb38536L, 0x1ca35b80L, 0x21acee12L, 0x9282e6ecL, 0xaf8d537eL, 0xe89d8dc8L, 0xd592385aL,
+ 0x8b2deac5L, 0xb6225f57L, 0xf13281e1L, 0xcc3d3473L, 0x7f133c8dL, 0x421c891fL, 0x050c57a9L, 0x3803e23bL,
+ 0x750b93dfL, 0x4804264dL, 0x0f14f8fbL, 0x321b4d69L, 0x81354597L, 0xbc3af005L, 0xfb2a2eb3L, 0xc6259b21L,
+ 0x989a49beL, 0xa595fc2cL, 0xe285229aL, 0xdf8a9708L, 0x6ca49ff6L, 0x51ab2a64L, 0x16bbf4d2L, 0x2bb44140L,
+ 0xabc451ecL, 0x96cbe47eL, 0xd1db3ac8L, 0xecd48f5aL, 0x5ffa87a4L, 0x62f53236L, 0x25e5ec80L, 0x18ea5912L,
+ 0x46558b8dL, 0x7b5a3e1fL, 0x3c4ae0a9L, 0x0145553bL, 0xb26b5dc5L, 0x8f64e857L, 0xc87436e1L, 0xf57b8373L,
+ 0xcd786148L, 0xf077d4daL, 0xb7670a6cL, 0x8a68bffeL, 0x3946b700L, 0x04490292L, 0x4359dc24L, 0x7e5669b6L,
+ 0x20e9bb29L, 0x1de60ebbL, 0x5af6d00dL, 0x67f9659fL, 0xd4d76d61L, 0xe9d8d8f3L, 0xaec80645L, 0x93c7b3d7L,
+ 0x13b7a37bL, 0x2eb816e9L, 0x69a8c85fL, 0x54a77dcdL, 0xe7897533L, 0xda86c0a1L, 0x9d961e17L, 0xa099ab85L,
+ 0xfe26791aL, 0xc329cc88L, 0x8439123eL, 0xb936a7acL, 0x0a18af52L, 0x37171ac0L, 0x7007c476L, 0x4d0871e4L,
+ 0xea1727beL, 0xd718922cL, 0x90084c9aL, 0xad07f908L, 0x1e29f1f6L, 0x23264464L, 0x64369ad2L, 0x59392f40L,
+ 0x0786fddfL, 0x3a89484dL, 0x7d9996fbL, 0x40962369L, 0xf3b82b97L, 0xceb79e05L, 0x89a740b3L, 0xb4a8f521L,
+ 0x34d8e58dL, 0x09d7501fL, 0x4ec78ea9L, 0x73c83b3bL, 0xc0e633c5L, 0xfde98657L, 0xbaf958e1L, 0x87f6ed73L,
+ 0xd9493fecL, 0xe4468a7eL, 0xa35654c8L, 0x9e59e15aL, 0x2d77e9a4L, 0x10785c36L, 0x57688280L, 0x6a673712L,
+ 0x5264d529L, 0x6f6b60bbL, 0x287bbe0dL, 0x15740b9fL, 0xa65a0361L, 0x9b55b6f3L, 0xdc456845L, 0xe14addd7L,
+ 0xbff50f48L, 0x82fabadaL, 0xc5ea646cL, 0xf8e5d1feL, 0x4bcbd900L, 0x76c46c92L, 0x31d4b224L, 0x0cdb07b6L,
+ 0x8cab171aL, 0xb1a4a288L, 0xf6b47c3eL, 0xcbbbc9acL, 0x7895c152L, 0x459a74c0L, 0x028aaa76L, 0x3f851fe4L,
+ 0x613acd7bL, 0x5c3578e9L, 0x1b25a65fL, 0x262a13cdL, 0x95041b33L, 0xa80baea1L, 0xef1b7017L, 0xd214c585L,
+ 0x9f1cb461L, 0xa21301f3L, 0xe503df45L, 0xd80c6ad7L, 0x6b226229L, 0x562dd7bbL, 0x113d090dL, 0x2c32bc9fL,
+ 0x728d6e00L, 0x4f82db92L, 0x08920524L, 0x359db0b6L, 0x86b3b848L, 0xbbbc0ddaL, 0xfcacd36cL, 0xc1a366feL,
+ 0x41d37652L, 0x7cdcc3c0L, 0x3bcc1d76L, 0x06c3a8e4L, 0xb5eda01aL, 0x88e21588L, 0xcff2cb3eL, 0xf2fd7eacL,
+ 0xac42ac33L, 0x914d19a1L, 0xd65dc717L, 0xeb527285L, 0x587c7a7bL, 0x6573cfe9L, 0x2263115fL, 0x1f6ca4cdL,
+ 0x276f46f6L, 0x1a60f364L, 0x5d702dd2L, 0x607f9840L, 0xd35190beL, 0xee5e252cL, 0xa94efb9aL, 0x94414e08L,
+ 0xcafe9c97L, 0xf7f12905L, 0xb0e1f7b3L, 0x8dee4221L, 0x3ec04adfL, 0x03cfff4dL, 0x44df21fbL, 0x79d09469L,
+ 0xf9a084c5L, 0xc4af3157L, 0x83bfefe1L, 0xbeb05a73L, 0x0d9e528dL, 0x3091e71fL, 0x778139a9L, 0x4a8e8c3bL,
+ 0x14315ea4L, 0x293eeb36L, 0x6e2e3580L, 0x53218012L, 0xe00f88ecL, 0xdd003d7eL, 0x9a10e3c8L, 0xa71f565aL,
+ },
+ {
+ 0x00000000L, 0xd1c2398dL, 0xa66805ebL, 0x77aa3c66L, 0x493c7d27L, 0x98fe44aaL, 0xef5478ccL, 0x3e964141L,
+ 0x9278fa4eL, 0x43bac3c3L, 0x3410ffa5L, 0xe5d2c628L, 0xdb448769L, 0x0a86bee4L, 0x7d2c8282L, 0xaceebb0fL,
+ 0x211d826dL, 0xf0dfbbe0L, 0x87758786L, 0x56b7be0bL, 0x6821ff4aL, 0xb9e3c6c7L, 0xce49faa1L, 0x1f8bc32cL,
+ 0xb3657823L, 0x62a741aeL, 0x150d7dc8L, 0xc4cf4445L, 0xfa590504L, 0x2b9b3c89L, 0x5c3100efL, 0x8df33962L,
+ 0x423b04daL, 0x93f93d57L, 0xe4530131L, 0x359138bcL, 0x0b0779fdL, 0xdac54070L, 0xad6f7c16L, 0x7cad459bL,
+ 0xd043fe94L, 0x0181c719L, 0x762bfb7fL, 0xa7e9c2f2L, 0x997f83b3L, 0x48bdba3eL, 0x3f178658L, 0xeed5bfd5L,
+ 0x632686b7L, 0xb2e4bf3aL, 0xc54e835cL, 0x148cbad1L, 0x2a1afb90L, 0xfbd8c21dL, 0x8c72fe7bL, 0x5db0c7f6L,
+ 0xf15e7cf9L, 0x209c4574L, 0x57367912L, 0x86f4409fL, 0xb86201deL, 0x69a03853L, 0x1e0a0435L, 0xcfc83db8L,
+ 0x847609b4L, 0x55b43039L, 0x221e0c5fL, 0xf3dc35d2L, 0xcd4a7493L, 0x1c884d1eL, 0x6b227178L, 0xbae048f5L,
+ 0x160ef3faL, 0xc7ccca77L, 0xb066f611L, 0x61a4cf9cL, 0x5f328eddL, 0x8ef0b750L, 0xf95a8b36L, 0x2898b2bbL,
+ 0xa56b8bd9L, 0x74a9b254L, 0x03038e32L, 0xd2c1b7bfL, 0xec57f6feL, 0x3d95cf73L, 0x4a3ff315L, 0x9bfdca98L,
+ 0x37137197L, 0xe6d1481aL, 0x917b747cL, 0x40b94df1L, 0x7e2f0cb0L, 0xafed353dL, 0xd847095bL, 0x098530d6L,
+ 0xc64d0d6eL, 0x178f34e3L, 0x60250885L, 0xb1e73108L, 0x8f717049L, 0x5eb349c4L, 0x291975a2L, 0xf8db4c2fL,
+ 0x5435f720L, 0x85f7ceadL, 0xf25df2cbL, 0x239fcb46L, 0x1d098a07L, 0xcccbb38aL, 0xbb618fecL, 0x6aa3b661L,
+ 0xe7508f03L, 0x3692b68eL, 0x41388ae8L, 0x90fab365L, 0xae6cf224L, 0x7faecba9L, 0x0804f7cfL, 0xd9c6ce42L,
+ 0x7528754dL, 0xa4ea4cc0L, 0xd34070a6L, 0x0282492bL, 0x3c14086aL, 0xedd631e7L, 0x9a7c0d81L, 0x4bbe340cL,
+ 0x0d006599L, 0xdcc25c14L, 0xab686072L, 0x7aaa59ffL, 0x443c18beL, 0x95fe2133L, 0xe2541d55L, 0x339624d8L,
+ 0x9f789fd7L, 0x4ebaa65aL, 0x39109a3cL, 0xe8d2a3b1L, 0xd644e2f0L, 0x0786db7dL, 0x702ce71bL, 0xa1eede96L,
+ 0x2c1de7f4L, 0xfddfde79L, 0x8a75e21fL, 0x5bb7db92L, 0x65219ad3L, 0xb4e3a35eL, 0xc3499f38L, 0x128ba6b5L,
+ 0xbe651dbaL, 0x6fa72437L, 0x180d1851L, 0xc9cf21dcL, 0xf759609dL, 0x269b5910L, 0x51316576L, 0x80f35cfbL,
+ 0x4f3b6143L, 0x9ef958ceL, 0xe95364a8L, 0x38915d25L, 0x06071c64L, 0xd7c525e9L, 0xa06f198fL, 0x71ad2002L,
+ 0xdd439b0dL, 0x0c81a280L, 0x7b2b9ee6L, 0xaae9a76bL, 0x947fe62aL, 0x45bddfa7L, 0x3217e3c1L, 0xe3d5da4cL,
+ 0x6e26e32eL, 0xbfe4daa3L, 0xc84ee6c5L, 0x198cdf48L, 0x271a9e09L, 0xf6d8a784L, 0x81729be2L, 0x50b0a26fL,
+ 0xfc5e1960L, 0x2d9c20edL, 0x5a361c8bL, 0x8bf42506L, 0xb5626447L, 0x64a05dcaL, 0x130a61acL, 0xc2c85821L,
+ 0x89766c2dL, 0x58b455a0L, 0x2f1e69c6L, 0xfedc504bL, 0xc04a110aL, 0x11882887L, 0x662214e1L, 0xb7e02d6cL,
+ 0x1b0e9663L, 0xcaccafeeL, 0xbd669388L, 0x6ca4aa05L, 0x5232eb44L, 0x83f0d2c9L, 0xf45aeeafL, 0x2598d722L,
+ 0xa86bee40L, 0x79a9d7cdL, 0x0e03ebabL, 0xdfc1d226L, 0xe1579367L, 0x3095aaeaL, 0x473f968cL, 0x96fdaf01L,
+ 0x3a13140eL, 0xebd12d83L, 0x9c7b11e5L, 0x4db92868L, 0x732f6929L, 0xa2ed50a4L, 0xd5476cc2L, 0x0485554fL,
+ 0xcb4d68f7L, 0x1a8f517aL, 0x6d256d1cL, 0xbce75491L, 0x827115d0L, 0x53b32c5dL, 0x2419103bL, 0xf5db29b6L,
+ 0x593592b9L, 0x88f7ab34L, 0xff5d9752L, 0x2e9faedfL, 0x1009ef9eL, 0xc1cbd613L, 0xb661ea75L, 0x67a3d3f8L,
+ 0xea50ea9aL, 0x3b92d317L, 0x4c38ef71L, 0x9dfad6fcL, 0xa36c97bdL, 0x72aeae30L, 0x05049256L, 0xd4c6abdbL,
+ 0x782810d4L, 0xa9ea2959L, 0xde40153fL, 0x0f822cb2L, 0x31146df3L, 0xe0d6547eL, 0x977c6818L, 0x46be5195L,
+ },
+ {
+ 0x00000000L, 0x1a00cb32L, 0x34019664L, 0x2e015d56L, 0x68032cc8L, 0x7203e7faL, 0x5c02baacL, 0x4602719eL,
+ 0xd0065990L, 0xca0692a2L, 0xe407cff4L, 0xfe0704c6L, 0xb8057558L, 0xa205be6aL, 0x8c04e33cL, 0x9604280eL,
+ 0xa5e0c5d1L, 0xbfe00ee3L, 0x91e153b5L, 0x8be19887L, 0xcde3e919L, 0xd7e3222bL, 0xf9e27f7dL, 0xe3e2b44fL,
+ 0x75e69c41L, 0x6fe65773L, 0x41e70a25L, 0x5be7c117L, 0x1de5b089L, 0x07e57bbbL, 0x29e426edL, 0x33e4eddfL,
+ 0x4e2dfd53L, 0x542d3661L, 0x7a2c6b37L, 0x602ca005L, 0x262ed19bL, 0x3c2e1aa9L, 0x122f47ffL, 0x082f8ccdL,
+ 0x9e2ba4c3L, 0x842b6ff1L, 0xaa2a32a7L, 0xb02af995L, 0xf628880bL, 0xec284339L, 0xc2291e6fL, 0xd829d55dL,
+ 0xebcd3882L, 0xf1cdf3b0L, 0xdfccaee6L, 0xc5cc65d4L, 0x83ce144aL, 0x99cedf78L, 0xb7cf822eL, 0xadcf491cL,
+ 0x3bcb6112L, 0x21cbaa20L, 0x0fcaf776L, 0x15ca3c44L, 0x53c84ddaL, 0x49c886e8L, 0x67c9dbbeL, 0x7dc9108cL,
+ 0x9c5bfaa6L, 0x865b3194L, 0xa85a6cc2L, 0xb25aa7f0L, 0xf458d66eL, 0xee581d5cL, 0xc059400aL, 0xda598b38L,
+ 0x4c5da336L, 0x565d6804L, 0x785c3552L, 0x625cfe60L, 0x245e8ffeL, 0x3e5e44ccL, 0x105f199aL, 0x0a5fd2a8L,
+ 0x39bb3f77L, 0x23bbf445L, 0x0dbaa913L, 0x17ba6221L, 0x51b813bfL, 0x4bb8d88dL, 0x65b985dbL, 0x7fb94ee9L,
+ 0xe9bd66e7L, 0xf3bdadd5L, 0xddbcf083L, 0xc7bc3bb1L, 0x81be4a2fL, 0x9bbe811dL, 0xb5bfdc4bL, 0xafbf1779L,
+ 0xd27607f5L, 0xc876ccc7L, 0xe6779191L, 0xfc775aa3L, 0xba752b3dL, 0xa075e00fL, 0x8e74bd59L, 0x9474766bL,
+ 0x02705e65L, 0x18709557L, 0x3671c801L, 0x2c710333L, 0x6a7372adL, 0x7073b99fL, 0x5e72e4c9L, 0x44722ffbL,
+ 0x7796c224L, 0x6d960916L, 0x43975440L, 0x59979f72L, 0x1f95eeecL, 0x059525deL, 0x2b947888L, 0x3194b3baL,
+ 0xa7909bb4L, 0xbd905086L, 0x93910dd0L, 0x8991c6e2L, 0xcf93b77cL, 0xd5937c4eL, 0xfb922118L, 0xe192ea2aL,
+ 0x3d5b83bdL, 0x275b488fL, 0x095a15d9L, 0x135adeebL, 0x5558af75L, 0x4f586447L, 0x61593911L, 0x7b59f223L,
+ 0xed5dda2dL, 0xf75d111fL, 0xd95c4c49L, 0xc35c877bL, 0x855ef6e5L, 0x9f5e3dd7L, 0xb15f6081L, 0xab5fabb3L,
+ 0x98bb466cL, 0x82bb8d5eL, 0xacbad008L, 0xb6ba1b3aL, 0xf0b86aa4L, 0xeab8a196L, 0xc4b9fcc0L, 0xdeb937f2L,
+ 0x48bd1ffcL, 0x52bdd4ceL, 0x7cbc8998L, 0x66bc42aaL, 0x20be3334L, 0x3abef806L, 0x14bfa550L, 0x0ebf6e62L,
+ 0x73767eeeL, 0x6976b5dcL, 0x4777e88aL, 0x5d7723b8L, 0x1b755226L, 0x01759914L, 0x2f74c442L, 0x35740f70L,
+ 0xa370277eL, 0xb970ec4cL, 0x9771b11aL, 0x8d717a28L, 0xcb730bb6L, 0xd173c084L, 0xff729dd2L, 0xe57256e0L,
+ 0xd696bb3fL, 0xcc96700dL, 0xe2972d5bL, 0xf897e669L, 0xbe9597f7L, 0xa4955cc5L, 0x8a940193L, 0x9094caa1L,
+ 0x0690e2afL, 0x1c90299dL, 0x329174cbL, 0x2891bff9L, 0x6e93ce67L, 0x74930555L, 0x5a925803L, 0x40929331L,
+ 0xa100791bL, 0xbb00b229L, 0x9501ef7fL, 0x8f01244dL, 0xc90355d3L, 0xd3039ee1L, 0xfd02c3b7L, 0xe7020885L,
+ 0x7106208bL, 0x6b06ebb9L, 0x4507b6efL, 0x5f077dddL, 0x19050c43L, 0x0305c771L, 0x2d049a27L, 0x37045115L,
+ 0x04e0bccaL, 0x1ee077f8L, 0x30e12aaeL, 0x2ae1e19cL, 0x6ce39002L, 0x76e35b30L, 0x58e20666L, 0x42e2cd54L,
+ 0xd4e6e55aL, 0xcee62e68L, 0xe0e7733eL, 0xfae7b80cL, 0xbce5c992L, 0xa6e502a0L, 0x88e45ff6L, 0x92e494c4L,
+ 0xef2d8448L, 0xf52d4f7aL, 0xdb2c122cL, 0xc12cd91eL, 0x872ea880L, 0x9d2e63b2L, 0xb32f3ee4L, 0xa92ff5d6L,
+ 0x3f2bddd8L, 0x252b16eaL, 0x0b2a4bbcL, 0x112a808eL, 0x5728f110L, 0x4d283a22L, 0x63296774L, 0x7929ac46L,
+ 0x4acd4199L, 0x50cd8aabL, 0x7eccd7fdL, 0x64cc1ccfL, 0x22ce6d51L, 0x38cea663L, 0x16cffb35L, 0x0ccf3007L,
+ 0x9acb1809L, 0x80cbd33bL, 0xaeca8e6dL, 0xb4ca455fL, 0xf2c834c1L, 0xe8c8fff3L, 0xc6c9a2a5L, 0xdcc96997L,
+ },
+ {
+ 0x00000000L, 0x7ab7077aL, 0xf56e0ef4L, 0x8fd9098eL, 0xef306b19L, 0x95876c63L, 0x1a5e65edL, 0x60e96297L,
+ 0xdb8ca0c3L, 0xa13ba7b9L, 0x2ee2ae37L, 0x5455a94dL, 0x34bccbdaL, 0x4e0bcca0L, 0xc1d2c52eL, 0xbb65c254L,
+ 0xb2f53777L, 0xc842300dL, 0x479b3983L, 0x3d2c3ef9L, 0x5dc55c6eL, 0x27725b14L, 0xa8ab529aL, 0xd21c55e0L,
+ 0x697997b4L, 0x13ce90ceL, 0x9c179940L, 0xe6a09e3aL, 0x8649fcadL, 0xfcfefbd7L, 0x7327f259L, 0x0990f523L,
+ 0x6006181fL, 0x1ab11f65L, 0x956816ebL, 0xefdf1191L, 0x8f367306L, 0xf581747cL, 0x7a587df2L, 0x00ef7a88L,
+ 0xbb8ab8dcL, 0xc13dbfa6L, 0x4ee4b628L, 0x3453b152L, 0x54bad3c5L, 0x2e0dd4bfL, 0xa1d4dd31L, 0xdb63da4bL,
+ 0xd2f32f68L, 0xa8442812L, 0x279d219cL, 0x5d2a26e6L, 0x3dc34471L, 0x4774430bL, 0xc8ad4a85L, 0xb21a4dffL,
+ 0x097f8fabL, 0x73c888d1L, 0xfc11815fL, 0x86a68625L, 0xe64fe4b2L, 0x9cf8e3c8L, 0x1321ea46L, 0x6996ed3cL,
+ 0xc00c303eL, 0xbabb3744L, 0x35623ecaL, 0x4fd539b0L, 0x2f3c5b27L, 0x558b5c5dL, 0xda5255d3L, 0xa0e552a9L,
+ 0x1b8090fdL, 0x61379787L, 0xeeee9e09L, 0x94599973L, 0xf4b0fbe4L, 0x8e07fc9eL, 0x01def510L, 0x7b69f26aL,
+ 0x72f90749L, 0x084e0033L, 0x879709bdL, 0xfd200ec7L, 0x9dc96c50L, 0xe77e6b2aL, 0x68a762a4L, 0x121065deL,
+ 0xa975a78aL, 0xd3c2a0f0L, 0x5c1ba97eL, 0x26acae04L, 0x4645cc93L, 0x3cf2cbe9L, 0xb32bc267L, 0xc99cc51dL,
+ 0xa00a2821L, 0xdabd2f5bL, 0x556426d5L, 0x2fd321afL, 0x4f3a4338L, 0x358d4442L, 0xba544dccL, 0xc0e34ab6L,
+ 0x7b8688e2L, 0x01318f98L, 0x8ee88616L, 0xf45f816cL, 0x94b6e3fbL, 0xee01e481L, 0x61d8ed0fL, 0x1b6fea75L,
+ 0x12ff1f56L, 0x6848182cL, 0xe79111a2L, 0x9d2616d8L, 0xfdcf744fL, 0x87787335L, 0x08a17abbL, 0x72167dc1L,
+ 0xc973bf95L, 0xb3c4b8efL, 0x3c1db161L, 0x46aab61bL, 0x2643d48cL, 0x5cf4d3f6L, 0xd32dda78L, 0xa99add02L,
+ 0x85f4168dL, 0xff4311f7L, 0x709a1879L, 0x0a2d1f03L, 0x6ac47d94L, 0x10737aeeL, 0x9faa7360L, 0xe51d741aL,
+ 0x5e78b64eL, 0x24cfb134L, 0xab16b8baL, 0xd1a1bfc0L, 0xb148dd57L, 0xcbffda2dL, 0x4426d3a3L, 0x3e91d4d9L,
+ 0x370121faL, 0x4db62680L, 0xc26f2f0eL, 0xb8d82874L, 0xd8314ae3L, 0xa2864d99L, 0x2d5f4417L, 0x57e8436dL,
+ 0xec8d8139L, 0x963a8643L, 0x19e38fcdL, 0x635488b7L, 0x03bdea20L, 0x790aed5aL, 0xf6d3e4d4L, 0x8c64e3aeL,
+ 0xe5f20e92L, 0x9f4509e8L, 0x109c0066L, 0x6a2b071cL, 0x0ac2658bL, 0x707562f1L, 0xffac6b7fL, 0x851b6c05L,
+ 0x3e7eae51L, 0x44c9a92bL, 0xcb10a0a5L, 0xb1a7a7dfL, 0xd14ec548L, 0xabf9c232L, 0x2420cbbcL, 0x5e97ccc6L,
+ 0x570739e5L, 0x2db03e9fL, 0xa2693711L, 0xd8de306bL, 0xb83752fcL, 0xc2805586L, 0x4d595c08L, 0x37ee5b72L,
+ 0x8c8b9926L, 0xf63c9e5cL, 0x79e597d2L, 0x035290a8L, 0x63bbf23fL, 0x190cf545L, 0x96d5fccbL, 0xec62fbb1L,
+ 0x45f826b3L, 0x3f4f21c9L, 0xb0962847L, 0xca212f3dL, 0xaac84daaL, 0xd07f4ad0L, 0x5fa6435eL, 0x25114424L,
+ 0x9e748670L, 0xe4c3810aL, 0x6b1a8884L, 0x11ad8ffeL, 0x7144ed69L, 0x0bf3ea13L, 0x842ae39dL, 0xfe9de4e7L,
+ 0xf70d11c4L, 0x8dba16beL, 0x02631f30L, 0x78d4184aL, 0x183d7addL, 0x628a7da7L, 0xed537429L, 0x97e47353L,
+ 0x2c81b107L, 0x5636b67dL, 0xd9efbff3L, 0xa358b889L, 0xc3b1da1eL, 0xb906dd64L, 0x36dfd4eaL, 0x4c68d390L,
+ 0x25fe3eacL, 0x5f4939d6L, 0xd0903058L, 0xaa273722L, 0xcace55b5L, 0xb07952cfL, 0x3fa05b41L, 0x45175c3bL,
+ 0xfe729e6fL, 0x84c59915L, 0x0b1c909bL, 0x71ab97e1L, 0x1142f576L, 0x6bf5f20cL, 0xe42cfb82L, 0x9e9bfcf8L,
+ 0x970b09dbL, 0xedbc0ea1L, 0x6265072fL, 0x18d20055L, 0x783b62c2L, 0x028c65b8L, 0x8d556c36L, 0xf7e26b4cL,
+ 0x4c87a918L, 0x3630ae62L, 0xb9e9a7ecL, 0xc35ea096L, 0xa3b7c201L, 0xd900c57bL, 0x56d9ccf5L, 0x2c6ecb8fL,
+ },
+ {
+ 0x00000000L, 0xc5670b91L, 0x8f2261d3L, 0x4a456a42L, 0x1ba8b557L, 0xdecfbec6L, 0x948ad484L, 0x51eddf15L,
+ 0x37516aaeL, 0xf236613fL, 0xb8730b7dL, 0x7d1400ecL, 0x2cf9dff9L, 0xe99ed468L, 0xa3dbbe2aL, 0x66bcb5bbL,
+ 0x6ea2d55cL, 0xabc5decdL, 0xe180b48fL, 0x24e7bf1eL, 0x750a600bL, 0xb06d6b9aL, 0xfa2801d8L, 0x3f4f0a49L,
+ 0x59f3bff2L, 0x9c94b463L, 0xd6d1de21L, 0x13b6d5b0L, 0x425b0aa5L, 0x873c0134L, 0xcd796b76L, 0x081e60e7L,
+ 0xdd45aab8L, 0x1822a129L, 0x5267cb6bL, 0x9700c0faL, 0xc6ed1fefL, 0x038a147eL, 0x49cf7e3cL, 0x8ca875adL,
+ 0xea14c016L, 0x2f73cb87L, 0x6536a1c5L, 0xa051aa54L, 0xf1bc7541L, 0x34db7ed0L, 0x7e9e1492L, 0xbbf91f03L,
+ 0xb3e77fe4L, 0x76807475L, 0x3cc51e37L, 0xf9a215a6L, 0xa84fcab3L, 0x6d28c122L, 0x276dab60L, 0xe20aa0f1L,
+ 0x84b6154aL, 0x41d11edbL, 0x0b947499L, 0xcef37f08L, 0x9f1ea01dL, 0x5a79ab8cL, 0x103cc1ceL, 0xd55bca5fL,
+ 0xbf672381L, 0x7a002810L, 0x30454252L, 0xf52249c3L, 0xa4cf96d6L, 0x61a89d47L, 0x2bedf705L, 0xee8afc94L,
+ 0x8836492fL, 0x4d5142beL, 0x071428fcL, 0xc273236dL, 0x939efc78L, 0x56f9f7e9L, 0x1cbc9dabL, 0xd9db963aL,
+ 0xd1c5f6ddL, 0x14a2fd4cL, 0x5ee7970eL, 0x9b809c9fL, 0xca6d438aL, 0x0f0a481bL, 0x454f2259L, 0x802829c8L,
+ 0xe6949c73L, 0x23f397e2L, 0x69b6fda0L, 0xacd1f631L, 0xfd3c2924L, 0x385b22b5L, 0x721e48f7L, 0xb7794366L,
+ 0x62228939L, 0xa74582a8L, 0xed00e8eaL, 0x2867e37bL, 0x798a3c6eL, 0xbced37ffL, 0xf6a85dbdL, 0x33cf562cL,
+ 0x5573e397L, 0x9014e806L, 0xda518244L, 0x1f3689d5L, 0x4edb56c0L, 0x8bbc5d51L, 0xc1f93713L, 0x049e3c82L,
+ 0x0c805c65L, 0xc9e757f4L, 0x83a23db6L, 0x46c53627L, 0x1728e932L, 0xd24fe2a3L, 0x980a88e1L, 0x5d6d8370L,
+ 0x3bd136cbL, 0xfeb63d5aL, 0xb4f35718L, 0x71945c89L, 0x2079839cL, 0xe51e880dL, 0xaf5be24fL, 0x6a3ce9deL,
+ 0x7b2231f3L, 0xbe453a62L, 0xf4005020L, 0x31675bb1L, 0x608a84a4L, 0xa5ed8f35L, 0xefa8e577L, 0x2acfeee6L,
+ 0x4c735b5dL, 0x891450ccL, 0xc3513a8eL, 0x0636311fL, 0x57dbee0aL, 0x92bce59bL, 0xd8f98fd9L, 0x1d9e8448L,
+ 0x1580e4afL, 0xd0e7ef3eL, 0x9aa2857cL, 0x5fc58eedL, 0x0e2851f8L, 0xcb4f5a69L, 0x810a302bL, 0x446d3bbaL,
+ 0x22d18e01L, 0xe7b68590L, 0xadf3efd2L, 0x6894e443L, 0x39793b56L, 0xfc1e30c7L, 0xb65b5a85L, 0x733c5114L,
+ 0xa6679b4bL, 0x630090daL, 0x2945fa98L, 0xec22f109L, 0xbdcf2e1cL, 0x78a8258dL, 0x32ed4fcfL, 0xf78a445eL,
+ 0x9136f1e5L, 0x5451fa74L, 0x1e149036L, 0xdb739ba7L, 0x8a9e44b2L, 0x4ff94f23L, 0x05bc2561L, 0xc0db2ef0L,
+ 0xc8c54e17L, 0x0da24586L, 0x47e72fc4L, 0x82802455L, 0xd36dfb40L, 0x160af0d1L, 0x5c4f9a93L, 0x99289102L,
+ 0xff9424b9L, 0x3af32f28L, 0x70b6456aL, 0xb5d14efbL, 0xe43c91eeL, 0x215b9a7fL, 0x6b1ef03dL, 0xae79fbacL,
+ 0xc4451272L, 0x012219e3L, 0x4b6773a1L, 0x8e007830L, 0xdfeda725L, 0x1a8aacb4L, 0x50cfc6f6L, 0x95a8cd67L,
+ 0xf31478dcL, 0x3673734dL, 0x7c36190fL, 0xb951129eL, 0xe8bccd8bL, 0x2ddbc61aL, 0x679eac58L, 0xa2f9a7c9L,
+ 0xaae7c72eL, 0x6f80ccbfL, 0x25c5a6fdL, 0xe0a2ad6cL, 0xb14f7279L, 0x742879e8L, 0x3e6d13aaL, 0xfb0a183bL,
+ 0x9db6ad80L, 0x58d1a611L, 0x1294cc53L, 0xd7f3c7c2L, 0x861e18d7L, 0x43791346L, 0x093c7904L, 0xcc5b7295L,
+ 0x1900b8caL, 0xdc67b35bL, 0x9622d919L, 0x5345d288L, 0x02a80d9dL, 0xc7cf060cL, 0x8d8a6c4eL, 0x48ed67dfL,
+ 0x2e51d264L, 0xeb36d9f5L, 0xa173b3b7L, 0x6414b826L, 0x35f96733L, 0xf09e6ca2L, 0xbadb06e0L, 0x7fbc0d71L,
+ 0x77a26d96L, 0xb2c56607L, 0xf8800c45L, 0x3de707d4L, 0x6c0ad8c1L, 0xa96dd350L, 0xe328b912L, 0x264fb283L,
+ 0x40f30738L, 0x85940ca9L, 0xcfd166ebL, 0x0ab66d7aL, 0x5b5bb26fL, 0x9e3cb9feL, 0xd479d3bcL, 0x111ed82dL,
+ },
+ {
+ 0x00000000L, 0xf64463e6L, 0xe964b13dL, 0x1f20d2dbL, 0xd725148bL, 0x2161776dL, 0x3e41a5b6L, 0xc805c650L,
+ 0xaba65fe7L, 0x5de23c01L, 0x42c2eedaL, 0xb4868d3cL, 0x7c834b6cL, 0x8ac7288aL, 0x95e7fa51L, 0x63a399b7L,
+ 0x52a0c93fL, 0xa4e4aad9L, 0xbbc47802L, 0x4d801be4L, 0x8585ddb4L, 0x73c1be52L, 0x6ce16c89L, 0x9aa50f6fL,
+ 0xf90696d8L, 0x0f42f53eL, 0x106227e5L, 0xe6264403L, 0x2e238253L, 0xd867e1b5L, 0xc747336eL, 0x31035088L,
+ 0xa541927eL, 0x5305f198L, 0x4c252343L, 0xba6140a5L, 0x726486f5L, 0x8420e513L, 0x9b0037c8L, 0x6d44542eL,
+ 0x0ee7cd99L, 0xf8a3ae7fL, 0xe7837ca4L, 0x11c71f42L, 0xd9c2d912L, 0x2f86baf4L, 0x30a6682fL, 0xc6e20bc9L,
+ 0xf7e15b41L, 0x01a538a7L, 0x1e85ea7cL, 0xe8c1899aL, 0x20c44fcaL, 0xd6802c2cL, 0xc9a0fef7L, 0x3fe49d11L,
+ 0x5c4704a6L, 0xaa036740L, 0xb523b59bL, 0x4367d67dL, 0x8b62102dL, 0x7d2673cbL, 0x6206a110L, 0x9442c2f6L,
+ 0x4f6f520dL, 0xb92b31ebL, 0xa60be330L, 0x504f80d6L, 0x984a4686L, 0x6e0e2560L, 0x712ef7bbL, 0x876a945dL,
+ 0xe4c90deaL, 0x128d6e0cL, 0x0dadbcd7L, 0xfbe9df31L, 0x33ec1961L, 0xc5a87a87L, 0xda88a85cL, 0x2ccccbbaL,
+ 0x1dcf9b32L, 0xeb8bf8d4L, 0xf4ab2a0fL, 0x02ef49e9L, 0xcaea8fb9L, 0x3caeec5fL, 0x238e3e84L, 0xd5ca5d62L,
+ 0xb669c4d5L, 0x402da733L, 0x5f0d75e8L, 0xa949160eL, 0x614cd05eL, 0x9708b3b8L, 0x88286163L, 0x7e6c0285L,
+ 0xea2ec073L, 0x1c6aa395L, 0x034a714eL, 0xf50e12a8L, 0x3d0bd4f8L, 0xcb4fb71eL, 0xd46f65c5L, 0x222b0623L,
+ 0x41889f94L, 0xb7ccfc72L, 0xa8ec2ea9L, 0x5ea84d4fL, 0x96ad8b1fL, 0x60e9e8f9L, 0x7fc93a22L, 0x898d59c4L,
+ 0xb88e094cL, 0x4eca6aaaL, 0x51eab871L, 0xa7aedb97L, 0x6fab1dc7L, 0x99ef7e21L, 0x86cfacfaL, 0x708bcf1cL,
+ 0x132856abL, 0xe56c354dL, 0xfa4ce796L, 0x0c088470L, 0xc40d4220L, 0x324921c6L, 0x2d69f31dL, 0xdb2d90fbL,
+ 0x9edea41aL, 0x689ac7fcL, 0x77ba1527L, 0x81fe76c1L, 0x49fbb091L, 0xbfbfd377L, 0xa09f01acL, 0x56db624aL,
+ 0x3578fbfdL, 0xc33c981bL, 0xdc1c4ac0L, 0x2a582926L, 0xe25def76L, 0x14198c90L, 0x0b395e4bL, 0xfd7d3dadL,
+ 0xcc7e6d25L, 0x3a3a0ec3L, 0x251adc18L, 0xd35ebffeL, 0x1b5b79aeL, 0xed1f1a48L, 0xf23fc893L, 0x047bab75L,
+ 0x67d832c2L, 0x919c5124L, 0x8ebc83ffL, 0x78f8e019L, 0xb0fd2649L, 0x46b945afL, 0x59999774L, 0xafddf492L,
+ 0x3b9f3664L, 0xcddb5582L, 0xd2fb8759L, 0x24bfe4bfL, 0xecba22efL, 0x1afe4109L, 0x05de93d2L, 0xf39af034L,
+ 0x90396983L, 0x667d0a65L, 0x795dd8beL, 0x8f19bb58L, 0x471c7d08L, 0xb1581eeeL, 0xae78cc35L, 0x583cafd3L,
+ 0x693fff5bL, 0x9f7b9cbdL, 0x805b4e66L, 0x761f2d80L, 0xbe1aebd0L, 0x485e8836L, 0x577e5aedL, 0xa13a390bL,
+ 0xc299a0bcL, 0x34ddc35aL, 0x2bfd1181L, 0xddb97267L, 0x15bcb437L, 0xe3f8d7d1L, 0xfcd8050aL, 0x0a9c66ecL,
+ 0xd1b1f617L, 0x27f595f1L, 0x38d5472aL, 0xce9124ccL, 0x0694e29cL, 0xf0d0817aL, 0xeff053a1L, 0x19b43047L,
+ 0x7a17a9f0L, 0x8c53ca16L, 0x937318cdL, 0x65377b2bL, 0xad32bd7bL, 0x5b76de9dL, 0x44560c46L, 0xb2126fa0L,
+ 0x83113f28L, 0x75555cceL, 0x6a758e15L, 0x9c31edf3L, 0x54342ba3L, 0xa2704845L, 0xbd509a9eL, 0x4b14f978L,
+ 0x28b760cfL, 0xdef30329L, 0xc1d3d1f2L, 0x3797b214L, 0xff927444L, 0x09d617a2L, 0x16f6c579L, 0xe0b2a69fL,
+ 0x74f06469L, 0x82b4078fL, 0x9d94d554L, 0x6bd0b6b2L, 0xa3d570e2L, 0x55911304L, 0x4ab1c1dfL, 0xbcf5a239L,
+ 0xdf563b8eL, 0x29125868L, 0x36328ab3L, 0xc076e955L, 0x08732f05L, 0xfe374ce3L, 0xe1179e38L, 0x1753fddeL,
+ 0x2650ad56L, 0xd014ceb0L, 0xcf341c6bL, 0x39707f8dL, 0xf175b9ddL, 0x0731da3bL, 0x181108e0L, 0xee556b06L,
+ 0x8df6f2b1L, 0x7bb29157L, 0x6492438cL, 0x92d6206aL, 0x5ad3e63aL, 0xac9785dcL, 0xb3b75707L, 0x45f334e1L,
+ },
+ {
+ 0x00000000L, 0x38513ec5L, 0x70a27d8aL, 0x48f3434fL, 0xe144fb14L, 0xd915c5d1L, 0x91e6869eL, 0xa9b7b85bL,
+ 0xc76580d9L, 0xff34be1cL, 0xb7c7fd53L, 0x8f96c396L, 0x26217bcdL, 0x1e704508L, 0x56830647L, 0x6ed23882L,
+ 0x8b277743L, 0xb3764986L, 0xfb850ac9L, 0xc3d4340cL, 0x6a638c57L, 0x5232b292L, 0x1ac1f1ddL, 0x2290cf18L,
+ 0x4c42f79aL, 0x7413c95fL, 0x3ce08a10L, 0x04b1b4d5L, 0xad060c8eL, 0x9557324bL, 0xdda47104L, 0xe5f54fc1L,
+ 0x13a29877L, 0x2bf3a6b2L, 0x6300e5fdL, 0x5b51db38L, 0xf2e66363L, 0xcab75da6L, 0x82441ee9L, 0xba15202cL,
+ 0xd4c718aeL, 0xec96266bL, 0xa4656524L, 0x9c345be1L, 0x3583e3baL, 0x0dd2dd7fL, 0x45219e30L, 0x7d70a0f5L,
+ 0x9885ef34L, 0xa0d4d1f1L, 0xe82792beL, 0xd076ac7bL, 0x79c11420L, 0x41902ae5L, 0x096369aaL, 0x3132576fL,
+ 0x5fe06fedL, 0x67b15128L, 0x2f421267L, 0x17132ca2L, 0xbea494f9L, 0x86f5aa3cL, 0xce06e973L, 0xf657d7b6L,
+ 0x274530eeL, 0x1f140e2bL, 0x57e74d64L, 0x6fb673a1L, 0xc601cbfaL, 0xfe50f53fL, 0xb6a3b670L, 0x8ef288b5L,
+ 0xe020b037L, 0xd8718ef2L, 0x9082cdbdL, 0xa8d3f378L, 0x01644b23L, 0x393575e6L, 0x71c636a9L, 0x4997086cL,
+ 0xac6247adL, 0x94337968L, 0xdcc03a27L, 0xe49104e2L, 0x4d26bcb9L, 0x7577827cL, 0x3d84c133L, 0x05d5fff6L,
+ 0x6b07c774L, 0x5356f9b1L, 0x1ba5bafeL, 0x23f4843bL, 0x8a433c60L, 0xb21202a5L, 0xfae141eaL, 0xc2b07f2fL,
+ 0x34e7a899L, 0x0cb6965cL, 0x4445d513L, 0x7c14ebd6L, 0xd5a3538dL, 0xedf26d48L, 0xa5012e07L, 0x9d5010c2L,
+ 0xf3822840L, 0xcbd31685L, 0x832055caL, 0xbb716b0fL, 0x12c6d354L, 0x2a97ed91L, 0x6264aedeL, 0x5a35901bL,
+ 0xbfc0dfdaL, 0x8791e11fL, 0xcf62a250L, 0xf7339c95L, 0x5e8424ceL, 0x66d51a0bL, 0x2e265944L, 0x16776781L,
+ 0x78a55f03L, 0x40f461c6L, 0x08072289L, 0x30561c4cL, 0x99e1a417L, 0xa1b09ad2L, 0xe943d99dL, 0xd112e758L,
+ 0x4e8a61dcL, 0x76db5f19L, 0x3e281c56L, 0x06792293L, 0xafce9ac8L, 0x979fa40dL, 0xdf6ce742L, 0xe73dd987L,
+ 0x89efe105L, 0xb1bedfc0L, 0xf94d9c8fL, 0xc11ca24aL, 0x68ab1a11L, 0x50fa24d4L, 0x1809679bL, 0x2058595eL,
+ 0xc5ad169fL, 0xfdfc285aL, 0xb50f6b15L, 0x8d5e55d0L, 0x24e9ed8bL, 0x1cb8d34eL, 0x544b9001L, 0x6c1aaec4L,
+ 0x02c89646L, 0x3a99a883L, 0x726aebccL, 0x4a3bd509L, 0xe38c6d52L, 0xdbdd5397L, 0x932e10d8L, 0xab7f2e1dL,
+ 0x5d28f9abL, 0x6579c76eL, 0x2d8a8421L, 0x15dbbae4L, 0xbc6c02bfL, 0x843d3c7aL, 0xccce7f35L, 0xf49f41f0L,
+ 0x9a4d7972L, 0xa21c47b7L, 0xeaef04f8L, 0xd2be3a3dL, 0x7b098266L, 0x4358bca3L, 0x0babffecL, 0x33fac129L,
+ 0xd60f8ee8L, 0xee5eb02dL, 0xa6adf362L, 0x9efccda7L, 0x374b75fcL, 0x0f1a4b39L, 0x47e90876L, 0x7fb836b3L,
+ 0x116a0e31L, 0x293b30f4L, 0x61c873bbL, 0x59994d7eL, 0xf02ef525L, 0xc87fcbe0L, 0x808c88afL, 0xb8ddb66aL,
+ 0x69cf5132L, 0x519e6ff7L, 0x196d2cb8L, 0x213c127dL, 0x888baa26L, 0xb0da94e3L, 0xf829d7acL, 0xc078e969L,
+ 0xaeaad1ebL, 0x96fbef2eL, 0xde08ac61L, 0xe65992a4L, 0x4fee2affL, 0x77bf143aL, 0x3f4c5775L, 0x071d69b0L,
+ 0xe2e82671L, 0xdab918b4L, 0x924a5bfbL, 0xaa1b653eL, 0x03acdd65L, 0x3bfde3a0L, 0x730ea0efL, 0x4b5f9e2aL,
+ 0x258da6a8L, 0x1ddc986dL, 0x552fdb22L, 0x6d7ee5e7L, 0xc4c95dbcL, 0xfc986379L, 0xb46b2036L, 0x8c3a1ef3L,
+ 0x7a6dc945L, 0x423cf780L, 0x0acfb4cfL, 0x329e8a0aL, 0x9b293251L, 0xa3780c94L, 0xeb8b4fdbL, 0xd3da711eL,
+ 0xbd08499cL, 0x85597759L, 0xcdaa3416L, 0xf5fb0ad3L, 0x5c4cb288L, 0x641d8c4dL, 0x2ceecf02L, 0x14bff1c7L,
+ 0xf14abe06L, 0xc91b80c3L, 0x81e8c38cL, 0xb9b9fd49L, 0x100e4512L, 0x285f7bd7L, 0x60ac3898L, 0x58fd065dL,
+ 0x362f3edfL, 0x0e7e001aL, 0x468d4355L, 0x7edc7d90L, 0xd76bc5cbL, 0xef3afb0eL, 0xa7c9b841L, 0x9f988684L,
+ },
+ {
+ 0x00000000L, 0x9d14c3b8L, 0x3fc5f181L, 0xa2d13239L, 0x7f8be302L, 0xe29f20baL, 0x404e1283L, 0xdd5ad13bL,
+ 0xff17c604L, 0x620305bcL, 0xc0d23785L, 0x5dc6f43dL, 0x809c2506L, 0x1d88e6beL, 0xbf59d487L, 0x224d173fL,
+ 0xfbc3faf9L, 0x66d73941L, 0xc4060b78L, 0x5912c8c0L, 0x844819fbL, 0x195cda43L, 0xbb8de87aL, 0x26992bc2L,
+ 0x04d43cfdL, 0x99c0ff45L, 0x3b11cd7cL, 0xa6050ec4L, 0x7b5fdfffL, 0xe64b1c47L, 0x449a2e7eL, 0xd98eedc6L,
+ 0xf26b8303L, 0x6f7f40bbL, 0xcdae7282L, 0x50bab13aL, 0x8de06001L, 0x10f4a3b9L, 0xb2259180L, 0x2f315238L,
+ 0x0d7c4507L, 0x906886bfL, 0x32b9b486L, 0xafad773eL, 0x72f7a605L, 0xefe365bdL, 0x4d325784L, 0xd026943cL,
+ 0x09a879faL, 0x94bcba42L, 0x366d887bL, 0xab794bc3L, 0x76239af8L, 0xeb375940L, 0x49e66b79L, 0xd4f2a8c1L,
+ 0xf6bfbffeL, 0x6bab7c46L, 0xc97a4e7fL, 0x546e8dc7L, 0x89345cfcL, 0x14209f44L, 0xb6f1ad7dL, 0x2be56ec5L,
+ 0xe13b70f7L, 0x7c2fb34fL, 0xdefe8176L, 0x43ea42ceL, 0x9eb093f5L, 0x03a4504dL, 0xa1756274L, 0x3c61a1ccL,
+ 0x1e2cb6f3L, 0x8338754bL, 0x21e94772L, 0xbcfd84caL, 0x61a755f1L, 0xfcb39649L, 0x5e62a470L, 0xc37667c8L,
+ 0x1af88a0eL, 0x87ec49b6L, 0x253d7b8fL, 0xb829b837L, 0x6573690cL, 0xf867aab4L, 0x5ab6988dL, 0xc7a25b35L,
+ 0xe5ef4c0aL, 0x78fb8fb2L, 0xda2abd8bL, 0x473e7e33L, 0x9a64af08L, 0x07706cb0L, 0xa5a15e89L, 0x38b59d31L,
+ 0x1350f3f4L, 0x8e44304cL, 0x2c950275L, 0xb181c1cdL, 0x6cdb10f6L, 0xf1cfd34eL, 0x531ee177L, 0xce0a22cfL,
+ 0xec4735f0L, 0x7153f648L, 0xd382c471L, 0x4e9607c9L, 0x93ccd6f2L, 0x0ed8154aL, 0xac092773L, 0x311de4cbL,
+ 0xe893090dL, 0x7587cab5L, 0xd756f88cL, 0x4a423b34L, 0x9718ea0fL, 0x0a0c29b7L, 0xa8dd1b8eL, 0x35c9d836L,
+ 0x1784cf09L, 0x8a900cb1L, 0x28413e88L, 0xb555fd30L, 0x680f2c0bL, 0xf51befb3L, 0x57cadd8aL, 0xcade1e32L,
+ 0xc79a971fL, 0x5a8e54a7L, 0xf85f669eL, 0x654ba526L, 0xb811741dL, 0x2505b7a5L, 0x87d4859cL, 0x1ac04624L,
+ 0x388d511bL, 0xa59992a3L, 0x0748a09aL, 0x9a5c6322L, 0x4706b219L, 0xda1271a1L, 0x78c34398L, 0xe5d78020L,
+ 0x3c596de6L, 0xa14dae5eL, 0x039c9c67L, 0x9e885fdfL, 0x43d28ee4L, 0xdec64d5cL, 0x7c177f65L, 0xe103bcddL,
+ 0xc34eabe2L, 0x5e5a685aL, 0xfc8b5a63L, 0x619f99dbL, 0xbcc548e0L, 0x21d18b58L, 0x8300b961L, 0x1e147ad9L,
+ 0x35f1141cL, 0xa8e5d7a4L, 0x0a34e59dL, 0x97202625L, 0x4a7af71eL, 0xd76e34a6L, 0x75bf069fL, 0xe8abc527L,
+ 0xcae6d218L, 0x57f211a0L, 0xf5232399L, 0x6837e021L, 0xb56d311aL, 0x2879f2a2L, 0x8aa8c09bL, 0x17bc0323L,
+ 0xce32eee5L, 0x53262d5dL, 0xf1f71f64L, 0x6ce3dcdcL, 0xb1b90de7L, 0x2cadce5fL, 0x8e7cfc66L, 0x13683fdeL,
+ 0x312528e1L, 0xac31eb59L, 0x0ee0d960L, 0x93f41ad8L, 0x4eaecbe3L, 0xd3ba085bL, 0x716b3a62L, 0xec7ff9daL,
+ 0x26a1e7e8L, 0xbbb52450L, 0x19641669L, 0x8470d5d1L, 0x592a04eaL, 0xc43ec752L, 0x66eff56bL, 0xfbfb36d3L,
+ 0xd9b621ecL, 0x44a2e254L, 0xe673d06dL, 0x7b6713d5L, 0xa63dc2eeL, 0x3b290156L, 0x99f8336fL, 0x04ecf0d7L,
+ 0xdd621d11L, 0x4076dea9L, 0xe2a7ec90L, 0x7fb32f28L, 0xa2e9fe13L, 0x3ffd3dabL, 0x9d2c0f92L, 0x0038cc2aL,
+ 0x2275db15L, 0xbf6118adL, 0x1db02a94L, 0x80a4e92cL, 0x5dfe3817L, 0xc0eafbafL, 0x623bc996L, 0xff2f0a2eL,
+ 0xd4ca64ebL, 0x49dea753L, 0xeb0f956aL, 0x761b56d2L, 0xab4187e9L, 0x36554451L, 0x94847668L, 0x0990b5d0L,
+ 0x2bdda2efL, 0xb6c96157L, 0x1418536eL, 0x890c90d6L, 0x545641edL, 0xc9428255L, 0x6b93b06cL, 0xf68773d4L,
+ 0x2f099e12L, 0xb21d5daaL, 0x10cc6f93L, 0x8dd8ac2bL, 0x50827d10L, 0xcd96bea8L, 0x6f478c91L, 0xf2534f29L,
+ 0xd01e5816L, 0x4d0a9baeL, 0xefdba997L, 0x72cf6a2fL, 0xaf95bb14L, 0x328178acL, 0x90504a95L, 0x0d44892dL,
+ },
+};
+
 /**
  * crc32c - recompute the CRC for the data buffer
  * @crc - previous CRC value
@@ -77,3 +489,97 @@ uint32_t crc32c(uint32_t crc, uint8_t const *buffer, size_t len)
 		crc = crc32c_byte(crc, *buffer++);
 	return crc;
 }
+
+static inline uint32_t
+crc32c_load_be(const uint8_t *p) {
+	return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+		((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+/* one register write, through the pair tables */
+static inline uint32_t
+crc32c_word_lut(uint32_t crc, uint32_t val) {
+	const uint32_t x = crc ^ val;
+	return crc32c_table_words[4][x & 0xFF] ^
+		crc32c_table_words[5][(x >> 8) & 0xFF] ^
+		crc32c_table_words[6][(x >> 16) & 0xFF] ^
+		crc32c_table_words[7][x >> 24];
+}
+
+static uint32_t
+crc32c_words_lut(uint32_t crc, const uint8_t *words, size_t nwords,
+		 uint8_t addr)
+{
+	const uint32_t k = crc32c_table_addr5[addr & 0x1F];
+	/* the address of the first write, shifted through the second */
+	const uint32_t k2 = crc32c_word_lut(k, 0) ^ k;
+
+	for (; nwords >= 2; nwords -= 2, words += 8) {
+		const uint32_t x = crc ^ crc32c_load_be(words);
+		const uint32_t y = crc32c_load_be(words + 4);
+		crc = crc32c_table_words[0][x & 0xFF] ^
+			crc32c_table_words[1][(x >> 8) & 0xFF] ^
+			crc32c_table_words[2][(x >> 16) & 0xFF] ^
+			crc32c_table_words[3][x >> 24] ^
+			crc32c_word_lut(0, y) ^ k2;
+	}
+
+	if (nwords)
+		crc = crc32c_word_lut(crc, crc32c_load_be(words)) ^ k;
+
+	return crc;
+}
+
+#ifdef CRC32C_HAVE_SSE42
+
+/* The crc32 instruction shifts the CRC through 32 or 64 bits of data;
+   the remaining 5 or 10 bits go through the tables. */
+
+__attribute__((target("sse4.2"))) static inline uint32_t
+crc32c_word_sse42(uint32_t crc, uint32_t val) {
+	crc = __builtin_ia32_crc32si(crc, val);
+	return (crc >> 5) ^ crc32c_table_addr5[crc & 0x1F];
+}
+
+__attribute__((target("sse4.2"))) static uint32_t
+crc32c_words_sse42(uint32_t crc, const uint8_t *words, size_t nwords,
+		   uint8_t addr)
+{
+	const uint32_t k = crc32c_table_addr5[addr & 0x1F];
+	const uint32_t k2 = crc32c_word_sse42(k, 0) ^ k;
+
+	for (; nwords >= 2; nwords -= 2, words += 8) {
+		/* the second word does not depend on the running CRC */
+		const uint32_t y = crc32c_word_sse42(0, crc32c_load_be(words + 4));
+		const uint32_t x = (uint32_t)
+			__builtin_ia32_crc32di(0, crc ^ crc32c_load_be(words));
+		crc = (x >> 10) ^ crc32c_table_shift10[x & 0x3FF] ^ y ^ k2;
+	}
+
+	if (nwords)
+		crc = crc32c_word_sse42(crc, crc32c_load_be(words)) ^ k;
+
+	return crc;
+}
+
+#endif /* CRC32C_HAVE_SSE42 */
+
+/**
+ * crc32c_words - update the CRC with a series of register writes
+ * @crc - previous CRC value
+ * @words - the words written, big-endian as in the bitstream
+ * @nwords - number of words
+ * @addr - address of the register written
+ *
+ * This is equivalent to four crc32c_byte and one crc32c_addr5 per
+ * word, going through two words at a time.
+ */
+uint32_t crc32c_words(uint32_t crc, const uint8_t *words, size_t nwords,
+		      uint8_t addr)
+{
+#ifdef CRC32C_HAVE_SSE42
+	if (__builtin_cpu_supports("sse4.2"))
+		return crc32c_words_sse42(crc, words, nwords, addr);
+#endif
+	return crc32c_words_lut(crc, words, nwords, addr);
+}
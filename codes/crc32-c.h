@@ -32,8 +32,12 @@
 
 extern const uint32_t crc32c_table[256];
 extern const uint32_t crc32c_table_addr5[32];
+extern const uint32_t crc32c_table_shift10[1024];
+extern const uint32_t crc32c_table_words[8][256];
 
 extern uint32_t crc32c(uint32_t crc, const uint8_t *buffer, size_t len);
+extern uint32_t crc32c_words(uint32_t crc, const uint8_t *words, size_t nwords,
+			     uint8_t addr);
 
 /* Uses the lowest bit of the bit argument */
 static inline uint32_t
@@ -23,6 +23,7 @@
 
 #include <glib.h>
 #include <stdint.h>
+#include <string.h>
 #include "xhamming.h"
 
 #define HCODE_STAIRCASE 320
@@ -31,21 +32,14 @@
 #define HCODE_END       1312
 #define PARITY_BIT     (1<<11)
 
-/*
- * XXX possibly not endian-safe
- */
-
-static int
-get_bit(const unsigned char *data, unsigned bit) {
-  const uint32_t *u32_data = (const void *) data;
-  unsigned u32_offset = bit >> 5;
-  unsigned bit_offset = bit & 0x1F;
-  guint32  val = GUINT32_FROM_BE(u32_data[u32_offset]);
-  int got = (val >> bit_offset) & 1;
-  return got;
-}
+#define HCODE_WORDS    (HCODE_END / 32)
+#define HCODE_BYTES    (HCODE_END / 8)
 
 /*
+ * The code is linear in the frame bits: each bit set in the frame xors
+ * a fixed value into the code. This gives the value for a given bit,
+ * the bits being numbered from the LSB of each big-endian word.
+ *
  * This is for standard frames -- routing mainly.
  *
  * Obviously frames with bits that can change, such as RAM data, DistRAM
@@ -54,45 +48,78 @@ get_bit(const unsigned char *data, unsigned bit) {
  */
 
 static unsigned
-hamming_compute(const unsigned char *data) {
-  unsigned bit, xored, hcode = 0;
-
-  /* iterate dumbly over the bits */
-  xored = 704 + PARITY_BIT;
-  for (bit = 0; bit < HCODE_STAIRCASE; bit++) {
-    if (get_bit(data, bit))
-      hcode ^= xored;
-    xored++;
-  }
-
-  xored |= 32;
-  for (bit = HCODE_STAIRCASE; bit < HCODE_GAP_START; bit++) {
-    if (get_bit(data, bit))
-      hcode ^= xored;
-    xored++;
-  }
+hamming_bit_value(const unsigned bit) {
+  const unsigned base = 704 + PARITY_BIT;
 
+  if (bit < HCODE_STAIRCASE)
+    return base + bit;
   /* skip the code bits themselves */
-  xored += (HCODE_GAP_STOP - HCODE_GAP_START);
+  if (bit >= HCODE_GAP_START && bit < HCODE_GAP_STOP)
+    return 0;
+  return base + bit + 32;
+}
+
+/* Fast implementation by table-lookup on bytes. Entry [i][v] is the
+   contribution of value v at byte i of the frame, bytes being numbered
+   from the LSB of each big-endian word, just like the bits. */
+
+static uint16_t hamming_lut[HCODE_BYTES][256];
 
-  for (bit = HCODE_GAP_STOP; bit < HCODE_END; bit++) {
-    if (get_bit(data, bit))
-      hcode ^= xored;
+static gpointer
+hamming_lut_fill(gpointer data) {
+  unsigned bit;
+  (void) data;
 
-    xored++;
+  for (bit = 0; bit < HCODE_END; bit++) {
+    const unsigned value = hamming_bit_value(bit);
+    uint16_t *lut = hamming_lut[bit >> 3];
+    unsigned v;
+
+    for (v = 0; v < 256; v++)
+      if (v & (1 << (bit & 7)))
+	lut[v] ^= value;
   }
 
-  return hcode;
+  return NULL;
 }
 
-/* Fast implementation by table-lookup on bytes. Each lut value contains
-   4 bits, 3 bits of data, 1 bit of parity. This should be roughly 8
-   times faster. */
+static inline unsigned
+hamming_word(const uint16_t (*lut)[256], const uint32_t word) {
+  return lut[0][word & 0xff] ^ lut[1][(word >> 8) & 0xff] ^
+    lut[2][(word >> 16) & 0xff] ^ lut[3][word >> 24];
+}
 
+/* The frame is read 64 bits at a time, and the (numerous) all-zero
+   stretches are skipped */
 static unsigned
-extract_frame_code(const char *data) {
-  const uint32_t *dat = (void *) data;
-  return GUINT32_FROM_BE(dat[20]) & 0xFFF;
+hamming_compute(const unsigned char *data) {
+  static GOnce lut_once = G_ONCE_INIT;
+  unsigned w, hcode = 0;
+
+  g_once(&lut_once, hamming_lut_fill, NULL);
+
+  for (w = 0; w + 2 <= HCODE_WORDS; w += 2) {
+    uint64_t dw;
+
+    memcpy(&dw, data + w * sizeof(uint32_t), sizeof(dw));
+    if (!dw)
+      continue;
+    dw = GUINT64_FROM_BE(dw);
+
+    /* word w sits in the upper half */
+    hcode ^= hamming_word(&hamming_lut[4 * w], dw >> 32);
+    hcode ^= hamming_word(&hamming_lut[4 * (w + 1)], (uint32_t) dw);
+  }
+
+#if HCODE_WORDS & 1
+  {
+    uint32_t word;
+    memcpy(&word, data + w * sizeof(uint32_t), sizeof(word));
+    hcode ^= hamming_word(&hamming_lut[4 * w], GUINT32_FROM_BE(word));
+  }
+#endif
+
+  return hcode;
 }
 
 /* population count */
@@ -108,19 +135,31 @@ popcount(uint16_t dat) {
   return count;
 }
 
+unsigned
+hamming_frame_code(const char *data) {
+  uint32_t word;
+  memcpy(&word, data + (HCODE_GAP_START / 32) * sizeof(uint32_t), sizeof(word));
+  return GUINT32_FROM_BE(word) & 0xFFF;
+}
+
+unsigned
+hamming_frame_compute(const char *data) {
+  unsigned check = hamming_compute((const void *)data);
+  unsigned parity = popcount(check) & 1;
+
+  return check ^ (parity << 11);
+}
+
 /* Check frame */
 int
 check_hamming_frame(const char *data, const uint32_t far) {
-  unsigned check = hamming_compute((const void *)data);
-  unsigned hamming = extract_frame_code(data);
-  unsigned parity = popcount(check) & 1;
+  unsigned check = hamming_frame_compute(data);
+  unsigned hamming = hamming_frame_code(data);
 
   /* FAR should be used to do an intelligent check of the hamming bits
      for variable frames */
   (void) far;
 
-  check ^= (parity << 11);
-
   if (check != hamming) {
     g_warning("Hamming failed (expected %04x, got %04x)", hamming, check);
     return -1;
@@ -26,6 +26,11 @@
 
 #include <stdint.h>
 
+/* The code stored in a frame, and the one computed over its data,
+   parity bit included */
+unsigned hamming_frame_code(const char *data);
+unsigned hamming_frame_compute(const char *data);
+
 int check_hamming_frame(const char *data, const uint32_t far);
 
 #endif /* _HAS_XHAMMING_H */
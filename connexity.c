@@ -17,6 +17,7 @@
  * along with debit.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <string.h>
 #include <glib.h>
 #include "debitlog.h"
 
@@ -29,19 +30,19 @@
  */
 
 typedef struct _connexion {
-  /* GNode table, for gathering pips in an organized fashion */
-  GNode **nodetable;
-  /* GNode table, for gathering pips at long wires */
-  GNode **lv, **lh;
+  /* node table, for gathering pips in an organized fashion */
+  net_node_t *nodetable;
+  /* node table, for gathering pips at long wires */
+  net_node_t *lv, *lh;
 } connexion_t;
 
 /* For now be dumb */
-static inline GNode **
+static inline net_node_t *
 alloc_wire_table(const pip_db_t *pipdb, const chip_descr_t *chip) {
   gsize size = pipdb->wiredb->dblen * chip->width * chip->height;
   /* we could divide the size by two by only storing startpoint
      in this table */
-  return g_new0(GNode *, size);
+  return g_new0(net_node_t, size);
 }
 
 #define LONGS_PER_SITE 24
@@ -56,18 +57,18 @@ size_t lh_len(const chip_descr_t *chip) {
   return chip->height * LONGS_PER_SITE;
 }
 
-static inline GNode **
+static inline net_node_t *
 alloc_lv(const pip_db_t *pipdb, const chip_descr_t *chip) {
   size_t size = lv_len(chip);
   (void) pipdb;
-  return g_new0(GNode *, size);
+  return g_new0(net_node_t, size);
 }
 
-static inline GNode **
+static inline net_node_t *
 alloc_lh(const pip_db_t *pipdb, const chip_descr_t *chip) {
   size_t size = lh_len(chip);
   (void) pipdb;
-  return g_new0(GNode *, size);
+  return g_new0(net_node_t, size);
 }
 
 static connexion_t *
@@ -88,6 +89,49 @@ free_connexions(connexion_t *connexions) {
   return;
 }
 
+/*
+ * Node pool. Nodes are never freed one by one: the whole pool goes
+ * away with the nets.
+ */
+
+static void
+grow_nodes(nets_t *nets, const guint32 allocd) {
+  nets->spip = g_renew(sited_pip_t, nets->spip, allocd);
+  nets->parent = g_renew(net_node_t, nets->parent, allocd);
+  nets->first_child = g_renew(net_node_t, nets->first_child, allocd);
+  nets->next_sibling = g_renew(net_node_t, nets->next_sibling, allocd);
+  nets->allocd = allocd;
+}
+
+static net_node_t
+node_new(nets_t *nets) {
+  net_node_t node;
+
+  if (nets->nnodes == nets->allocd)
+    grow_nodes(nets, 2 * nets->allocd);
+
+  node = nets->nnodes++;
+  nets->parent[node] = NET_NODE_NONE;
+  nets->first_child[node] = NET_NODE_NONE;
+  nets->next_sibling[node] = NET_NODE_NONE;
+  return node;
+}
+
+static inline gboolean
+node_is_root(const nets_t *nets, const net_node_t node) {
+  return nets->parent[node] == NET_NODE_NONE;
+}
+
+/* As with GNodes, a node which already has a father is left alone */
+static inline net_node_t
+node_prepend(nets_t *nets, const net_node_t father, const net_node_t node) {
+  g_return_val_if_fail(node_is_root(nets, node), node);
+  nets->parent[node] = father;
+  nets->next_sibling[node] = nets->first_child[father];
+  nets->first_child[father] = node;
+  return node;
+}
+
 /*
  * LH, LV hooks
  */
@@ -152,7 +196,7 @@ lh_offset_of(const wire_db_t *wiredb,
 }
 
 static inline void
-long_register(GNode *driver,
+long_register(const net_node_t driver,
 	      const wire_type_t target_type,
 	      const sited_wire_t swire,
 	      const connexion_t *connexions,
@@ -174,18 +218,19 @@ long_register(GNode *driver,
   }
 }
 
-static inline GNode *
-long_register_fake(const wire_type_t target_type,
+static inline net_node_t
+long_register_fake(nets_t *nets,
+		   const wire_type_t target_type,
 		   const sited_wire_t swire,
 		   const connexion_t *connexions,
 		   const wire_db_t *wiredb,
 		   const chip_descr_t *cdb) {
-  GNode *added = g_node_new(NULL);
+  net_node_t added = node_new(nets);
   long_register(added, target_type, swire, connexions, wiredb, cdb);
   return added;
 }
 
-static inline GNode *
+static inline net_node_t
 long_of(const wire_type_t target_type,
 	const sited_wire_t swire,
 	const connexion_t *connexions,
@@ -202,22 +247,23 @@ long_of(const wire_type_t target_type,
   default:
     g_assert_not_reached();
   }
-  return NULL;
+  return NET_NODE_NONE;
 }
 
+/* The wires driven by a long which has no driver become nets of their
+   own; the long itself is dropped */
 static inline unsigned
-gather(GNode **array, size_t array_len,
-       GNode *head) {
+gather(nets_t *nets, const net_node_t *array, size_t array_len) {
   unsigned i, found = 0;
   for(i = 0; i < array_len; i++) {
-    GNode *dummynet = array[i];
-    if (dummynet && G_NODE_IS_ROOT(dummynet)) {
-      GNode *net;
-      while( (net = g_node_first_child(dummynet)) ) {
-	g_node_unlink(net);
-	g_node_prepend(head, net);
+    const net_node_t dummynet = array[i];
+    if (dummynet && node_is_root(nets, dummynet)) {
+      net_node_t net;
+      while( (net = nets->first_child[dummynet]) ) {
+	nets->first_child[dummynet] = nets->next_sibling[net];
+	nets->parent[net] = NET_NODE_NONE;
+	node_prepend(nets, nets->head, net);
       }
-      g_node_destroy(dummynet);
       found++;
     }
   }
@@ -228,11 +274,10 @@ static unsigned
 gather_longs(nets_t *nets,
 	     const chip_descr_t *cdb,
 	     const connexion_t *connexions) {
-  GNode *head = nets->head;
   unsigned found = 0;
 
-  found += gather(connexions->lv, lv_len(cdb), head);
-  found += gather(connexions->lh, lh_len(cdb), head);
+  found += gather(nets, connexions->lv, lv_len(cdb));
+  found += gather(nets, connexions->lh, lh_len(cdb));
 
   if (found)
     g_warning("There were %i lonely longs found", found);
@@ -250,23 +295,22 @@ net_offset_of(const wire_db_t *wiredb,
   return net_offset;
 }
 
-static inline GNode *
-net_of(GNode **db,
+static inline net_node_t
+net_of(const net_node_t *db,
        const wire_db_t *wiredb,
        const sited_pip_t *pip) {
   unsigned index = net_offset_of(wiredb, pip);
   return db[index];
 }
 
-static inline GNode *
-net_register(GNode **db, GNode *allocd,
+static inline net_node_t
+net_register(nets_t *nets,
+	     net_node_t *db, const net_node_t allocd,
 	     const wire_db_t *wiredb,
 	     const sited_pip_t *pip) {
-  sited_pip_t *newpip = g_slice_new(sited_pip_t);
-  GNode *added = allocd ? allocd : g_node_new(newpip);
+  net_node_t added = allocd ? allocd : node_new(nets);
   unsigned index = net_offset_of(wiredb, pip);
-  added->data = newpip;
-  *newpip = *pip;
+  nets->spip[added] = *pip;
   db[index] = added;
   return added;
 }
@@ -280,64 +324,65 @@ net_register(GNode **db, GNode *allocd,
  */
 
 static inline gboolean
-register_spip(GNode **added,
+register_spip(nets_t *nets,
+	      net_node_t *added,
 	      const sited_pip_t *spip,
-	      GNode *driven,
+	      const net_node_t driven,
 	      const connexion_t *connexions,
 	      const wire_db_t *wiredb,
 	      const chip_descr_t *cdb) {
   gboolean present = TRUE;
   wire_type_t target_type = wire_type(wiredb, spip->pip.target);
   sited_wire_t swire = { .wire = spip->pip.target, .site = spip->site };
-  GNode **nodetable = connexions->nodetable;
-  GNode *cached = NULL, *father = net_of(nodetable, wiredb, spip);
+  net_node_t *nodetable = connexions->nodetable;
+  net_node_t cached = NET_NODE_NONE, father = net_of(nodetable, wiredb, spip);
 
   g_assert(spip->pip.target != WIRE_EP_END);
 
   switch (target_type) {
   case LH:
   case LV: {
-    /* A GNode may already have been allocated while visiting the wires
+    /* A node may already have been allocated while visiting the wires
        driven by the long. We use it if present -- and we should also do
        some checks there in fact */
     /* lookup source ! */
     if (spip->pip.source != WIRE_EP_END)
       cached = long_of(target_type, swire, connexions, wiredb, cdb);
     else
-      cached = NULL;
+      cached = NET_NODE_NONE;
 
     break;
   }
   default:
-    cached = NULL;
+    cached = NET_NODE_NONE;
   }
 
   /* In case the pip is not yet present in the table, add it */
   if (!father) {
     present = FALSE;
-    father = net_register(nodetable, cached, wiredb, spip);
+    father = net_register(nets, nodetable, cached, wiredb, spip);
   }
 
   if (driven)
-    g_node_prepend(father, driven);
+    node_prepend(nets, father, driven);
 
   switch (target_type) {
   case LH:
   case LV: {
     /* This wire should also be registered as driven by the correct LV/LH
-       We'll creating the GNode if not already present */
-    GNode *driver = long_of(target_type, swire, connexions, wiredb, cdb);
+       We'll creating the node if not already present */
+    net_node_t driver = long_of(target_type, swire, connexions, wiredb, cdb);
 
     if (spip->pip.source != WIRE_EP_END) {
       long_register(father, target_type, swire, connexions, wiredb, cdb);
       break;
     }
 
-    if (driver == NULL)
-      driver = long_register_fake(target_type, swire, connexions, wiredb, cdb);
+    if (driver == NET_NODE_NONE)
+      driver = long_register_fake(nets, target_type, swire, connexions, wiredb, cdb);
 
     if (!present) {
-      g_node_prepend(driver, father);
+      node_prepend(nets, driver, father);
       present = TRUE;
     }
     break;
@@ -435,7 +480,7 @@ get_wire_driver(const pip_db_t *pipdb,
  * The sited wire is always a wire *startpoint*
  */
 
-static GNode *
+static net_node_t
 build_net_from(nets_t *nets,
 	       connexion_t *connexions,
 	       const pip_db_t *pipdb,
@@ -444,7 +489,7 @@ build_net_from(nets_t *nets,
 	       const sited_pip_t *spip_arg) {
   wire_db_t *wiredb = pipdb->wiredb;
   sited_pip_t spip = *spip_arg;
-  GNode *newnode = NULL;
+  net_node_t newnode = NET_NODE_NONE;
   gboolean found;
 
   debit_log(L_CONNEXITY, "entering build_net_from");
@@ -454,7 +499,7 @@ build_net_from(nets_t *nets,
     gboolean exists;
 
     /* make a node out of the sited pip and register it, if needed */
-    exists = register_spip(&newnode, &spip, newnode, connexions, wiredb, cdb);
+    exists = register_spip(nets, &newnode, &spip, newnode, connexions, wiredb, cdb);
     if (exists)
       return newnode;
 
@@ -487,8 +532,8 @@ build_net_from(nets_t *nets,
   /* Add a dummy pip to record the absence of driver */
   g_assert(spip.pip.target != WIRE_EP_END);
   spip.pip.source = WIRE_EP_END;
-  if (!register_spip(&newnode, &spip, newnode, connexions, wiredb, cdb))
-    return g_node_prepend(nets->head, newnode);
+  if (!register_spip(nets, &newnode, &spip, newnode, connexions, wiredb, cdb))
+    return node_prepend(nets, nets->head, newnode);
 
   return newnode;
 }
@@ -517,6 +562,126 @@ build_net_iter(gpointer data, const pip_t pip, const site_ref_t site) {
 		 arg->pipdb, arg->cdb, arg->pipdat, &spip);
 }
 
+/*
+ * Net membership, as union-find classes
+ */
+
+static net_node_t
+uf_find(net_node_t *uf, net_node_t node) {
+  net_node_t root = node;
+
+  while (uf[root] != root)
+    root = uf[root];
+
+  /* path compression */
+  while (uf[node] != root) {
+    const net_node_t next = uf[node];
+    uf[node] = root;
+    node = next;
+  }
+
+  return root;
+}
+
+/* Each node is merged with its driver. The representative of a class
+   is then made the net itself, and every node is left pointing
+   directly to it */
+void
+build_net_classes(nets_t *nets) {
+  const net_node_t head = nets->head;
+  net_node_t *uf = g_renew(net_node_t, nets->uf, nets->nnodes);
+  net_node_t node, net;
+
+  for (node = 0; node < nets->nnodes; node++)
+    uf[node] = node;
+
+  for (node = head + 1; node < nets->nnodes; node++) {
+    const net_node_t father = nets->parent[node];
+    net_node_t a, b;
+
+    if (father == NET_NODE_NONE || father == head)
+      continue;
+
+    a = uf_find(uf, node);
+    b = uf_find(uf, father);
+    if (a != b)
+      uf[a] = b;
+  }
+
+  for (net = nets_first(nets); net; net = nets_next(nets, net)) {
+    const net_node_t root = uf_find(uf, net);
+    uf[root] = net;
+    uf[net] = net;
+  }
+
+  for (node = 0; node < nets->nnodes; node++)
+    uf_find(uf, node);
+
+  nets->uf = uf;
+}
+
+net_node_t
+net_of_node(nets_t *nets, const net_node_t node) {
+  net_node_t net;
+
+  if (!nets->uf)
+    build_net_classes(nets);
+
+  net = nets->uf[node];
+  /* Nodes of dropped trees have some other representative */
+  if (nets->parent[net] != nets->head)
+    return NET_NODE_NONE;
+  return net;
+}
+
+nets_csr_t *
+nets_csr(nets_t *nets) {
+  nets_csr_t *csr = g_new(nets_csr_t, 1);
+  guint32 *netnum = g_new(guint32, nets->nnodes);
+  guint32 *pos, nnets = 0, i;
+  net_node_t node, net;
+
+  for (net = nets_first(nets); net; net = nets_next(nets, net))
+    netnum[net] = nnets++;
+
+  csr->nnets = nnets;
+  csr->offsets = g_new0(guint32, nnets + 1);
+
+  /* count, then scatter, the net itself first */
+  for (node = nets->head + 1; node < nets->nnodes; node++) {
+    net = net_of_node(nets, node);
+    if (net)
+      csr->offsets[netnum[net] + 1]++;
+  }
+
+  for (i = 0; i < nnets; i++)
+    csr->offsets[i + 1] += csr->offsets[i];
+
+  csr->nodes = g_new(net_node_t, csr->offsets[nnets]);
+  pos = g_new(guint32, nnets);
+  memcpy(pos, csr->offsets, nnets * sizeof(guint32));
+
+  for (net = nets_first(nets); net; net = nets_next(nets, net))
+    csr->nodes[pos[netnum[net]]++] = net;
+
+  for (node = nets->head + 1; node < nets->nnodes; node++) {
+    net = net_of_node(nets, node);
+    if (net && net != node)
+      csr->nodes[pos[netnum[net]]++] = node;
+  }
+
+  g_free(pos);
+  g_free(netnum);
+  return csr;
+}
+
+void
+free_nets_csr(nets_csr_t *csr) {
+  g_free(csr->offsets);
+  g_free(csr->nodes);
+  g_free(csr);
+}
+
 static int
 _build_nets(nets_t *nets,
 	    const pip_db_t *pipdb,
@@ -538,38 +703,35 @@ _build_nets(nets_t *nets,
   gather_longs(nets, cdb, connex);
 
   free_connexions(connex);
+
   return 0;
 }
 
 nets_t *build_nets(const pip_db_t *pipdb,
 		   const chip_descr_t *cdb,
 		   const pip_parsed_dense_t *pipdat) {
-  nets_t *ret = g_new(nets_t, 1);
+  nets_t *ret = g_new0(nets_t, 1);
   int err;
 
-  ret->head = g_node_new(NULL);
+  /* There are about as many nodes as pips */
+  grow_nodes(ret, pipdat->site_index[cdb->width * cdb->height] + 2);
+  (void) node_new(ret);
+  ret->head = node_new(ret);
 
   err = _build_nets(ret, pipdb, cdb, pipdat);
   if (err) {
-    g_free(ret);
+    free_nets(ret);
     return NULL;
   }
 
   return ret;
 }
 
-static
-gboolean free_net(GNode *node,
-		  gpointer data) {
-  (void) data;
-  if (node->data)
-    g_slice_free(sited_pip_t, node->data);
-  return FALSE;
-}
-
 void free_nets(nets_t *nets) {
-  GNode *root = nets->head;
-  g_node_traverse (root, G_IN_ORDER, G_TRAVERSE_ALL, -1, free_net, NULL);
-  g_node_destroy(root);
+  g_free(nets->spip);
+  g_free(nets->parent);
+  g_free(nets->first_child);
+  g_free(nets->next_sibling);
+  g_free(nets->uf);
   g_free(nets);
 }
@@ -26,17 +26,36 @@
 
 /** \brief Structure describing all nets in an FPGA
  *
- * This structure is an N-ary tree. The first-level nodes are the
- * different nets; then from then on each GNode contains a pointer to
- * some (pip + site) reference, and links between GNodes reflect copper
- * wiring inside the chip (ie, wiring which is not part of the explicit
- * description that we get from the bitstream, but which is contained in
- * the physical chip layout).
+ * This structure is a forest held in flat arrays indexed by node
+ * number. The first-level nodes, children of the head node, are the
+ * different nets; then from then on each node contains some (pip +
+ * site) reference, and links between nodes reflect copper wiring
+ * inside the chip (ie, wiring which is not part of the explicit
+ * description that we get from the bitstream, but which is contained
+ * in the physical chip layout): the children of a node are the wires
+ * it drives.
  *
+ * The nodes can also be grouped into union-find classes, whose
+ * representative is the net itself. The classes are only built when
+ * first needed.
  */
 
+typedef guint32 net_node_t;
+
+/* Node number zero is never used */
+#define NET_NODE_NONE 0
+
 typedef struct _nets_t {
-  GNode *head;
+  net_node_t head;
+  /* node pool */
+  guint32 nnodes;
+  guint32 allocd;
+  sited_pip_t *spip;
+  net_node_t *parent;
+  net_node_t *first_child;
+  net_node_t *next_sibling;
+  /* union-find classes */
+  net_node_t *uf;
 } nets_t;
 
 nets_t *build_nets(const pip_db_t *pipdb,
@@ -45,4 +64,56 @@ nets_t *build_nets(const pip_db_t *pipdb,
 
 void free_nets(nets_t *);
 
+/*
+ * Walking the nets
+ */
+
+static inline net_node_t
+nets_first(const nets_t *nets) {
+  return nets->first_child[nets->head];
+}
+
+static inline net_node_t
+nets_next(const nets_t *nets, const net_node_t net) {
+  return nets->next_sibling[net];
+}
+
+static inline gboolean
+net_node_is_leaf(const nets_t *nets, const net_node_t node) {
+  return nets->first_child[node] == NET_NODE_NONE;
+}
+
+/** \brief Group the nodes into classes, one per net
+ *
+ * This is done by the first call to net_of_node, if need be.
+ */
+void build_net_classes(nets_t *nets);
+
+/** \brief Get the net a node belongs to
+ *
+ * @return the net, or NET_NODE_NONE if the node was left out of the
+ * nets
+ */
+net_node_t net_of_node(nets_t *nets, const net_node_t node);
+
+/** \brief Net membership in compressed sparse row form
+ *
+ * The nodes of net i, in the order of nets_first / nets_next, are the
+ * nodes from offsets[i] to offsets[i+1]. Each row starts with the net
+ * itself, then the other nodes of the net follow in node order. The
+ * start of each net shows as a pip with a WIRE_EP_END source.
+ */
+typedef struct _nets_csr {
+  guint32 nnets;
+  guint32 *offsets;
+  net_node_t *nodes;
+} nets_csr_t;
+
+/** \brief Export the net classes
+ *
+ * The classes are built first if need be.
+ */
+nets_csr_t *nets_csr(nets_t *nets);
+void free_nets_csr(nets_csr_t *csr);
+
 #endif /* _HAS_CONNEXITY_H */
@@ -0,0 +1,94 @@
+#!/usr/bin/perl -w
+
+# This script takes the wires.m4 database in stdin and generates a
+# minimal perfect hash of the wire names, as a C header for inclusion
+# by wiring.c. The hash function must be kept in sync with wirehash()
+# in wiring.c.
+
+use strict;
+
+# Must match WIREHASH_LOAD and WIREHASH_MAX_DISP in wiring.c
+my $load = 4;
+my $max_disp = 1 << 20;
+
+my @names;
+
+while (<STDIN>) {
+    next unless /^_WIRE_ENTRY\(\s*([^,\s]+)\s*,\s*(\d+)\s*,/;
+    $names[$2] = $1;
+}
+
+my $n = scalar @names;
+die "empty wire database\n" unless $n;
+for my $i (0 .. $n - 1) {
+    die "wire $i is missing\n" unless defined $names[$i];
+}
+
+sub wirehash {
+    my ($name, $seed) = @_;
+    my $h = 2166136261 ^ $seed;
+    for my $c (unpack("C*", $name)) {
+	$h ^= $c;
+	$h = ($h * 16777619) & 0xffffffff;
+    }
+    $h ^= $h >> 16;
+    $h = ($h * 0x85ebca6b) & 0xffffffff;
+    $h ^= $h >> 13;
+    return $h;
+}
+
+my $nbuckets = int($n / $load) + 1;
+my @buckets = map { [] } (1 .. $nbuckets);
+
+for my $i (0 .. $n - 1) {
+    push @{$buckets[wirehash($names[$i], 0) % $nbuckets]}, $i;
+}
+
+# Place the crowded buckets first. The sort is stable on the index,
+# like the runtime builder, although the two need not agree
+my @order = sort { scalar @{$buckets[$b]} <=> scalar @{$buckets[$a]}
+		   || $a <=> $b } (0 .. $nbuckets - 1);
+
+my @disp = (0) x $nbuckets;
+my @slots;
+my @taken = (0) x $n;
+
+for my $b (@order) {
+    my @members = @{$buckets[$b]};
+    last unless @members;
+
+    my $d;
+  DISP:
+    for ($d = 1; $d < $max_disp; $d++) {
+	my %mine;
+	for my $w (@members) {
+	    my $slot = wirehash($names[$w], $d) % $n;
+	    next DISP if $taken[$slot] || $mine{$slot};
+	    $mine{$slot} = $w;
+	}
+	for my $slot (keys %mine) {
+	    $taken[$slot] = 1;
+	    $slots[$slot] = $mine{$slot};
+	}
+	last;
+    }
+    die "could not hash the wire names\n" if $d == $max_disp;
+    $disp[$b] = $d;
+}
+
+sub dump_array {
+    my @vals = @_;
+    my $i;
+    for ($i = 0; $i < @vals; $i += 8) {
+	my $last = $i + 7 < $#vals ? $i + 7 : $#vals;
+	print "\t", join(", ", @vals[$i .. $last]), ",\n";
+    }
+}
+
+print "/* Generated by wirehash.pl, do not edit */\n\n";
+print "static const guint32 wirehash_disp[] = {\n";
+dump_array(@disp);
+print "};\n\n";
+print "static const wire_atom_t wirehash_slots[] = {\n";
+dump_array(@slots);
+print "};\n";
@@ -36,13 +36,17 @@
     but the data must not.
 */
 
+#include <string.h>
 #include <glib.h>
+#include <glib/gstdio.h>
 
 #include "bitstream_parser.h"
 #include "bitstream_write.h"
 #include "debitlog.h"
+#include "stats.h"
 #include "filedump.h"
 #include "analysis.h"
+#include "bitdiff.h"
 
 static gboolean framedump = FALSE;
 static gboolean sitedump = FALSE;
@@ -51,87 +55,374 @@ static gboolean pipdump = FALSE;
 static gboolean lutdump = FALSE;
 static gboolean bramdump = FALSE;
 static gboolean netdump = FALSE;
+static gboolean eccheck = FALSE;
+static gboolean compact = FALSE;
+static gboolean diffsites = FALSE;
 
 static gchar *ifile = NULL;
+static gchar *manifest = NULL;
 static gchar *ofile = NULL;
+static gchar *partial = NULL;
+static gchar *diff = NULL;
+static gchar *sitearchive = NULL;
 static gchar *odir = "";
 static gchar *datadir = DATADIR;
 static gchar *suffix = ".bin";
+static gint jobs = 1;
+static gchar *stats = NULL;
+static gchar *snapdir = NULL;
+
+/* The bases of --partial and --diff, parsed once for all files */
+static bitstream_parsed_t *partial_base = NULL;
+static bitstream_parsed_t *diff_base = NULL;
 
 #if DEBIT_DEBUG > 0
 unsigned int debit_debug = 0;
+static gint logbuffer = 0;
 #else
 static unsigned debit_local_debug;
 #endif
 
+static inline gboolean
+text_dumps(void) {
+  return pipdump || lutdump || bramdump || netdump;
+}
+
 static int
-debit_file(gchar *input_file, gchar *output_dir) {
+debit_file(const gchar *input_file, const gchar *output_dir,
+	   const gchar *output_file,
+	   analysis_dbs_t *dbs, FILE *out, const unsigned njobs) {
   gint err = 0;
   bitstream_parsed_t *bit;
+  bitstream_diff_t *bitdiff = NULL;
+  stats_mark_t mark;
 
-  bit = parse_bitstream(input_file);
+  /* "-" reads the bitstream from the standard input */
+  if (!strcmp(input_file, "-"))
+    bit = parse_bitstream_file(stdin);
+  else
+    bit = parse_bitstream(input_file);
 
   if (bit == NULL) {
     err = -1;
     goto out;
   }
 
+  if (compact) {
+    stats_begin(&mark);
+    err = bitstream_compact_frames(bit);
+    stats_end(&mark, STATS_COMPACT);
+    if (err) {
+      err = -1;
+      goto out_free;
+    }
+  }
+
   /* Have some action */
-  if (framedump)
+  if (eccheck && check_bitstream_ecc(bit, out) != 0)
+    err = -1;
+
+  if (framedump) {
+    stats_begin(&mark);
     design_write_frames(bit, output_dir);
+    stats_end(&mark, STATS_DUMP_FRAMES);
+  }
 
-  if (unkdump)
+  if (unkdump) {
+    stats_begin(&mark);
     design_dump_frames(bit, output_dir);
+    stats_end(&mark, STATS_DUMP_UNK);
+  }
 
   /* Just rewrite the bitstream. This is a test for the
      bitstream-writing code */
-  if (ofile)
-    bitstream_write(bit,output_dir,ofile);
+  if (output_file && partial_base) {
+    if (bitstream_write_partial(partial_base, bit, output_dir, output_file))
+      err = -1;
+  } else if (output_file) {
+    if (bitstream_write(bit, output_dir, output_file))
+      err = -1;
+  }
 
-  if (sitedump || pipdump || lutdump || bramdump || netdump) {
-    bitstream_analyzed_t *analysis = analyze_bitstream(bit, datadir);
+  /* The differences are also used to analyze the bitstream from the
+     analysis of the base one */
+  if (diff_base) {
+    bitdiff = diff_bitstreams(diff_base, bit, njobs);
+    if (!bitdiff ||
+	dump_diff(diff_base, bit, bitdiff, diffsites ? dbs : NULL, out))
+      err = -1;
+  }
+
+  if (sitedump || sitearchive || text_dumps()) {
+    bitstream_analyzed_t *analysis = bitdiff ?
+      analyze_bitstream_update(bit, diff_base, bitdiff, dbs, njobs) :
+      analyze_bitstream_shared(bit, dbs, njobs);
     if (analysis == NULL) {
       g_warning("Problem during analysis");
       err = -1;
       goto out_free;
     }
 
+    analysis->out = out;
+
 /*     print_chip(analysis->chip); */
 
-    if (sitedump)
+    if (sitedump) {
+      stats_begin(&mark);
       dump_sites(analysis, output_dir, suffix);
-    if (pipdump)
+      stats_end(&mark, STATS_DUMP_SITES);
+    }
+    if (sitearchive) {
+      gchar *filename = g_build_filename(output_dir, sitearchive, NULL);
+      stats_begin(&mark);
+      if (dump_sites_archive(analysis, filename, njobs))
+	err = -1;
+      stats_end(&mark, STATS_DUMP_ARCHIVE);
+      g_free(filename);
+    }
+    if (pipdump) {
+      stats_begin(&mark);
       dump_pips(analysis);
-    if (lutdump)
+      stats_end(&mark, STATS_DUMP_PIPS);
+    }
+    if (lutdump) {
+      stats_begin(&mark);
       dump_luts(analysis);
-    if (bramdump)
+      stats_end(&mark, STATS_DUMP_LUTS);
+    }
+    if (bramdump) {
+      stats_begin(&mark);
       dump_bram(analysis);
-    if (netdump)
+      stats_end(&mark, STATS_DUMP_BRAM);
+    }
+    if (netdump) {
+      stats_begin(&mark);
       dump_nets(analysis);
+      stats_end(&mark, STATS_DUMP_NETS);
+    }
 
     free_analysis(analysis);
   }
 
  out_free:
+  if (bitdiff)
+    free_bitstream_diff(bitdiff);
   free_bitstream(bit);
  out:
   return err;
 }
 
+/*
+ * Batch mode: the files of a manifest are processed by a pool of
+ * workers, each one with its own output directory. The databases and
+ * the base bitstreams are shared between all files.
+ */
+
+typedef struct _batch_item {
+  gchar *input;
+  gchar *outdir;
+  guint64 size;
+  int err;
+} batch_item_t;
+
+static void
+batch_worker(gpointer data, gpointer user_data) {
+  batch_item_t *item = data;
+  analysis_dbs_t *dbs = user_data;
+  gchar *outfile = NULL;
+  FILE *out = NULL;
+
+  if (g_mkdir_with_parents(item->outdir, 0755)) {
+    g_warning("could not create directory %s", item->outdir);
+    item->err = -1;
+    return;
+  }
+
+  /* The text dumps, which otherwise go to stdout, are written to a
+     file of the output directory */
+  if (text_dumps() || diff || eccheck) {
+    gchar *filename = g_build_filename(item->outdir, "dump.txt", NULL);
+    out = g_fopen(filename, "w");
+    if (!out)
+      g_warning("could not open %s", filename);
+    g_free(filename);
+    if (!out) {
+      item->err = -1;
+      return;
+    }
+  }
+
+  /* So is the rewritten bitstream, under the name given */
+  if (ofile) {
+    gchar *name = g_path_get_basename(ofile);
+    outfile = g_build_filename(item->outdir, name, NULL);
+    g_free(name);
+  }
+
+  item->err = debit_file(item->input, item->outdir, outfile, dbs, out, 1);
+  if (item->err)
+    g_warning("failed to process %s", item->input);
+
+  g_free(outfile);
+  if (out)
+    fclose(out);
+}
+
+/* The output directory of a file is named after the file, without its
+   extension; duplicate names get the rank of the file appended */
+static gchar *
+batch_outdir(GHashTable *names, const gchar *input, const guint rank) {
+  gchar *base = g_path_get_basename(input);
+  gchar *dot = strrchr(base, '.');
+  gchar *name, *outdir;
+
+  if (dot && dot != base)
+    *dot = '\0';
+
+  if (g_hash_table_lookup(names, base)) {
+    name = g_strdup_printf("%s.%u", base, rank);
+    g_free(base);
+  } else
+    name = base;
+
+  g_hash_table_insert(names, name, name);
+  outdir = g_build_filename(odir, name, NULL);
+  return outdir;
+}
+
+/* One input per line; blank lines and lines starting with '#' are
+   skipped */
+static int
+read_manifest(const gchar *filename, GPtrArray *inputs) {
+  GError *error = NULL;
+  gchar *contents, **lines;
+  guint i;
+
+  if (!g_file_get_contents(filename, &contents, NULL, &error)) {
+    g_warning("could not read manifest: %s", error->message);
+    g_error_free(error);
+    return -1;
+  }
+
+  lines = g_strsplit(contents, "\n", -1);
+  g_free(contents);
+
+  for (i = 0; lines[i]; i++) {
+    gchar *line = g_strstrip(lines[i]);
+    if (line[0] == '\0' || line[0] == '#')
+      continue;
+    g_ptr_array_add(inputs, g_strdup(line));
+  }
+
+  g_strfreev(lines);
+  return 0;
+}
+
+static int
+debit_batch(GPtrArray *inputs, analysis_dbs_t *dbs) {
+  const guint nitems = inputs->len;
+  batch_item_t *items = g_new0(batch_item_t, nitems);
+  GHashTable *names = g_hash_table_new_full(g_str_hash, g_str_equal,
+					    g_free, NULL);
+  GThreadPool *pool;
+  GError *error = NULL;
+  GTimer *timer;
+  guint64 bytes = 0;
+  guint i, failed = 0;
+  gdouble elapsed, mib;
+
+  for (i = 0; i < nitems; i++) {
+    batch_item_t *item = &items[i];
+    struct stat st;
+
+    item->input = g_ptr_array_index(inputs, i);
+    item->outdir = batch_outdir(names, item->input, i);
+    if (!g_stat(item->input, &st))
+      item->size = st.st_size;
+  }
+
+  timer = g_timer_new();
+
+  pool = g_thread_pool_new(batch_worker, dbs, jobs, TRUE, &error);
+  if (error) {
+    g_warning("could not start the workers: %s", error->message);
+    g_error_free(error);
+    pool = NULL;
+  }
+
+  for (i = 0; i < nitems; i++) {
+    if (pool)
+      g_thread_pool_push(pool, &items[i], NULL);
+    else
+      batch_worker(&items[i], dbs);
+  }
+
+  /* wait for all the files to be processed */
+  if (pool)
+    g_thread_pool_free(pool, FALSE, TRUE);
+
+  elapsed = g_timer_elapsed(timer, NULL);
+  g_timer_destroy(timer);
+
+  for (i = 0; i < nitems; i++) {
+    batch_item_t *item = &items[i];
+    if (item->err)
+      failed++;
+    else
+      bytes += item->size;
+    g_free(item->outdir);
+  }
+
+  mib = (gdouble) bytes / (1 << 20);
+  g_print("%u files, %u failed, %.1f MiB in %.3fs: %.1f files/s, %.1f MiB/s\n",
+	  nitems, failed, mib, elapsed,
+	  elapsed > 0 ? (nitems - failed) / elapsed : 0.,
+	  elapsed > 0 ? mib / elapsed : 0.);
+
+  g_hash_table_destroy(names);
+  g_free(items);
+  return failed ? -1 : 0;
+}
+
+/* --snapshot alone keeps the snapshots in the user cache directory */
+static gboolean
+snapshot_option(const gchar *name, const gchar *value,
+		gpointer data, GError **error) {
+  (void) name;
+  (void) data;
+  (void) error;
+  g_free(snapdir);
+  if (value)
+    snapdir = g_strdup(value);
+  else
+    snapdir = g_build_filename(g_get_user_cache_dir(), "debit", NULL);
+  return TRUE;
+}
+
 static GOptionEntry entries[] =
 {
-  {"input", 'i', 0, G_OPTION_ARG_FILENAME, &ifile, "Read bitstream <ifile>", "<ifile>"},
+  {"input", 'i', 0, G_OPTION_ARG_FILENAME, &ifile, "Read bitstream <ifile>, or the standard input for -", "<ifile>"},
+  {"batch", 'B', 0, G_OPTION_ARG_FILENAME, &manifest, "Process the bitstreams listed in <manifest>", "<manifest>"},
 #if DEBIT_DEBUG > 0
   {"debug", 'g', 0, G_OPTION_ARG_INT, &debit_debug, "Debug verbosity", NULL},
+  {"logbuffer", 'L', 0, G_OPTION_ARG_INT, &logbuffer, "Buffer the last <records> debug messages, printed at exit", "<records>"},
 #else
   {"debug", 'g', 0, G_OPTION_ARG_INT, &debit_local_debug, "Debug verbosity", NULL},
 #endif
   {"outfile", 't', 0, G_OPTION_ARG_FILENAME, &ofile, "Write output bitstream to <ofile>", "<ofile>"},
+  {"partial", 'P', 0, G_OPTION_ARG_FILENAME, &partial, "Only write to <ofile> the frames which differ from bitstream <base>", "<base>"},
+  {"diff", 'D', 0, G_OPTION_ARG_FILENAME, &diff, "Print the configuration bits which differ from bitstream <base>", "<base>"},
+  {"diffsites", 'y', 0, G_OPTION_ARG_NONE, &diffsites, "With --diff, also print the sites of the bits, and the pips which differ", NULL},
   {"outdir", 'o', 0, G_OPTION_ARG_FILENAME, &odir, "Write data files in directory <odir>", "<odir>"},
   {"datadir", 'd', 0, G_OPTION_ARG_FILENAME, &datadir, "Read data files from directory <datadir>", "<datadir>"},
+  {"jobs", 'j', 0, G_OPTION_ARG_INT, &jobs, "Use <jobs> threads for the analysis, or for the batch", "<jobs>"},
+  {"compact", 'c', 0, G_OPTION_ARG_NONE, &compact, "Copy the frames into a contiguous store (v4, v5 only)", NULL},
+  {"snapshot", 'k', G_OPTION_FLAG_OPTIONAL_ARG, G_OPTION_ARG_CALLBACK, snapshot_option, "Keep snapshots of the extracted pips in <dir>, by default the user cache directory", "<dir>"},
+  {"stats", 'S', 0, G_OPTION_ARG_STRING, &stats, "Report phase timings and counters on stderr, as text or json", "<format>"},
   /* v2 specific */
   {"framedump", 'f', 0, G_OPTION_ARG_NONE, &framedump, "Dump raw data frames", NULL},
   {"sitedump", 's', 0, G_OPTION_ARG_NONE, &sitedump, "Dump raw site data files", NULL},
+  {"sitearchive", 'a', 0, G_OPTION_ARG_FILENAME, &sitearchive, "Dump raw site data into the archive <archive>", "<archive>"},
   {"suffix", 'x', 0, G_OPTION_ARG_STRING, &suffix, "Suffix appended to generated files",NULL},
   /* v4, v5 specific */
   {"unkdump", 'u', 0, G_OPTION_ARG_NONE, &unkdump, "Dump raw data frames uninterpreted", NULL},
@@ -139,6 +430,7 @@ static GOptionEntry entries[] =
   {"lutdump", 'l', 0, G_OPTION_ARG_NONE, &lutdump, "Dump lut data from the bitstream", NULL},
   {"bramdump", 'b', 0, G_OPTION_ARG_NONE, &bramdump, "Dump bram data from the bitstream", NULL},
   {"netdump", 'n', 0, G_OPTION_ARG_NONE, &netdump, "Dump nets rebuilt from the bitstream (experimental)", NULL},
+  {"eccheck", 'e', 0, G_OPTION_ARG_NONE, &eccheck, "Check the ECC of the data frames", NULL},
   { NULL, '\0', 0, 0, NULL, NULL, NULL }
 };
 
@@ -148,6 +440,12 @@ main(int argc, char *argv[])
   int err;
   GError *error = NULL;
   GOptionContext *context = NULL;
+  analysis_dbs_t *dbs;
+
+#if !GLIB_CHECK_VERSION(2,32,0)
+  if (!g_thread_supported())
+    g_thread_init(NULL);
+#endif
 
   context = g_option_context_new ("- dump xilinx bitstream data");
   g_option_context_add_main_entries (context, entries, NULL);
@@ -160,11 +458,85 @@ main(int argc, char *argv[])
 
   g_option_context_free(context);
 
-  if (!ifile) {
+  if (!ifile && !manifest) {
     g_warning("You must specify a bitfile, %s --help for help", argv[0]);
     return -1;
   }
 
-  err = debit_file(ifile, odir);
+  if (jobs < 1) {
+    g_warning("The number of jobs must be positive");
+    return -1;
+  }
+
+  if (stats) {
+    if (strcmp(stats, "text") && strcmp(stats, "json")) {
+      g_warning("The stats format must be text or json");
+      return -1;
+    }
+    debit_stats = TRUE;
+  }
+
+#if DEBIT_DEBUG > 0
+  if (logbuffer > 0)
+    debit_log_use_ring(logbuffer);
+#endif
+
+  if (partial && !ofile) {
+    g_warning("The --partial option needs an --outfile to write to");
+    return -1;
+  }
+
+  if (partial) {
+    partial_base = parse_bitstream(partial);
+    if (!partial_base)
+      return -1;
+  }
+
+  if (diff) {
+    diff_base = parse_bitstream(diff);
+    if (!diff_base) {
+      err = -1;
+      goto out_free_partial;
+    }
+  }
+
+  dbs = new_analysis_dbs(datadir);
+  if (snapdir)
+    analysis_dbs_set_snapshots(dbs, snapdir);
+
+  if (manifest) {
+    /* the input file and the remaining arguments join the manifest */
+    GPtrArray *inputs = g_ptr_array_new();
+    int i;
+
+    if (ifile)
+      g_ptr_array_add(inputs, g_strdup(ifile));
+    for (i = 1; i < argc; i++)
+      g_ptr_array_add(inputs, g_strdup(argv[i]));
+
+    err = read_manifest(manifest, inputs);
+    /* the files are then analyzed from the pips of the base, which
+       are extracted only once */
+    if (!err && diff_base && (sitedump || sitearchive || text_dumps()))
+      err = analysis_dbs_add_base(dbs, diff_base, jobs);
+    if (!err)
+      err = debit_batch(inputs, dbs);
+
+    for (i = 0; i < (int) inputs->len; i++)
+      g_free(g_ptr_array_index(inputs, i));
+    g_ptr_array_free(inputs, TRUE);
+  } else
+    err = debit_file(ifile, odir, ofile, dbs, stdout, jobs);
+
+  free_analysis_dbs(dbs);
+
+  if (diff_base)
+    free_bitstream(diff_base);
+ out_free_partial:
+  if (partial_base)
+    free_bitstream(partial_base);
+
+  if (stats)
+    stats_report(stderr, !strcmp(stats, "json"));
   return err;
 }
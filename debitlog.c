@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) 2006, 2007 Jean-Baptiste Note <jean-baptiste.note@m4x.org>
+ *
+ * This file is part of debit.
+ *
+ * Debit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Debit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with debit.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Log message emission
+ */
+
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <glib.h>
+#include <glib/gprintf.h>
+#include "debitlog.h"
+
+typedef void (*log_sink_t)(const gchar *format, va_list args);
+
+static void
+warning_sink(const gchar *format, va_list args) {
+  g_logv(G_LOG_DOMAIN, G_LOG_LEVEL_WARNING, format, args);
+}
+
+/*
+ * Ring buffer. A writer claims a message number by bumping the head,
+ * then takes its record over by swapping the stamp left by an earlier
+ * lap for a busy mark, and publishes the message by writing its own
+ * stamp, the message number plus one. If the record is busy, or a
+ * later lap has it already, the message is dropped rather than being
+ * formatted over another one. The flush copies a message out, then
+ * checks that its stamp did not change meanwhile.
+ */
+
+#define LOG_RECORD_LEN 124
+#define LOG_RECORD_BUSY 0
+
+typedef struct _log_record {
+  volatile gint seq;
+  gchar msg[LOG_RECORD_LEN];
+} log_record_t;
+
+static log_record_t *ring = NULL;
+static guint ring_len = 0;
+static volatile guint ring_head = 0;
+/* first message not flushed yet */
+static guint ring_tail = 0;
+
+static inline guint
+claim_record(void) {
+#if GLIB_CHECK_VERSION(2,30,0)
+  return g_atomic_int_add((volatile gint *) &ring_head, 1);
+#else
+  return g_atomic_int_exchange_and_add((volatile gint *) &ring_head, 1);
+#endif
+}
+
+static inline guint
+record_stamp(log_record_t *record) {
+  return g_atomic_int_get(&record->seq);
+}
+
+/* Stamps wrap around, and are compared as such */
+static inline gboolean
+stamp_before(const guint a, const guint b) {
+  return (gint) (a - b) < 0;
+}
+
+static gboolean
+take_record(log_record_t *record, const guint stamp) {
+  guint old;
+
+  do {
+    old = record_stamp(record);
+    if (old == LOG_RECORD_BUSY || !stamp_before(old, stamp))
+      return FALSE;
+  } while (!g_atomic_int_compare_and_exchange(&record->seq, old,
+					      LOG_RECORD_BUSY));
+
+  return TRUE;
+}
+
+static void
+ring_sink(const gchar *format, va_list args) {
+  const guint idx = claim_record();
+  const guint stamp = idx + 1;
+  log_record_t *record = &ring[idx % ring_len];
+
+  if (stamp == LOG_RECORD_BUSY || !take_record(record, stamp))
+    return;
+
+  g_vsnprintf(record->msg, sizeof(record->msg), format, args);
+  g_atomic_int_set(&record->seq, stamp);
+}
+
+static log_sink_t log_sink = warning_sink;
+
+void
+debit_log_message(const gchar *format, ...) {
+  va_list args;
+  va_start(args, format);
+  log_sink(format, args);
+  va_end(args);
+}
+
+void
+debit_log_flush(void) {
+  guint head, i, lost = 0;
+
+  if (!ring)
+    return;
+
+  head = g_atomic_int_get((volatile gint *) &ring_head);
+
+  /* The messages which were overwritten before this flush */
+  if (head - ring_tail > ring_len) {
+    lost = head - ring_len - ring_tail;
+    ring_tail = head - ring_len;
+  }
+
+  for (i = ring_tail; i != head; i++) {
+    log_record_t *record = &ring[i % ring_len];
+    gchar msg[LOG_RECORD_LEN];
+
+    if (record_stamp(record) != i + 1) {
+      lost++;
+      continue;
+    }
+    memcpy(msg, record->msg, sizeof(msg));
+    if (record_stamp(record) != i + 1) {
+      lost++;
+      continue;
+    }
+    msg[LOG_RECORD_LEN - 1] = '\0';
+    g_warning("%s", msg);
+  }
+
+  ring_tail = head;
+
+  if (lost)
+    g_warning("%u log messages were lost", lost);
+}
+
+void
+debit_log_use_ring(const unsigned nrecords) {
+  static gboolean registered = FALSE;
+  guint before, i;
+
+  debit_log_flush();
+  g_free(ring);
+  ring = NULL;
+  ring_len = 0;
+  log_sink = warning_sink;
+
+  if (!nrecords)
+    return;
+
+  /* The records start with the stamp of a message before the first */
+  ring_tail = ring_head;
+  before = ring_tail != LOG_RECORD_BUSY ? ring_tail : G_MAXUINT;
+  ring = g_new(log_record_t, nrecords);
+  ring_len = nrecords;
+  for (i = 0; i < nrecords; i++)
+    ring[i].seq = before;
+  log_sink = ring_sink;
+
+  if (!registered) {
+    atexit(debit_log_flush);
+    registered = TRUE;
+  }
+}
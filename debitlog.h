@@ -68,18 +68,68 @@ extern unsigned int     debit_debug;
 enum { debit_debug = 0 };
 #endif
 
+/*
+ * The channel test is the only thing inlined at a log point; the
+ * message is formatted and emitted out of line. Hot loops should read
+ * debit_log_enabled() once before the loop and log with debit_log_if(),
+ * so that the test is loop-invariant and can be hoisted or unswitched
+ * by the compiler.
+ */
+
 #if DEBIT_DEBUG > 0
 
+#define debit_log_enabled(chan) G_UNLIKELY(debit_debug & (chan))
+
 #define debit_log(chan, args...) \
 	do { \
-		if (debit_debug & (chan)) \
-			g_warning(args); \
+		if (debit_log_enabled(chan)) \
+			debit_log_message(args); \
+	} while (0)
+
+#define debit_log_if(enabled, args...) \
+	do { \
+		if (G_UNLIKELY(enabled)) \
+			debit_log_message(args); \
 	} while (0)
 
 #else
 
+#define debit_log_enabled(chan) FALSE
 #define debit_log(chan, args...)
+#define debit_log_if(enabled, args...) do { (void) (enabled); } while (0)
 
 #endif
 
+#if defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 3))
+#define DEBIT_GNUC_COLD __attribute__((__cold__))
+#else
+#define DEBIT_GNUC_COLD
+#endif
+
+/** \brief Emit a log message
+ *
+ * The message goes to g_warning, or to the ring buffer if one is in
+ * use.
+ */
+void debit_log_message(const gchar *format, ...)
+	G_GNUC_PRINTF(1, 2) DEBIT_GNUC_COLD;
+
+/** \brief Buffer the log messages in memory
+ *
+ * The messages are then stored in a ring buffer of the given number of
+ * records, without locking, and printed by debit_log_flush or at exit.
+ * When more messages are logged than the buffer holds, the oldest
+ * ones are lost; so is a message whose record is still being written
+ * by another thread. This is not to be called while other threads log.
+ *
+ * @param nrecords the size of the buffer; 0 goes back to g_warning
+ */
+void debit_log_use_ring(const unsigned nrecords);
+
+/** \brief Print and forget the buffered log messages
+ *
+ * The next flush starts after the last message printed.
+ */
+void debit_log_flush(void);
+
 #endif /* _HAS_DEBIT_DEBUG_H */
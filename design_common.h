@@ -54,7 +54,16 @@ const gchar *get_frame(const bitstream_parsed_t *parsed,
 		       const guint top,
 		       const guint idx,
 		       const guint frame) {
-  const gchar *frameptr = *get_frame_loc(parsed, type, row, top, idx, frame);
+  const gchar **frameloc = get_frame_loc(parsed, type, row, top, idx, frame);
+  const gchar *frameptr;
+
+  /* The frame store follows the frame index, so that the frame is
+     found without reading the index itself */
+  if (parsed->frame_store)
+    return parsed->frame_store +
+      (frameloc - parsed->frames[0]) * parsed->frame_stride;
+
+  frameptr = *frameloc;
   g_assert(frameptr != NULL);
   return frameptr;
 }
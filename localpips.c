@@ -35,6 +35,7 @@
 
 /* implements the functions needed to get pips in the db */
 
+#include <string.h>
 #include <glib.h>
 #include "debitlog.h"
 
@@ -46,18 +47,106 @@
 #include "design.h"
 
 #include "cfgbit.h"
+#include "pipcache.h"
+#include "parallel.h"
+
+/*
+ * Structure-of-arrays lookup tables, built from the flat database
+ * whatever its origin.
+ */
+
+static void
+build_pip_lookup(pip_lookup_t *lk, const pipdb_control_t *db) {
+  const unsigned nends = db->pipctrl_len;
+  unsigned nbits = 0, npips = 0, i;
+  guint *ctrlbits;
+
+  for (i = 0; i < nends; i++) {
+    nbits += db->pipctrl[i].ctrlsize;
+    npips += db->pipctrl[i].datasize;
+  }
+
+  lk->nends = nends;
+  lk->endwire = g_new(wire_atom_t, nends);
+  lk->ctrloffset = g_new(unsigned, nends);
+  lk->ctrlsize = g_new(unsigned char, nends);
+  lk->candidates = g_new(unsigned, nends + 1);
+  ctrlbits = g_new(guint, nbits);
+  lk->startwire = g_new(wire_atom_t, npips);
+  lk->cfgdata = g_new(guint32, npips);
+
+  nbits = 0;
+  npips = 0;
+  for (i = 0; i < nends; i++) {
+    const pip_control_t *head = &db->pipctrl[i];
+    const uint32_t *bits = &db->pipctrldata[head->ctrloffset];
+    const pip_data_t *data = &db->pipdatadata[head->dataoffset];
+    unsigned j;
+
+    lk->endwire[i] = head->endwire;
+    lk->ctrloffset[i] = nbits;
+    lk->ctrlsize[i] = head->ctrlsize;
+    lk->candidates[i] = npips;
+
+    for (j = 0; j < head->ctrlsize; j++)
+      ctrlbits[nbits++] = bits[j];
+
+    for (j = 0; j < head->datasize; j++, npips++) {
+      lk->startwire[npips] = data[j].startwire;
+      lk->cfgdata[npips] = data[j].cfgdata;
+    }
+  }
+  lk->candidates[nends] = npips;
+
+  lk->plan = gather_plan_new(ctrlbits, nbits);
+  g_free(ctrlbits);
+
+  /* Without a plan, no pip can be found for this switch type */
+  if (!lk->plan)
+    lk->nends = 0;
+}
+
+static void
+free_pip_lookup(pip_lookup_t *lk) {
+  g_free(lk->endwire);
+  g_free(lk->ctrloffset);
+  g_free(lk->ctrlsize);
+  g_free(lk->candidates);
+  gather_plan_free(lk->plan);
+  g_free(lk->startwire);
+  g_free(lk->cfgdata);
+  lk->nends = 0;
+}
+
+static void
+build_pip_lookups(pip_db_t *pipdb) {
+  guint i;
+  for (i = 0; i < NR_SWITCH_TYPE; i++)
+    build_pip_lookup(&pipdb->lookup[i], &pipdb->memorydb[i]);
+}
+
+static void
+free_pip_lookups(pip_db_t *pipdb) {
+  guint i;
+  for (i = 0; i < NR_SWITCH_TYPE; i++)
+    free_pip_lookup(&pipdb->lookup[i]);
+}
 
 #ifdef __COMPILED_PIPSDB
 
 /* The data */
 #if defined(VIRTEX2)
 #include "data/virtex2/pips.h"
+#include "data/virtex2/pipsstamp.h"
 #elif defined(VIRTEX4)
 #include "data/virtex4/pips.h"
+#include "data/virtex4/pipsstamp.h"
 #elif defined(VIRTEX5)
 #include "data/virtex5/pips.h"
+#include "data/virtex5/pipsstamp.h"
 #elif defined(SPARTAN3)
 #include "data/spartan3/pips.h"
+#include "data/spartan3/pipsstamp.h"
 #else
 #error "Could not compile in pip db"
 #endif
@@ -73,6 +162,8 @@ get_pipdb(const gchar *datadir) {
     return NULL;
   }
   ret->memorydb = &dbrefs[0];
+  ret->stamp = PIPSDB_STAMP;
+  build_pip_lookups(ret);
   return ret;
 }
 
@@ -80,66 +171,10 @@ void
 free_pipdb(pip_db_t *pipdb) {
   if (pipdb->wiredb)
     free_wiredb(pipdb->wiredb);
+  free_pip_lookups(pipdb);
   g_free(pipdb);
 }
 
-/* The iterators, rewritten */
-static void
-__pips_of_site_append(const pip_db_t *pipdb,
-		      const bitstream_parsed_t *bitstream,
-		      const csite_descr_t *site,
-		      GArray *pips_array) {
-  const wire_db_t *wiredb = pipdb->wiredb;
-  const switch_type_t sw = sw_of_type(site->type);
-  const pipdb_control_t *memorydb = &pipdb->memorydb[sw];
-
-  const pip_control_t *head = memorydb->pipctrl;
-  const pip_control_t *head_end = head + memorydb->pipctrl_len;
-
-  const uint32_t *ctrldata_array = memorydb->pipctrldata;
-
-  if (!memorydb)
-    return;
-
-  for (; head < head_end; head++) {
-    const uint32_t bitdata = query_bitstream_site_bits(bitstream, site, &ctrldata_array[head->ctrloffset], head->ctrlsize);
-    const wire_atom_t endwire = head->endwire;
-    const char *end = wire_name(wiredb,endwire);
-
-    /* prepare the next iterator */
-    const pip_data_t *cfgdata_array = &memorydb->pipdatadata[head->dataoffset];
-    unsigned spend = head->datasize;
-    unsigned sp;
-
-    if (bitdata == 0)
-      continue;
-
-    for (sp = 0; sp < spend; sp++) {
-      const pip_data_t *cfgdata_descr = cfgdata_array + sp;
-      const uint32_t cfgdata = cfgdata_descr->cfgdata;
-
-      if ( (cfgdata & bitdata) == cfgdata ) {
-	const wire_atom_t startwire = cfgdata_descr->startwire;
-	pip_t pip = { .source = startwire, .target = endwire };
-	g_array_append_val(pips_array, pip);
-
-	if (cfgdata != bitdata) {
-	  const char *start = wire_name(wiredb, startwire);
-	  debit_log(L_PIPS, "Spurious bits for %s -> %s, config %i != bitdata %i",
-		    start,end,cfgdata,bitdata);
-	  (void) start;
-	}
-
-	break;
-      }
-
-    } /* for sp */
-    (void) end;
-
-  } /* for head */
-  return;
-}
-
 #else /* __COMPILED_PIPSDB */
 
 #define STRINGCHUNK_DEFAULT_SIZE 16
@@ -155,6 +190,7 @@ static int build_connextree_from_keyfiles(GKeyFile *data, GKeyFile *control,
                                           wire_db_t *wires, GNode *head,
                                           const site_type_t type);
 static void destroy_datatree(GNode *head);
+static void flatten_datatree(GNode *head, pipdb_control_t *flat);
 
 #if defined(VIRTEX2)
 
@@ -275,16 +311,17 @@ read_implicitdb(wire_db_t *wiredb, const gchar *datadir,
  * pip_db_t structure, in-code view of the database.
  *
  * @param pipdb the already-alloced pipdb structure to be filled in
- * @param control the name of the control db file to read
- * @param data the name of the data db file to read
+ * @param datadir the directory containing the database files
+ * @param flat the flat pip databases to fill in, or NULL if the pip
+ * database has already been loaded from the cache
  *
  * @return the status of the operation
  * @see pip_db_t
  */
 
-#include <string.h>
 static int
-read_db_from_file(pip_db_t *pipdb, const gchar *datadir) {
+read_db_from_file(pip_db_t *pipdb, const gchar *datadir,
+		  pipdb_control_t *flat) {
   int err = 0;
   GNode *dbnode;
   guint i;
@@ -297,12 +334,16 @@ read_db_from_file(pip_db_t *pipdb, const gchar *datadir) {
 
     pipdb->implicitdb[i] = read_implicitdb(pipdb->wiredb, datadir, base, "implicit.db");
 
-    dbnode = g_node_new(NULL);
-    err = read_switchdb(pipdb, dbnode, i, datadir, base,
-			"control.db", "data.db");
-    if (err)
-      goto out_err;
-    pipdb->memorydb[i] = dbnode;
+    if (flat) {
+      dbnode = g_node_new(NULL);
+      err = read_switchdb(pipdb, dbnode, i, datadir, base,
+			  "control.db", "data.db");
+      if (!err)
+	flatten_datatree(dbnode, &flat[i]);
+      destroy_datatree(dbnode);
+      if (err)
+	return err;
+    }
 
     dbnode = g_node_new(NULL);
     err = read_connexdb(pipdb, dbnode, i, datadir, base,
@@ -315,19 +356,106 @@ read_db_from_file(pip_db_t *pipdb, const gchar *datadir) {
   }
 
   return err;
+}
 
- out_err:
-  free_pipdb (pipdb);
-  return err;
+/*
+ * Flat image of the memory database, and its cache
+ */
+
+/* The cache is tied to the files it was built from */
+static guint64
+memorydb_stamp(const gchar *datadir) {
+  GPtrArray *files = g_ptr_array_new();
+  guint64 stamp;
+  guint i;
+
+  g_ptr_array_add(files, g_build_filename(datadir,CHIP,"wires.db",NULL));
+  for (i = 0; i < NR_SWITCH_TYPE; i++) {
+    const gchar *base = basedbnames[i];
+
+    if (!base)
+      continue;
+
+    g_ptr_array_add(files, g_build_filename(datadir,CHIP,base,"control.db",NULL));
+    g_ptr_array_add(files, g_build_filename(datadir,CHIP,base,"data.db",NULL));
+  }
+  g_ptr_array_add(files, NULL);
+
+  stamp = pipcache_stamp((const gchar **)files->pdata);
+  g_strfreev((gchar **)g_ptr_array_free(files, FALSE));
+  return stamp;
+}
+
+static int
+load_memorydb_cache(pip_db_t *pipdb,
+		    const gchar *filename, const guint64 stamp) {
+  GMappedFile *file = pipcache_map(filename);
+  int err;
+
+  if (!file)
+    return -1;
+
+  err = pipcache_image_bind(pipdb->memorydb, NR_SWITCH_TYPE,
+			    g_mapped_file_get_contents(file),
+			    g_mapped_file_get_length(file),
+			    pipdb->wiredb->dblen, stamp);
+  if (err) {
+    g_mapped_file_free(file);
+    return err;
+  }
+
+  debit_log(L_PIPS, "pip database mapped from %s", filename);
+  pipdb->cache = file;
+  return 0;
+}
+
+static int
+store_memorydb_image(pip_db_t *pipdb, const pipdb_control_t *flat,
+		     const gchar *filename, const guint64 stamp) {
+  gsize len;
+  gchar *image = pipcache_image_new(flat, NR_SWITCH_TYPE,
+				    pipdb->wiredb->dblen, stamp, &len);
+  int err;
+
+  err = pipcache_image_bind(pipdb->memorydb, NR_SWITCH_TYPE,
+			    image, len, pipdb->wiredb->dblen, stamp);
+  if (err) {
+    g_free(image);
+    return err;
+  }
+  pipdb->image = image;
+
+  /* Not being able to write the cache is not an error */
+  if (pipcache_write(filename, image, len))
+    g_warning("could not write pip database cache %s", filename);
+
+  return 0;
+}
+
+static void
+free_flatdb(pipdb_control_t *flat) {
+  guint i;
+  for (i = 0; i < NR_SWITCH_TYPE; i++) {
+    g_free((pip_control_t *)flat[i].pipctrl);
+    g_free((uint32_t *)flat[i].pipctrldata);
+    g_free((pip_data_t *)flat[i].pipdatadata);
+  }
 }
 
 /** \brief Allocate and fill a pip database
  *
- * Load a new database into memory
+ * Load a new database into memory. The pip database proper is mapped
+ * from the cache if it is up to date; otherwise it is read from the
+ * keyfiles, and the cache is written for the next run.
  */
 pip_db_t *
 get_pipdb(const gchar *datadir) {
+  pipdb_control_t flat[NR_SWITCH_TYPE];
+  gboolean cached;
+  gchar *cachename;
+  guint64 stamp;
   pip_db_t *ret;
+  int err;
 
   ret = g_new0(pip_db_t, 1);
 
@@ -338,9 +466,25 @@ get_pipdb(const gchar *datadir) {
     return NULL;
   }
 
-  if (read_db_from_file(ret,datadir))
+  stamp = memorydb_stamp(datadir);
+  ret->stamp = stamp;
+  cachename = pipcache_filename(datadir);
+  cached = (load_memorydb_cache(ret, cachename, stamp) == 0);
+
+  memset(flat, 0, sizeof(flat));
+  err = read_db_from_file(ret, datadir, cached ? NULL : flat);
+  if (!err && !cached)
+    err = store_memorydb_image(ret, flat, cachename, stamp);
+
+  free_flatdb(flat);
+  g_free(cachename);
+
+  if (err) {
+    free_pipdb(ret);
     return NULL;
+  }
 
+  build_pip_lookups(ret);
   return ret;
 }
 
@@ -372,10 +516,14 @@ free_pipdb(pip_db_t *pipdb) {
 
   for(i = 0; i < NR_SWITCH_TYPE; i++) {
     free_impldb (&pipdb->implicitdb[i]);
-    free_datadb (&pipdb->memorydb[i]);
     free_datadb (&pipdb->connexdb[i]);
   }
 
+  free_pip_lookups(pipdb);
+  if (pipdb->cache)
+    g_mapped_file_free(pipdb->cache);
+  g_free(pipdb->image);
+
   g_free(pipdb);
 }
 
@@ -719,6 +867,77 @@ destroy_datatree(GNode *head) {
   return;
 }
 
+/** \brief Flatten the memory database
+ *
+ * Convert the tree built from the keyfiles into the array layout of the
+ * compiled database. The order of the endpoints, and of the pips for
+ * each endpoint, is kept.
+ *
+ */
+
+typedef struct _flatten_db {
+  GArray *ctrl;
+  GArray *ctrldata;
+  GArray *data;
+} flatten_db_t;
+
+static void
+flatten_wirenode(GNode *node, gpointer data) {
+  const localpip_data_t *dat = node->data;
+  GArray *pipdata = data;
+  pip_data_t entry;
+
+  /* clear the padding, which ends up in the cache */
+  memset(&entry, 0, sizeof(entry));
+  entry.startwire = dat->startwire;
+  entry.cfgdata = dat->cfgdata;
+  g_array_append_val(pipdata, entry);
+}
+
+static void
+flatten_groupnode(GNode *node, gpointer data) {
+  const localpip_control_data_t *ctrldat = node->data;
+  const guint npips = g_node_n_children(node);
+  flatten_db_t *flat = data;
+  pip_control_t head;
+
+  if (!ctrldat->data)
+    return;
+
+  if (ctrldat->size > 32 || npips > G_MAXUINT8) {
+    g_warning("endpoint #%i too large for the flat pip database",
+	      ctrldat->endwire);
+    return;
+  }
+
+  memset(&head, 0, sizeof(head));
+  head.endwire = ctrldat->endwire;
+  head.ctrloffset = flat->ctrldata->len;
+  head.ctrlsize = ctrldat->size;
+  head.dataoffset = flat->data->len;
+  head.datasize = npips;
+
+  g_array_append_vals(flat->ctrldata, ctrldat->data, ctrldat->size);
+  g_node_children_foreach(node, G_TRAVERSE_ALL, flatten_wirenode, flat->data);
+  g_array_append_val(flat->ctrl, head);
+}
+
+static void
+flatten_datatree(GNode *head, pipdb_control_t *db) {
+  flatten_db_t flat = {
+    .ctrl = g_array_new(FALSE, FALSE, sizeof(pip_control_t)),
+    .ctrldata = g_array_new(FALSE, FALSE, sizeof(uint32_t)),
+    .data = g_array_new(FALSE, FALSE, sizeof(pip_data_t)),
+  };
+
+  iterate_over_groups_memory(head, flatten_groupnode, &flat);
+
+  db->pipctrl_len = flat.ctrl->len;
+  db->pipctrl = (pip_control_t *) g_array_free(flat.ctrl, FALSE);
+  db->pipctrldata = (uint32_t *) g_array_free(flat.ctrldata, FALSE);
+  db->pipdatadata = (pip_data_t *) g_array_free(flat.data, FALSE);
+}
+
 /*
  * Democode, print the DB
  */
@@ -757,106 +976,6 @@ static guint32 get_pip_data_from_file(GKeyFile *keyfile,
   return g_key_file_get_integer(keyfile, end, start, NULL);
 }
 
-typedef struct _examine_data_memory {
-  guint32 bitstream_data;
-  /* at some point get rid of wiredb and endwire */
-  wire_db_t *wiredb;
-  wire_atom_t endwire;
-  wire_atom_t startwire;
-  gboolean found;
-} examine_data_memory_t;
-
-static void examine_node_memory (GNode *node,
-				 gpointer data) {
-  examine_data_memory_t *exam_arg = data;
-  localpip_data_t *cfgarg = node->data;
-  wire_db_t *wiredb = exam_arg->wiredb;
-  const gchar *end = wire_name(wiredb,exam_arg->endwire);
-  const gchar *start = wire_name(wiredb,cfgarg->startwire);
-  const guint32 cfgdata = cfgarg->cfgdata;
-  const guint32 bitdata = exam_arg->bitstream_data;
-
-  if ( (cfgdata & bitdata) == cfgdata ) {
-    if (cfgdata != bitdata)
-      debit_log(L_PIPS, "Spurious bits for %s -> %s, config %i != bitdata %i",
-		start,end,cfgdata,bitdata);
-    if (exam_arg->found) {
-      debit_log(L_PIPS, "Not replacing %s -> %s",
-		wire_name(wiredb,exam_arg->startwire),end);
-    }
-    else {
-      exam_arg->found = TRUE;
-      exam_arg->startwire = cfgarg->startwire;
-    }
-  }
-  (void) start;
-  (void) end;
-}
-
-typedef struct _examine_endpoint_memory {
-  const bitstream_parsed_t *bitstream;
-  const csite_descr_t *site;
-  /* at some point get rid of wiredb */
-  wire_db_t *wiredb;
-  GArray *array;
-} examine_endpoint_memory_t;
-
-static void
-examine_groupnode (GNode *node, gpointer data) {
-  localpip_control_data_t *ctrldat = node->data;
-  const examine_endpoint_memory_t *exam_arg = data;
-  wire_db_t * wiredb = exam_arg->wiredb;
-  const wire_atom_t endwire = ctrldat->endwire;
-  examine_data_memory_t pass_arg = {
-    .endwire = endwire,
-    .found = FALSE,
-    .wiredb = wiredb,
-  };
-  guint32 bitdata;
-
-  /* query the bitstream about the endpoint */
-  bitdata = query_bitstream_site_bits(exam_arg->bitstream, exam_arg->site,
-				      ctrldat->data, ctrldat->size);
-
-  if (bitdata == 0)
-    return;
-
-  pass_arg.bitstream_data = bitdata;
-
-  /* iterate over pips to find out who is okay. This could just be an array. */
-  /* XXX use g_node_traverse (node, G_POST_ORDER, G_TRAVERSE_LEAVES, 2,)
-     to slightly speedup the process.
-  */
-  g_node_children_foreach(node,G_TRAVERSE_ALL,examine_node_memory,&pass_arg);
-
-  if (pass_arg.found) {
-    pip_t pip = { .source = pass_arg.startwire, .target = endwire };
-    GArray *array = exam_arg->array;
-    g_array_append_val(array, pip);
-  }
-}
-
-static void
-__pips_of_site_append(const pip_db_t *pipdb,
-		      const bitstream_parsed_t *bitstream,
-		      const csite_descr_t *site,
-		      GArray *pips_array) {
-  switch_type_t swbox = sw_of_type(site->type);
-  GNode *head = pipdb->memorydb[swbox];
-  const examine_endpoint_memory_t exam_arg = {
-    .bitstream = bitstream,
-    .site = site,
-    .array = pips_array,
-    .wiredb = pipdb->wiredb,
-  };
-  void *arg = (void *)&exam_arg;
-
-  if (!head)
-    return;
-
-  iterate_over_groups_memory(head, examine_groupnode, arg);
-}
-
 /***
  * Implicit pip database
  */
@@ -1002,8 +1121,8 @@ static gboolean
 _get_implicit_startpoint(wire_atom_t *wire,
 			 const pip_db_t *pipdb,
 			 const wire_atom_t orig,
-			 const site_type_t stype) {
-  GNode *db = pipdb->implicitdb[stype];
+			 const switch_type_t sw) {
+  GNode *db = pipdb->implicitdb[sw];
 
   if (db)
     return query_impldb(db, wire, orig);
@@ -1012,6 +1131,66 @@ _get_implicit_startpoint(wire_atom_t *wire,
 
 #endif /* __COMPILED_PIPSDB */
 
+/*
+ * Both database flavours share the same lookup tables, so that the
+ * iterator is the same for both. This is the innermost loop of the
+ * whole pip extraction: the configuration bytes of the site are
+ * gathered once, then for each endpoint its bits are extracted from
+ * them, and a linear scan of contiguous cfgdata words is done; the
+ * first match wins.
+ */
+static void
+__pips_of_site_append(const pip_db_t *pipdb,
+		      const bitstream_parsed_t *bitstream,
+		      const csite_descr_t *site,
+		      GArray *pips_array) {
+  const switch_type_t sw = sw_of_type(site->type);
+  const pip_lookup_t *lk = &pipdb->lookup[sw];
+  const unsigned nends = lk->nends;
+  const guint32 *cfgdata = lk->cfgdata;
+  const gather_plan_t *plan = lk->plan;
+  const gboolean trace = debit_log_enabled(L_PIPS);
+  guchar *bytes, any = 0;
+  unsigned i;
+
+  if (nends == 0)
+    return;
+
+  bytes = g_alloca(plan->nbytes);
+  query_bitstream_site_gather(bitstream, site, plan, bytes);
+
+  /* Unconfigured sites are the common case */
+  for (i = 0; i < plan->nbytes; i++)
+    any |= bytes[i];
+  if (!any)
+    return;
+
+  for (i = 0; i < nends; i++) {
+    const guint32 bitdata =
+      gather_plan_bits(plan, bytes, lk->ctrloffset[i], lk->ctrlsize[i]);
+    unsigned sp = lk->candidates[i];
+    const unsigned spend = lk->candidates[i+1];
+
+    if (bitdata == 0)
+      continue;
+
+    for (; sp < spend; sp++)
+      if ((cfgdata[sp] & bitdata) == cfgdata[sp])
+	break;
+
+    if (sp < spend) {
+      pip_t pip = { .source = lk->startwire[sp], .target = lk->endwire[i] };
+      g_array_append_val(pips_array, pip);
+
+      if (cfgdata[sp] != bitdata)
+	debit_log_if(trace, "Spurious bits for %s -> %s, config %i != bitdata %i",
+		     wire_name(pipdb->wiredb, pip.source),
+		     wire_name(pipdb->wiredb, pip.target),
+		     cfgdata[sp], bitdata);
+    }
+  }
+}
+
 /** \brief Query a bitstream for the pips contained in a site, in-memory version
  *
  * This is a very raw unoptimized version which should be must faster already
@@ -1117,12 +1296,123 @@ _pips_of_bitstream(const pip_db_t *pipdb, const chip_descr_t *chipdb,
   return 0;
 }
 
+/*
+ * Parallel version. Sites are independent reads over the bitstream, so
+ * rows are dealt round-robin to the workers, which each append to their
+ * own array. The site index is written in place with offsets local to
+ * the worker, and everything is then stitched back in site order, so
+ * that the result is exactly the one of the serial version.
+ */
+
+typedef struct _pips_worker {
+  const bitstream_parsed_t *bitstream;
+  const pip_db_t *pipdb;
+  const chip_descr_t *chipdb;
+  unsigned first_row;
+  unsigned stride;
+  /* shared, but each worker only touches its own rows */
+  unsigned *site_index;
+  unsigned *row_index;
+  /* private to the worker */
+  GArray *array;
+} pips_worker_t;
+
+static gpointer
+_pips_of_rows(gpointer data) {
+  pips_worker_t *worker = data;
+  const chip_descr_t *chipdb = worker->chipdb;
+  const unsigned width = chipdb->width, height = chipdb->height;
+  GArray *pips_array = worker->array;
+  unsigned x, y;
+
+  for (y = worker->first_row; y < height; y += worker->stride) {
+    const unsigned first_site = y * width;
+    const csite_descr_t *site = &chipdb->data[first_site];
+
+    worker->row_index[y] = pips_array->len;
+    for (x = 0; x < width; x++) {
+      worker->site_index[first_site + x] = pips_array->len;
+      __pips_of_site_append(worker->pipdb, worker->bitstream,
+			    site++, pips_array);
+    }
+  }
+
+  return NULL;
+}
+
+static int
+_pips_of_bitstream_parallel(const pip_db_t *pipdb, const chip_descr_t *chipdb,
+			    const bitstream_parsed_t *bitstream,
+			    pip_parsed_dense_t *fill, const unsigned jobs) {
+  const unsigned width = chipdb->width, height = chipdb->height;
+  const unsigned nsites = width * height;
+  unsigned *site_index_a = g_new0(unsigned, nsites + 1);
+  unsigned *row_index = g_new(unsigned, height);
+  pips_worker_t *workers = g_new(pips_worker_t, jobs);
+  pip_t *bitpips;
+  unsigned i, x, y, total = 0;
+
+  for (i = 0; i < jobs; i++) {
+    pips_worker_t *worker = &workers[i];
+    worker->bitstream = bitstream;
+    worker->pipdb = pipdb;
+    worker->chipdb = chipdb;
+    worker->first_row = i;
+    worker->stride = jobs;
+    worker->site_index = site_index_a;
+    worker->row_index = row_index;
+    worker->array = g_array_new(FALSE, FALSE, sizeof(pip_t));
+  }
+
+  run_workers("pips", _pips_of_rows, workers, sizeof(pips_worker_t), jobs);
+
+  for (i = 0; i < jobs; i++)
+    total += workers[i].array->len;
+  bitpips = g_new(pip_t, total);
+
+  /* Stitch the rows back in order */
+  total = 0;
+  for (y = 0; y < height; y++) {
+    const pips_worker_t *worker = &workers[y % jobs];
+    const unsigned start = row_index[y];
+    const unsigned end = (y + jobs < height) ?
+      row_index[y + jobs] : worker->array->len;
+    unsigned *site_index = &site_index_a[y * width];
+
+    for (x = 0; x < width; x++)
+      site_index[x] = site_index[x] - start + total;
+    memcpy(&bitpips[total], &g_array_index(worker->array, pip_t, start),
+	   (end - start) * sizeof(pip_t));
+    total += end - start;
+  }
+
+  site_index_a[nsites] = total;
+  debit_log(L_PIPS, "Got %i explicit pips using %i threads", total, jobs);
+
+  for (i = 0; i < jobs; i++)
+    g_array_free(workers[i].array, TRUE);
+  g_free(workers);
+  g_free(row_index);
+
+  fill->site_index = site_index_a;
+  fill->bitpips = bitpips;
+
+  return 0;
+}
+
 pip_parsed_dense_t *
 pips_of_bitstream(const pip_db_t *pipdb, const chip_descr_t *chipdb,
-		  const bitstream_parsed_t *bitstream) {
-  pip_parsed_dense_t *dense = g_new(pip_parsed_dense_t, 1);
+		  const bitstream_parsed_t *bitstream, unsigned jobs) {
+  pip_parsed_dense_t *dense = g_new0(pip_parsed_dense_t, 1);
   int err;
-  err = _pips_of_bitstream(pipdb, chipdb, bitstream, dense);
+
+  /* There is no point in having more threads than rows */
+  jobs = MIN(jobs, chipdb->height);
+
+  if (jobs > 1)
+    err = _pips_of_bitstream_parallel(pipdb, chipdb, bitstream, dense, jobs);
+  else
+    err = _pips_of_bitstream(pipdb, chipdb, bitstream, dense);
   if (err) {
     g_free(dense);
     return NULL;
@@ -1131,11 +1421,139 @@ pips_of_bitstream(const pip_db_t *pipdb, const chip_descr_t *chipdb,
 }
 
 void free_pipdat(pip_parsed_dense_t *pipdat) {
-  g_free(pipdat->site_index);
-  g_free(pipdat->bitpips);
+  if (pipdat->file)
+    g_mapped_file_free(pipdat->file);
+  else {
+    g_free(pipdat->site_index);
+    g_free(pipdat->bitpips);
+  }
   g_free(pipdat);
 }
 
+/*
+ * Frame map. The frames of a site are consecutive in the frame index,
+ * so that the map is built in two passes over the sites, the first one
+ * counting the sites of each frame.
+ */
+
+static inline gboolean
+site_has_pips(const pip_db_t *pipdb, const csite_descr_t *site) {
+  return pipdb->lookup[sw_of_type(site->type)].nends != 0;
+}
+
+frame_map_t *
+get_frame_map(const pip_db_t *pipdb, const chip_descr_t *chip,
+	      const bitstream_parsed_t *bitstream) {
+  const gsize nframes = bitstream_frame_count(bitstream);
+  const unsigned nsites = chip->width * chip->height;
+  frame_map_t *map = g_new(frame_map_t, 1);
+  guint *index = g_new0(guint, nframes + 1);
+  guint *fill = g_new(guint, nframes);
+  gsize *first = g_new(gsize, nsites);
+  guint *count = g_new0(guint, nsites);
+  site_ref_t *sites;
+  unsigned i, j;
+  gsize f;
+
+  for (i = 0; i < nsites; i++) {
+    const csite_descr_t *site = &chip->data[i];
+    if (!site_has_pips(pipdb, site))
+      continue;
+    count[i] = query_bitstream_site_frames(bitstream, site, &first[i]);
+    for (j = 0; j < count[i]; j++)
+      index[first[i] + j + 1]++;
+  }
+
+  for (f = 0; f < nframes; f++) {
+    index[f + 1] += index[f];
+    fill[f] = index[f];
+  }
+
+  sites = g_new(site_ref_t, index[nframes]);
+  for (i = 0; i < nsites; i++)
+    for (j = 0; j < count[i]; j++)
+      sites[fill[first[i] + j]++] = i;
+
+  g_free(count);
+  g_free(first);
+  g_free(fill);
+
+  map->nframes = nframes;
+  map->index = index;
+  map->sites = sites;
+  return map;
+}
+
+void
+free_frame_map(frame_map_t *map) {
+  g_free(map->index);
+  g_free(map->sites);
+  g_free(map);
+}
+
+/*
+ * Incremental extraction. The sites touched by the changed frames are
+ * decoded again, and the runs of sites in between are copied over from
+ * the previous pips in one go.
+ */
+
+pip_parsed_dense_t *
+pips_of_bitstream_update(const pip_db_t *pipdb, const chip_descr_t *chipdb,
+			 const bitstream_parsed_t *bitstream,
+			 const frame_map_t *map,
+			 const pip_parsed_dense_t *previous,
+			 const guint32 *frames, const gsize nframes) {
+  const unsigned nsites = chipdb->width * chipdb->height;
+  const unsigned *prev_index = previous->site_index;
+  pip_parsed_dense_t *dense = g_new0(pip_parsed_dense_t, 1);
+  unsigned *site_index_a = g_new(unsigned, nsites + 1);
+  GArray *pips_array = g_array_sized_new(FALSE, FALSE, sizeof(pip_t),
+					 prev_index[nsites]);
+  guint8 *dirty = g_new0(guint8, nsites);
+  unsigned i, j, ndirty = 0;
+  gsize f;
+
+  for (f = 0; f < nframes; f++) {
+    guint n;
+    const site_ref_t *sites = sites_of_frame(map, frames[f], &n);
+    for (j = 0; j < n; j++)
+      dirty[sites[j]] = 1;
+  }
+
+  for (i = 0; i < nsites; ) {
+    const unsigned first = i;
+    unsigned start, end;
+
+    if (dirty[i]) {
+      site_index_a[i] = pips_array->len;
+      __pips_of_site_append(pipdb, bitstream, &chipdb->data[i], pips_array);
+      ndirty++;
+      i++;
+      continue;
+    }
+
+    while (i < nsites && !dirty[i])
+      i++;
+
+    /* the sites from first to i are clean */
+    start = prev_index[first];
+    end = prev_index[i];
+    for (j = first; j < i; j++)
+      site_index_a[j] = prev_index[j] - start + pips_array->len;
+    g_array_append_vals(pips_array, &previous->bitpips[start], end - start);
+  }
+
+  site_index_a[nsites] = pips_array->len;
+  debit_log(L_PIPS, "Got %i explicit pips, decoding %u sites out of %u",
+	    pips_array->len, ndirty, nsites);
+
+  dense->site_index = site_index_a;
+  dense->bitpips = (pip_t *)g_array_free(pips_array, FALSE);
+
+  g_free(dirty);
+  return dense;
+}
+
 /** \brief Query the pip database to get the origin of a pip
  *
  * This function guarantees that the spip won't be touched if
@@ -1192,11 +1610,12 @@ iterate_over_bitpips(const pip_parsed_dense_t *pipdat,
   unsigned *indexes = pipdat->site_index;
   pip_t *bitpips = pipdat->bitpips;
   unsigned start = 0;
+  const gboolean trace = debit_log_enabled(L_PIPS);
 
   for (site = 0; site < nsites; site++) {
       unsigned end = indexes[site+1];
       for ( ; start < end; start++) {
-	debit_log(L_PIPS, "calling iterator for site #%i", site);
+	debit_log_if(trace, "calling iterator for site #%i", site);
 	fun(data, bitpips[start], site);
       }
   }
@@ -1224,6 +1643,7 @@ iterate_over_bitpips_complex(const pip_parsed_dense_t *pipdat,
   unsigned *indexes = pipdat->site_index;
   pip_t *bitpips = pipdat->bitpips;
   unsigned start = 0;
+  const gboolean trace = debit_log_enabled(L_PIPS);
 
   for (site = 0; site < nsites; site++) {
     unsigned end = indexes[site+1];
@@ -1233,7 +1653,7 @@ iterate_over_bitpips_complex(const pip_parsed_dense_t *pipdat,
       start = end;
 
     for ( ; start < end; start++) {
-      debit_log(L_PIPS, "calling iterator for site #%i", site);
+      debit_log_if(trace, "calling iterator for site #%i", site);
       fun2(data, bitpips[start], site);
     }
   }
@@ -1251,8 +1671,8 @@ get_implicit_startpoint(wire_atom_t *wire,
 			const chip_descr_t *chip,
 			const wire_atom_t orig,
 			const site_ref_t site) {
-  site_type_t stype = site_type(chip,site);
-  return _get_implicit_startpoint(wire, pipdb, orig, stype);
+  const switch_type_t sw = sw_of_type(site_type(chip,site));
+  return _get_implicit_startpoint(wire, pipdb, orig, sw);
 }
 
 /*
@@ -1398,44 +1818,6 @@ iter_logic_input(const pip_db_t *pipdb,
   iterate_input_wires(set, size, array, logcall, data);
 }
 
-/* Pip database query */
-static inline void
-gather_db_data(const GNode *base,
-	       const unsigned **cfgbits, size_t *nbits,
-	       uint32_t *vals) {
-  const localpip_data_t *dat = base->data;
-  const GNode *nodectrl = base->parent;
-  const localpip_control_data_t *ctrl = nodectrl->data;
-  *cfgbits = ctrl->data;
-  *vals = dat->cfgdata;
-  *nbits = ctrl->size;
-}
-
-/*
- * Return the GNode associated to a logic pip.
- * And Nil if not found.
- */
-
-int
-bitpip_lookup(const sited_pip_t spip,
-	      const chip_descr_t *chip,
-	      const pip_db_t *pipdb,
-	      const unsigned **cfgbits, size_t *nbits,
-	      uint32_t *vals) {
-  const site_type_t stype = site_type(chip, spip.site);
-  const GNode *database = pipdb->memorydb[stype];
-  const GNode *base = db_lookup(spip.pip.source, spip.pip.target, database);
-
-  if (!base) {
-    debit_log(L_PIPS, "bitpip lookup failed");
-    return -1;
-  }
-
-  gather_db_data(base, cfgbits, nbits, vals);
-  debit_log(L_PIPS, "bitpip lookup succeeded with value %08x", *vals);
-  return 0;
-}
-
 #else /* __COMPILED_PIPSDB */
 
 
@@ -1450,15 +1832,42 @@ get_implicit_startpoint(wire_atom_t *wire,
   return FALSE;
 }
 
+#endif /* __COMPILED_PIPSDB */
+
+/*
+ * Pip database query
+ */
+
 int
 bitpip_lookup(const sited_pip_t spip,
 	      const chip_descr_t *chip,
 	      const pip_db_t *pipdb,
 	      const unsigned **cfgbits, size_t *nbits,
 	      uint32_t *vals) {
-  (void) spip; (void) chip; (void) pipdb;
-  (void) cfgbits; (void) nbits; (void) vals;
+  const switch_type_t sw = sw_of_type(site_type(chip, spip.site));
+  const pipdb_control_t *memorydb = &pipdb->memorydb[sw];
+  const pip_control_t *head = memorydb->pipctrl;
+  const pip_control_t *head_end = head + memorydb->pipctrl_len;
+
+  for (; head < head_end; head++) {
+    const pip_data_t *data = &memorydb->pipdatadata[head->dataoffset];
+    const pip_data_t *data_end = data + head->datasize;
+
+    if (head->endwire != spip.pip.target)
+      continue;
+
+    for (; data < data_end; data++) {
+      if (data->startwire != spip.pip.source)
+	continue;
+
+      *cfgbits = &memorydb->pipctrldata[head->ctrloffset];
+      *nbits = head->ctrlsize;
+      *vals = data->cfgdata;
+      debit_log(L_PIPS, "bitpip lookup succeeded with value %08x", *vals);
+      return 0;
+    }
+  }
+
+  debit_log(L_PIPS, "bitpip lookup failed");
   return -1;
 }
-
-#endif /* __COMPILED_PIPSDB */
@@ -37,13 +37,39 @@ typedef enum
  * This is an abstract view of the pip database for a chip.
  */
 
-#ifdef __COMPILED_PIPSDB
-
 #include "data/pips_compiled_common.h"
+#include "bitgather.h"
+
+/** Structure-of-arrays view of the pip database of a switch type
+ *
+ * This is what the pip extraction loop scans for every site. The
+ * candidate pips of endpoint i are the indexes from candidates[i] to
+ * candidates[i+1] of the startwire and cfgdata arrays, in database
+ * order. Its control bits are the bits ctrloffset[i] to
+ * ctrloffset[i]+ctrlsize[i] of the gather plan.
+ */
+typedef struct _pip_lookup {
+  unsigned nends;
+  /* per endpoint */
+  wire_atom_t *endwire;
+  unsigned *ctrloffset;
+  unsigned char *ctrlsize;
+  unsigned *candidates;
+  /* control bits of all endpoints */
+  gather_plan_t *plan;
+  /* per candidate pip */
+  wire_atom_t *startwire;
+  guint32 *cfgdata;
+} pip_lookup_t;
+
+#ifdef __COMPILED_PIPSDB
 
 typedef struct pip_db {
   const pipdb_control_t *memorydb;
+  pip_lookup_t lookup[NR_SWITCH_TYPE];
   wire_db_t *wiredb;
+  /* digest of the compiled-in database, computed when it is built */
+  guint64 stamp;
 } pip_db_t;
 
 #else /* __COMPILED_PIPSDB */
@@ -52,11 +78,18 @@ typedef struct pip_db {
   /* Different databases, sorted on increasing order of complexity */
   /* Database of implicit pips -- only 2-uples of wires */
   GNode *implicitdb[NR_SWITCH_TYPE];
-  /* Database of pips */
-  GNode *memorydb[NR_SWITCH_TYPE];
+  /* Database of pips, flattened in the layout of the compiled db */
+  pipdb_control_t memorydb[NR_SWITCH_TYPE];
+  pip_lookup_t lookup[NR_SWITCH_TYPE];
   /* Connectivity database for logic elements */
   GNode *connexdb[NR_SWITCH_TYPE];
   wire_db_t *wiredb;
+  /* stamp of the database files */
+  guint64 stamp;
+  /* Storage behind memorydb: either the mapped cache file, or the
+     image built from the keyfiles */
+  GMappedFile *cache;
+  gchar *image;
 } pip_db_t;
 
 #endif /* __COMPILED_PIPSDB */
@@ -94,20 +127,78 @@ typedef struct _pip_parsed {
 typedef struct _pip_parsed_dense {
   pip_t *bitpips;
   unsigned *site_index;
+  /* set when the arrays are mapped from a snapshot */
+  GMappedFile *file;
 } pip_parsed_dense_t;
 
 pip_db_t *get_pipdb(const gchar *datadir);
 void free_pipdb(pip_db_t *pipdb);
 
 
+/** \brief Map from the frames of a bitstream to the sites they configure
+ *
+ * Only sites which may hold pips are mapped. The sites of frame i of
+ * the frame index are sites[index[i]] to sites[index[i+1]], in site
+ * order. The map only depends on the chip, so that it can be shared
+ * between all its bitstreams.
+ */
+typedef struct _frame_map {
+  gsize nframes;
+  guint *index;
+  site_ref_t *sites;
+} frame_map_t;
+
+frame_map_t *get_frame_map(const pip_db_t *pipdb, const chip_descr_t *chip,
+			   const bitstream_parsed_t *bitstream);
+void free_frame_map(frame_map_t *map);
+
+static inline const site_ref_t *
+sites_of_frame(const frame_map_t *map, const gsize frame, guint *nsites) {
+  *nsites = map->index[frame + 1] - map->index[frame];
+  return &map->sites[map->index[frame]];
+}
+
 /* utility functions */
 
-/* This should be benchmarked and run as fast as humanly possible */
+/** \brief Extract all the pips from a bitstream
+ *
+ * This should be benchmarked and run as fast as humanly possible. With
+ * more than one job, rows of sites are processed in parallel threads;
+ * the result does not depend on the number of jobs.
+ *
+ * @param pipdb the pip database
+ * @param chipdb the chip description
+ * @param bitstream the bitstream data to read from
+ * @param jobs the number of threads to use
+ */
 pip_parsed_dense_t *
 pips_of_bitstream(const pip_db_t *pipdb, const chip_descr_t *chipdb,
-		  const bitstream_parsed_t *bitstream);
+		  const bitstream_parsed_t *bitstream, unsigned jobs);
 void free_pipdat(pip_parsed_dense_t *pipdat);
 
+/** \brief Extract the pips of a bitstream from those of a previous version
+ *
+ * Only the sites configured by the frames which changed are decoded
+ * again; the pips of all other sites are copied from the previous
+ * extraction. The result is the same as that of pips_of_bitstream.
+ *
+ * @param pipdb the pip database
+ * @param chipdb the chip description
+ * @param bitstream the bitstream data to read from
+ * @param map the frame map of the chip
+ * @param previous the pips of the previous version of the bitstream
+ * @param frames the index of the frames which changed
+ * @param nframes the number of frames which changed
+ *
+ * @see diff_bitstreams
+ */
+pip_parsed_dense_t *
+pips_of_bitstream_update(const pip_db_t *pipdb, const chip_descr_t *chipdb,
+			 const bitstream_parsed_t *bitstream,
+			 const frame_map_t *map,
+			 const pip_parsed_dense_t *previous,
+			 const guint32 *frames, const gsize nframes);
+
 pip_t *pips_of_site(const pip_db_t *pipdb,
 		    const bitstream_parsed_t *bitstream,
 		    const csite_descr_t *site,
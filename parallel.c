@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2006, 2007 Jean-Baptiste Note <jean-baptiste.note@m4x.org>
+ *
+ * This file is part of debit.
+ *
+ * Debit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Debit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with debit.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Splitting some work between threads
+ */
+
+#include <glib.h>
+
+#include "parallel.h"
+#include "stats.h"
+
+typedef struct _worker_run {
+  GThreadFunc func;
+  gpointer data;
+  stats_mark_t mark;
+} worker_run_t;
+
+/* Times a worker run by a thread of its own, so that its CPU time may
+   be charged to the thread joining it */
+static gpointer
+timed_worker(gpointer data) {
+  worker_run_t *run = data;
+  gpointer ret;
+  stats_begin(&run->mark);
+  ret = run->func(run->data);
+  stats_lap(&run->mark);
+  return ret;
+}
+
+static inline GThread *
+spawn_worker(const gchar *name, GThreadFunc func, gpointer data) {
+#if GLIB_CHECK_VERSION(2,32,0)
+  return g_thread_new(name, func, data);
+#else
+  (void) name;
+  return g_thread_create(func, data, TRUE, NULL);
+#endif
+}
+
+void
+run_workers(const gchar *name, GThreadFunc func,
+	    gpointer workers, const gsize size, const unsigned n) {
+  gchar *worker = workers;
+  worker_run_t *runs;
+  GThread **threads;
+  unsigned i;
+
+  if (n == 0)
+    return;
+
+  runs = g_new0(worker_run_t, n);
+  threads = g_new0(GThread *, n);
+
+  for (i = 1; i < n; i++) {
+    runs[i].func = func;
+    runs[i].data = worker + i * size;
+    threads[i] = spawn_worker(name, timed_worker, &runs[i]);
+  }
+  func(worker);
+  for (i = 1; i < n; i++) {
+    if (threads[i]) {
+      g_thread_join(threads[i]);
+      stats_charge(&runs[i].mark);
+    } else
+      func(worker + i * size);
+  }
+
+  g_free(threads);
+  g_free(runs);
+}
@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2006, 2007 Jean-Baptiste Note <jean-baptiste.note@m4x.org>
+ *
+ * This file is part of debit.
+ *
+ * Debit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Debit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with debit.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _HAS_PARALLEL_H
+#define _HAS_PARALLEL_H
+
+/** \file
+ *
+ * Splitting some work between threads.
+ */
+
+#include <glib.h>
+
+/** \brief Run workers in parallel
+ *
+ * The function is called once on each of the workers of an array. The
+ * first worker is run by the calling thread, the others by threads of
+ * their own; should a thread fail to start, its worker is run by the
+ * calling thread as well. This returns once all workers are done,
+ * with the CPU time of their threads charged to the stats phases of
+ * the calling thread.
+ *
+ * @param name the name of the threads
+ * @param func the function run on each worker
+ * @param workers the array of workers
+ * @param size the size of a worker
+ * @param n the number of workers
+ */
+void run_workers(const gchar *name, GThreadFunc func,
+		 gpointer workers, const gsize size, const unsigned n);
+
+#endif /* _HAS_PARALLEL_H */
@@ -0,0 +1,293 @@
+/*
+ * Copyright (C) 2006, 2007 Jean-Baptiste Note <jean-baptiste.note@m4x.org>
+ *
+ * This file is part of debit.
+ *
+ * Debit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Debit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with debit.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * On-disk cache of the flattened pip database
+ */
+
+#include <string.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+#include "debitlog.h"
+
+#include "pipcache.h"
+#include "design.h"
+
+static const gchar pipcache_magic[8] = "DEBITPDB";
+
+/* The image is host-endian and not meant to be shared between
+   machines; the sizes of the records are checked so that a cache
+   written by an incompatible build is simply discarded. */
+typedef struct _pipcache_header {
+  gchar magic[8];
+  guint32 version;
+  guint32 ndbs;
+  guint32 wirecount;
+  guint16 ctrlrecsize;
+  guint16 datarecsize;
+  guint64 stamp;
+} pipcache_header_t;
+
+typedef struct _pipcache_section {
+  guint32 pipctrl_off;
+  guint32 pipctrl_len;
+  guint32 ctrldata_off;
+  guint32 ctrldata_len;
+  guint32 pipdata_off;
+  guint32 pipdata_len;
+} pipcache_section_t;
+
+#define PIPCACHE_ALIGN 8
+
+static inline gsize
+align_up(const gsize off) {
+  return (off + PIPCACHE_ALIGN - 1) & ~((gsize)PIPCACHE_ALIGN - 1);
+}
+
+static inline gsize
+sections_end(const guint ndbs) {
+  return align_up(sizeof(pipcache_header_t) + ndbs * sizeof(pipcache_section_t));
+}
+
+/* Total number of control bits and pip data referenced by the control
+   array of a database */
+static void
+db_extent(const pipdb_control_t *db,
+	  guint32 *nctrldata, guint32 *npipdata) {
+  guint32 ctrl = 0, data = 0;
+  unsigned i;
+
+  for (i = 0; i < db->pipctrl_len; i++) {
+    const pip_control_t *head = &db->pipctrl[i];
+    ctrl = MAX(ctrl, head->ctrloffset + head->ctrlsize);
+    data = MAX(data, head->dataoffset + head->datasize);
+  }
+
+  *nctrldata = ctrl;
+  *npipdata = data;
+}
+
+gchar *
+pipcache_image_new(const pipdb_control_t *dbs, const guint ndbs,
+		   const guint32 wirecount, const guint64 stamp,
+		   gsize *len) {
+  pipcache_section_t *sections = g_new0(pipcache_section_t, ndbs);
+  pipcache_header_t *header;
+  gsize off = sections_end(ndbs);
+  gchar *image;
+  guint i;
+
+  /* First pass: layout */
+  for (i = 0; i < ndbs; i++) {
+    pipcache_section_t *sec = &sections[i];
+    sec->pipctrl_len = dbs[i].pipctrl_len;
+    db_extent(&dbs[i], &sec->ctrldata_len, &sec->pipdata_len);
+
+    sec->pipctrl_off = off;
+    off = align_up(off + sec->pipctrl_len * sizeof(pip_control_t));
+    sec->ctrldata_off = off;
+    off = align_up(off + sec->ctrldata_len * sizeof(uint32_t));
+    sec->pipdata_off = off;
+    off = align_up(off + sec->pipdata_len * sizeof(pip_data_t));
+  }
+
+  /* Second pass: fill in. The image is zeroed so that structure padding
+     does not leak into the file */
+  image = g_malloc0(off);
+  header = (pipcache_header_t *) image;
+  memcpy(header->magic, pipcache_magic, sizeof(header->magic));
+  header->version = PIPCACHE_VERSION;
+  header->ndbs = ndbs;
+  header->wirecount = wirecount;
+  header->ctrlrecsize = sizeof(pip_control_t);
+  header->datarecsize = sizeof(pip_data_t);
+  header->stamp = stamp;
+  memcpy(image + sizeof(pipcache_header_t), sections,
+	 ndbs * sizeof(pipcache_section_t));
+
+  for (i = 0; i < ndbs; i++) {
+    const pipcache_section_t *sec = &sections[i];
+    if (sec->pipctrl_len)
+      memcpy(image + sec->pipctrl_off, dbs[i].pipctrl,
+	     sec->pipctrl_len * sizeof(pip_control_t));
+    if (sec->ctrldata_len)
+      memcpy(image + sec->ctrldata_off, dbs[i].pipctrldata,
+	     sec->ctrldata_len * sizeof(uint32_t));
+    if (sec->pipdata_len)
+      memcpy(image + sec->pipdata_off, dbs[i].pipdatadata,
+	     sec->pipdata_len * sizeof(pip_data_t));
+  }
+
+  g_free(sections);
+  *len = off;
+  return image;
+}
+
+static inline gboolean
+array_fits(const gsize len, const guint32 off,
+	   const guint32 nelems, const gsize elsize) {
+  return off % PIPCACHE_ALIGN == 0 &&
+    off <= len && nelems <= (len - off) / elsize;
+}
+
+static int
+check_section(const pipcache_section_t *sec, const gchar *image,
+	      const gsize len, const guint32 wirecount) {
+  const pip_control_t *ctrl = (const pip_control_t *) (image + sec->pipctrl_off);
+  const pip_data_t *data = (const pip_data_t *) (image + sec->pipdata_off);
+  guint32 i;
+
+  if (!array_fits(len, sec->pipctrl_off, sec->pipctrl_len, sizeof(pip_control_t)) ||
+      !array_fits(len, sec->ctrldata_off, sec->ctrldata_len, sizeof(uint32_t)) ||
+      !array_fits(len, sec->pipdata_off, sec->pipdata_len, sizeof(pip_data_t)))
+    return -1;
+
+  for (i = 0; i < sec->pipctrl_len; i++) {
+    const pip_control_t *head = &ctrl[i];
+    if (head->endwire >= wirecount ||
+	head->ctrlsize > sec->ctrldata_len ||
+	head->ctrloffset > sec->ctrldata_len - head->ctrlsize ||
+	head->datasize > sec->pipdata_len ||
+	head->dataoffset > sec->pipdata_len - head->datasize)
+      return -1;
+  }
+
+  for (i = 0; i < sec->pipdata_len; i++)
+    if (data[i].startwire >= wirecount)
+      return -1;
+
+  return 0;
+}
+
+int
+pipcache_image_bind(pipdb_control_t *dbs, const guint ndbs,
+		    const gchar *image, const gsize len,
+		    const guint32 wirecount, const guint64 stamp) {
+  const pipcache_header_t *header = (const pipcache_header_t *) image;
+  const pipcache_section_t *sections;
+  guint i;
+
+  if (len < sections_end(ndbs))
+    return -1;
+
+  if (memcmp(header->magic, pipcache_magic, sizeof(header->magic)) ||
+      header->version != PIPCACHE_VERSION ||
+      header->ndbs != ndbs ||
+      header->wirecount != wirecount ||
+      header->ctrlrecsize != sizeof(pip_control_t) ||
+      header->datarecsize != sizeof(pip_data_t) ||
+      header->stamp != stamp) {
+    debit_log(L_PIPS, "pip database image is stale or incompatible");
+    return -1;
+  }
+
+  sections = (const pipcache_section_t *) (image + sizeof(pipcache_header_t));
+  for (i = 0; i < ndbs; i++)
+    if (check_section(&sections[i], image, len, wirecount)) {
+      g_warning("pip database image is corrupted, discarding it");
+      return -1;
+    }
+
+  for (i = 0; i < ndbs; i++) {
+    const pipcache_section_t *sec = &sections[i];
+    pipdb_control_t *db = &dbs[i];
+    db->pipctrl = (const pip_control_t *) (image + sec->pipctrl_off);
+    db->pipctrl_len = sec->pipctrl_len;
+    db->pipctrldata = (const uint32_t *) (image + sec->ctrldata_off);
+    db->pipdatadata = (const pip_data_t *) (image + sec->pipdata_off);
+  }
+
+  return 0;
+}
+
+/* FNV-1a, 64 bits */
+static inline guint64
+stamp_mix(guint64 hash, const void *data, gsize len) {
+  const guchar *bytes = data;
+  gsize i;
+  for (i = 0; i < len; i++) {
+    hash ^= bytes[i];
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+guint64
+pipcache_stamp(const gchar **files) {
+  guint64 hash = 0xcbf29ce484222325ULL;
+
+  for (; *files; files++) {
+    const gchar *name = *files;
+    struct stat st;
+    guint64 vals[2] = { 0, 0 };
+
+    if (!g_stat(name, &st)) {
+      vals[0] = st.st_size;
+      vals[1] = st.st_mtime;
+    }
+
+    hash = stamp_mix(hash, name, strlen(name) + 1);
+    hash = stamp_mix(hash, vals, sizeof(vals));
+  }
+
+  return hash;
+}
+
+gchar *
+pipcache_filename(const gchar *datadir) {
+  gchar *base = g_strdup_printf("pips-%08x.cache", g_str_hash(datadir));
+  gchar *filename = g_build_filename(g_get_user_cache_dir(), "debit", CHIP, base, NULL);
+  g_free(base);
+  return filename;
+}
+
+GMappedFile *
+pipcache_map(const gchar *filename) {
+  GError *error = NULL;
+  GMappedFile *file = g_mapped_file_new(filename, FALSE, &error);
+
+  if (error) {
+    debit_log(L_PIPS, "no pip database cache: %s", error->message);
+    g_error_free(error);
+    return NULL;
+  }
+
+  return file;
+}
+
+int
+pipcache_write(const gchar *filename, const gchar *image, const gsize len) {
+  GError *error = NULL;
+  gchar *dirname = g_path_get_dirname(filename);
+  int err = g_mkdir_with_parents(dirname, 0755);
+
+  g_free(dirname);
+  if (err)
+    return -1;
+
+  /* The write is atomic, so that concurrent runs never see a partial
+     image */
+  if (!g_file_set_contents(filename, image, len, &error)) {
+    debit_log(L_PIPS, "could not write pip database cache: %s", error->message);
+    g_error_free(error);
+    return -1;
+  }
+
+  return 0;
+}
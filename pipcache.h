@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2006, 2007 Jean-Baptiste Note <jean-baptiste.note@m4x.org>
+ *
+ * This file is part of debit.
+ *
+ * Debit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Debit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with debit.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _HAS_PIPCACHE_H
+#define _HAS_PIPCACHE_H
+
+/** \file
+ *
+ * Flat binary image of the pip database, and its on-disk cache.
+ *
+ * The image holds, for each switch type, the three arrays of the
+ * compiled database layout (pip_control_t, control bits, pip_data_t)
+ * back to back, preceded by a small versioned header. It is written
+ * once after the keyfiles have been parsed, and simply mapped on later
+ * runs.
+ */
+
+#include <glib.h>
+#include "wiring.h"
+#include "data/pips_compiled_common.h"
+
+/* Bump this whenever the image layout or the meaning of its contents
+   changes */
+#define PIPCACHE_VERSION 1
+
+/** \brief Build the contiguous image of a set of flat pip databases
+ *
+ * @param dbs the flat databases, one per switch type
+ * @param ndbs the number of databases
+ * @param wirecount the size of the wire database the wire atoms refer to
+ * @param stamp the stamp of the source files
+ * @param len return location for the length of the image
+ *
+ * @return the newly-allocated image
+ */
+gchar *pipcache_image_new(const pipdb_control_t *dbs, const guint ndbs,
+			  const guint32 wirecount, const guint64 stamp,
+			  gsize *len);
+
+/** \brief Point a set of flat pip databases into an image
+ *
+ * The image is fully checked against the expected parameters before
+ * anything is filled in.
+ *
+ * @return 0 on success, -1 if the image is not usable
+ */
+int pipcache_image_bind(pipdb_control_t *dbs, const guint ndbs,
+			const gchar *image, const gsize len,
+			const guint32 wirecount, const guint64 stamp);
+
+/** \brief Compute the stamp of a set of source files
+ *
+ * The stamp changes whenever one of the files is changed, moved or
+ * removed.
+ *
+ * @param files a NULL-terminated list of filenames
+ */
+guint64 pipcache_stamp(const gchar **files);
+
+/** \brief Name of the cache file for a given data directory
+ */
+gchar *pipcache_filename(const gchar *datadir);
+
+GMappedFile *pipcache_map(const gchar *filename);
+int pipcache_write(const gchar *filename, const gchar *image, const gsize len);
+
+#endif /* _HAS_PIPCACHE_H */
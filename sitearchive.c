@@ -0,0 +1,310 @@
+/*
+ * Copyright (C) 2006, 2007 Jean-Baptiste Note <jean-baptiste.note@m4x.org>
+ *
+ * This file is part of debit.
+ *
+ * Debit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Debit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with debit.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Indexed archive of site data
+ */
+
+#include <string.h>
+#include <glib.h>
+#include "debitlog.h"
+
+#include "sitearchive.h"
+#include "bitstream.h"
+
+static const gchar site_archive_magic[8] = "DEBITSAR";
+
+typedef struct _site_archive_header {
+  gchar magic[8];
+  guint32 version;
+  guint32 nentries;
+  /* from the start of the file */
+  guint64 names_off;
+  guint64 data_off;
+} site_archive_header_t;
+
+/* The index follows the header. Offsets are relative to the names and
+   the data, respectively */
+typedef struct _site_archive_entry {
+  guint32 name_off;
+  guint32 len;
+  guint64 data_off;
+} site_archive_entry_t;
+
+/*
+ * Writing
+ */
+
+typedef struct _site_record {
+  /* in the names */
+  guint32 name_off;
+  guint32 len;
+  /* in the image */
+  gsize data_off;
+} site_record_t;
+
+typedef struct _collect_sites {
+  const chip_descr_t *chip;
+  GArray *records;
+  GString *names;
+  /* offset of the data of each site of the chip */
+  gsize *site_off;
+  gsize len;
+  gsize data_len;
+} collect_sites_t;
+
+static void
+collect_site_iter(unsigned site_x, unsigned site_y,
+		  csite_descr_t *site, gpointer dat) {
+  collect_sites_t *collect = dat;
+  gchar site_buf[MAX_SITE_NLEN];
+  site_record_t record = {
+    .name_off = collect->names->len,
+    .len = collect->len,
+    .data_off = collect->data_len,
+  };
+
+  snprint_csite(site_buf, ARRAY_SIZE(site_buf), site, site_x, site_y);
+  g_string_append_len(collect->names, site_buf, strlen(site_buf) + 1);
+  collect->site_off[site - collect->chip->data] = collect->data_len;
+  collect->data_len += collect->len;
+  g_array_append_val(collect->records, record);
+}
+
+static gint
+compare_records(gconstpointer a, gconstpointer b, gpointer data) {
+  const site_record_t *ra = a, *rb = b;
+  const gchar *names = data;
+  return strcmp(names + ra->name_off, names + rb->name_off);
+}
+
+typedef struct _fill_sites {
+  const bitstream_parsed_t *bitstream;
+  const chip_descr_t *chip;
+  const gsize *site_off;
+  gsize len;
+  gchar *data;
+} fill_sites_t;
+
+/* Called by several threads at once; each site has its own part of
+   the data */
+static void
+fill_site_iter(unsigned site_x, unsigned site_y,
+	       csite_descr_t *site, gpointer dat) {
+  const fill_sites_t *fill = dat;
+  (void) site_x;
+  (void) site_y;
+  query_bitstream_site_data(fill->data + fill->site_off[site - fill->chip->data],
+			    fill->len, fill->bitstream, site);
+}
+
+int
+site_archive_write(const gchar *filename,
+		   const chip_descr_t *chip,
+		   const bitstream_parsed_t *bitstream,
+		   const site_type_t *types, const guint ntypes,
+		   const unsigned jobs) {
+  collect_sites_t collect = {
+    .chip = chip,
+    .records = g_array_new(FALSE, FALSE, sizeof(site_record_t)),
+    .names = g_string_new(NULL),
+    .site_off = g_new(gsize, chip->width * chip->height),
+  };
+  fill_sites_t fill = {
+    .bitstream = bitstream,
+    .chip = chip,
+    .site_off = collect.site_off,
+  };
+  site_archive_header_t *header;
+  site_archive_entry_t *index;
+  site_record_t *records, *sorted;
+  GError *error = NULL;
+  gsize names_off, data_off, len;
+  gchar *image;
+  guint i, nrecords;
+  int err = 0;
+
+  /* First pass: layout. The data comes in the order of the types, then
+     of the sites */
+  for (i = 0; i < ntypes; i++) {
+    collect.len = query_bitstream_type_size(bitstream, types[i]);
+    iterate_over_typed_sites(chip, types[i], collect_site_iter, &collect);
+  }
+
+  records = (site_record_t *) collect.records->data;
+  nrecords = collect.records->len;
+
+  names_off = sizeof(site_archive_header_t) + nrecords * sizeof(site_archive_entry_t);
+  data_off = (names_off + collect.names->len + 7) & ~(gsize)7;
+  len = data_off + collect.data_len;
+
+  image = g_malloc0(len);
+  header = (site_archive_header_t *) image;
+  memcpy(header->magic, site_archive_magic, sizeof(header->magic));
+  header->version = GUINT32_TO_LE(SITE_ARCHIVE_VERSION);
+  header->nentries = GUINT32_TO_LE(nrecords);
+  header->names_off = GUINT64_TO_LE(names_off);
+  header->data_off = GUINT64_TO_LE(data_off);
+  memcpy(image + names_off, collect.names->str, collect.names->len);
+
+  /* The index is sorted by name, for lookups */
+  sorted = g_new(site_record_t, nrecords);
+  memcpy(sorted, records, nrecords * sizeof(site_record_t));
+  g_qsort_with_data(sorted, nrecords, sizeof(site_record_t),
+		    compare_records, collect.names->str);
+
+  index = (site_archive_entry_t *) (image + sizeof(site_archive_header_t));
+  for (i = 0; i < nrecords; i++) {
+    index[i].name_off = GUINT32_TO_LE(sorted[i].name_off);
+    index[i].len = GUINT32_TO_LE(sorted[i].len);
+    index[i].data_off = GUINT64_TO_LE(sorted[i].data_off);
+  }
+  g_free(sorted);
+
+  /* Second pass: the data proper, each type of sites being split
+     between the threads */
+  fill.data = image + data_off;
+  for (i = 0; i < ntypes; i++) {
+    fill.len = query_bitstream_type_size(bitstream, types[i]);
+    iterate_over_typed_sites_parallel(chip, types[i], fill_site_iter, &fill, jobs);
+  }
+
+  debit_log(L_SITES, "writing %u sites, %" G_GSIZE_FORMAT " bytes to %s",
+	    nrecords, len, filename);
+
+  if (!g_file_set_contents(filename, image, len, &error)) {
+    g_warning("could not write site archive: %s", error->message);
+    g_error_free(error);
+    err = -1;
+  }
+
+  g_free(image);
+  g_free(collect.site_off);
+  g_string_free(collect.names, TRUE);
+  g_array_free(collect.records, TRUE);
+  return err;
+}
+
+/*
+ * Reading
+ */
+
+struct _site_archive {
+  GMappedFile *file;
+  const gchar *image;
+  guint32 nentries;
+  const site_archive_entry_t *index;
+  const gchar *names;
+  gsize names_len;
+  const gchar *data;
+  gsize data_len;
+};
+
+static int
+check_archive(site_archive_t *archive, const gsize len) {
+  const site_archive_header_t *header = (const site_archive_header_t *) archive->image;
+  guint64 names_off, data_off;
+  guint32 i;
+
+  if (len < sizeof(site_archive_header_t) ||
+      memcmp(header->magic, site_archive_magic, sizeof(header->magic)) ||
+      GUINT32_FROM_LE(header->version) != SITE_ARCHIVE_VERSION)
+    return -1;
+
+  archive->nentries = GUINT32_FROM_LE(header->nentries);
+  names_off = GUINT64_FROM_LE(header->names_off);
+  data_off = GUINT64_FROM_LE(header->data_off);
+
+  if (archive->nentries > (len - sizeof(site_archive_header_t)) / sizeof(site_archive_entry_t) ||
+      names_off != sizeof(site_archive_header_t) + archive->nentries * sizeof(site_archive_entry_t) ||
+      data_off < names_off || data_off > len)
+    return -1;
+
+  archive->index = (const site_archive_entry_t *) (archive->image + sizeof(site_archive_header_t));
+  archive->names = archive->image + names_off;
+  archive->names_len = data_off - names_off;
+  archive->data = archive->image + data_off;
+  archive->data_len = len - data_off;
+
+  for (i = 0; i < archive->nentries; i++) {
+    const site_archive_entry_t *entry = &archive->index[i];
+    const guint32 name_off = GUINT32_FROM_LE(entry->name_off);
+    const guint64 off = GUINT64_FROM_LE(entry->data_off);
+    const guint32 elen = GUINT32_FROM_LE(entry->len);
+
+    if (name_off >= archive->names_len ||
+	!memchr(archive->names + name_off, '\0', archive->names_len - name_off) ||
+	off > archive->data_len || elen > archive->data_len - off)
+      return -1;
+  }
+
+  return 0;
+}
+
+site_archive_t *
+site_archive_open(const gchar *filename) {
+  site_archive_t *archive = g_new0(site_archive_t, 1);
+  GError *error = NULL;
+
+  archive->file = g_mapped_file_new(filename, FALSE, &error);
+  if (error) {
+    g_warning("could not open site archive: %s", error->message);
+    g_error_free(error);
+    g_free(archive);
+    return NULL;
+  }
+
+  archive->image = g_mapped_file_get_contents(archive->file);
+  if (check_archive(archive, g_mapped_file_get_length(archive->file))) {
+    g_warning("%s is not a valid site archive", filename);
+    site_archive_close(archive);
+    return NULL;
+  }
+
+  return archive;
+}
+
+void
+site_archive_close(site_archive_t *archive) {
+  g_mapped_file_free(archive->file);
+  g_free(archive);
+}
+
+const gchar *
+site_archive_lookup(const site_archive_t *archive,
+		    const gchar *name, gsize *len) {
+  guint32 low = 0, high = archive->nentries;
+
+  while (low < high) {
+    const guint32 mid = low + (high - low) / 2;
+    const site_archive_entry_t *entry = &archive->index[mid];
+    const int cmp = strcmp(name, archive->names + GUINT32_FROM_LE(entry->name_off));
+
+    if (cmp == 0) {
+      *len = GUINT32_FROM_LE(entry->len);
+      return archive->data + GUINT64_FROM_LE(entry->data_off);
+    }
+    if (cmp < 0)
+      high = mid;
+    else
+      low = mid + 1;
+  }
+
+  return NULL;
+}
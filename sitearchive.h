@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2006, 2007 Jean-Baptiste Note <jean-baptiste.note@m4x.org>
+ *
+ * This file is part of debit.
+ *
+ * Debit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Debit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with debit.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _HAS_SITEARCHIVE_H
+#define _HAS_SITEARCHIVE_H
+
+/** \file
+ *
+ * Indexed archive of the configuration data of sites.
+ *
+ * This is the one-file alternative to dumping every site to a file of
+ * its own. The archive starts with a header and an index of the sites,
+ * sorted by name, giving the offset and length of the data of each
+ * site; the names and the data follow. All integers are little-endian.
+ */
+
+#include <glib.h>
+#include "bitstream_parser.h"
+#include "sites.h"
+
+#define SITE_ARCHIVE_VERSION 1
+
+/** \brief Write the data of all sites of some types to an archive
+ *
+ * The data is extracted into an image of the archive by several
+ * threads, then the image is written in one go.
+ *
+ * @param filename the archive to write
+ * @param chip the chip description
+ * @param bitstream the bitstream data
+ * @param types the types of the sites to dump
+ * @param ntypes the number of types
+ * @param jobs the number of threads to use
+ *
+ * @return 0 on success, -1 on error
+ */
+int site_archive_write(const gchar *filename,
+		       const chip_descr_t *chip,
+		       const bitstream_parsed_t *bitstream,
+		       const site_type_t *types, const guint ntypes,
+		       const unsigned jobs);
+
+typedef struct _site_archive site_archive_t;
+
+/** \brief Open an archive for reading
+ *
+ * @return the archive, or NULL if it cannot be read or is not valid
+ */
+site_archive_t *site_archive_open(const gchar *filename);
+void site_archive_close(site_archive_t *archive);
+
+/** \brief Look the data of a site up in an archive
+ *
+ * @param name the name of the site
+ * @param len return location for the length of the data
+ *
+ * @return the data, owned by the archive, or NULL if the site is not
+ * in the archive
+ */
+const gchar *site_archive_lookup(const site_archive_t *archive,
+				 const gchar *name, gsize *len);
+
+#endif /* _HAS_SITEARCHIVE_H */
@@ -25,6 +25,7 @@
 
 #include "sites.h"
 #include "design.h"
+#include "parallel.h"
 
 /*
  * File site control description is of form
@@ -163,12 +164,18 @@ static inline void
 alloc_chip(chip_descr_t *descr) {
   unsigned nelems = descr->width * descr->height;
   descr->data = g_new0(csite_descr_t, nelems);
-  g_datalist_init(&descr->lookup);
 }
 
 static inline void
 free_chip(chip_descr_t *descr) {
-  g_datalist_clear(&descr->lookup);
+  g_free(descr->lookup);
+  descr->lookup = NULL;
+  g_free(descr->names);
+  descr->names = NULL;
+  g_free(descr->name_off);
+  descr->name_off = NULL;
+  g_free(descr->typed);
+  descr->typed = NULL;
   g_free(descr->data);
   descr->data = NULL;
 }
@@ -193,6 +200,8 @@ free_nchip(chip_descr_t *descr) {
   FREE_FIELD(descr, area);
   FREE_FIELD(descr, x_descr);
   FREE_FIELD(descr, y_descr);
+  FREE_FIELD(descr, x_axis);
+  FREE_FIELD(descr, y_axis);
 }
 
 static void
@@ -242,19 +251,70 @@ iterate_over_sites(const chip_descr_t *chip,
       fun(x,y,site++,data);
 }
 
+void
+iterate_over_typed_sites_range(const chip_descr_t *chip, site_type_t type,
+			       guint start, guint end,
+			       site_iterator_t fun, gpointer data) {
+  const typed_site_t *typed = chip->typed + chip->typed_start[type];
+  guint i;
+
+  g_assert(end <= count_typed_sites(chip, type));
+
+  for (i = start; i < end; i++) {
+    const typed_site_t *ts = &typed[i];
+    fun(ts->global.x, ts->global.y, &chip->data[ts->site], data);
+  }
+}
+
 void
 iterate_over_typed_sites(const chip_descr_t *chip, site_type_t type,
 			 site_iterator_t fun, gpointer data) {
-  unsigned x, y;
-  unsigned xmax = chip->width, ymax = chip->height;
-  csite_descr_t *site = chip->data;
+  iterate_over_typed_sites_range(chip, type,
+				 0, count_typed_sites(chip, type),
+				 fun, data);
+}
 
-  for (y = 0; y < ymax; y++)
-    for (x = 0; x < xmax; x++) {
-      if (site->type == type)
-	fun(x,y,site,data);
-      site++;
-    }
+typedef struct _typed_worker {
+  const chip_descr_t *chip;
+  site_type_t type;
+  guint start, end;
+  site_iterator_t fun;
+  gpointer data;
+} typed_worker_t;
+
+static gpointer
+iterate_typed_worker(gpointer arg) {
+  typed_worker_t *worker = arg;
+  iterate_over_typed_sites_range(worker->chip, worker->type,
+				 worker->start, worker->end,
+				 worker->fun, worker->data);
+  return NULL;
+}
+
+void
+iterate_over_typed_sites_parallel(const chip_descr_t *chip, site_type_t type,
+				  site_iterator_t fun, gpointer data,
+				  unsigned jobs) {
+  const guint nsites = count_typed_sites(chip, type);
+  typed_worker_t *workers;
+  unsigned i;
+
+  jobs = MAX(1, MIN(jobs, nsites));
+  workers = g_new(typed_worker_t, jobs);
+
+  for (i = 0; i < jobs; i++) {
+    typed_worker_t *worker = &workers[i];
+    worker->chip = chip;
+    worker->type = type;
+    worker->start = (guint64) nsites * i / jobs;
+    worker->end = (guint64) nsites * (i + 1) / jobs;
+    worker->fun = fun;
+    worker->data = data;
+  }
+
+  run_workers("sites", iterate_typed_worker, workers, sizeof(typed_worker_t), jobs);
+
+  g_free(workers);
 }
 
 typedef struct _local_counter {
@@ -303,19 +363,117 @@ init_local_coordinates(chip_descr_t *chip) {
   iterate_over_sites(chip, init_site_coord, coords);
 }
 
+/*
+ * Site name lookup. This is a linear-probing hash table, sized to be
+ * at most half full; the full hash is kept in the slots so that the
+ * names are only compared on a likely match.
+ */
+
+static inline guint32
+site_name_hash(const gchar *name) {
+  guint32 h = 2166136261U;
+  for (; *name; name++) {
+    h ^= (guchar) *name;
+    h *= 16777619U;
+  }
+  return h;
+}
+
+static inline const site_lookup_t *
+find_lookup_slot(const chip_descr_t *chip,
+		 const gchar *name, const guint32 hash) {
+  guint i = hash & chip->lookup_mask;
+
+  for (;;) {
+    const site_lookup_t *slot = &chip->lookup[i];
+    if (slot->site == SITE_NULL)
+      return slot;
+    if (slot->hash == hash &&
+	!strcmp(name, chip->names + chip->name_off[slot->site]))
+      return slot;
+    i = (i + 1) & chip->lookup_mask;
+  }
+}
+
+typedef struct _lookup_filler {
+  chip_descr_t *chip;
+  GString *names;
+} lookup_filler_t;
+
 static void
 fill_lookup(unsigned x, unsigned y,
 	    csite_descr_t *site, gpointer dat) {
-  chip_descr_t *chip = dat;
+  lookup_filler_t *filler = dat;
+  chip_descr_t *chip = filler->chip;
+  const site_ref_t sref = get_site_ref(chip, site);
   gchar name[MAX_SITE_NLEN];
+
   snprint_csite(name, ARRAY_SIZE(name), site, x, y);
-  g_datalist_set_data(&chip->lookup, name, site);
-  return;
+  chip->name_off[sref] = filler->names->len;
+  g_string_append_len(filler->names, name, strlen(name) + 1);
 }
 
-static inline void
+static void
+insert_lookup(chip_descr_t *chip, const site_ref_t sref) {
+  const gchar *name = chip->names + chip->name_off[sref];
+  const guint32 hash = site_name_hash(name);
+  site_lookup_t *slot = (site_lookup_t *) find_lookup_slot(chip, name, hash);
+
+  /* On duplicate names, the last site wins */
+  slot->hash = hash;
+  slot->site = sref;
+}
+
+static void
 init_lookup(chip_descr_t *chip) {
-  iterate_over_sites(chip, fill_lookup, chip);
+  const unsigned nsites = chip->width * chip->height;
+  lookup_filler_t filler = {
+    .chip = chip,
+    .names = g_string_sized_new(nsites * 8),
+  };
+  guint size = 1;
+  unsigned i;
+
+  g_assert(nsites < SITE_NULL);
+
+  chip->name_off = g_new(guint32, nsites);
+  iterate_over_sites(chip, fill_lookup, &filler);
+  chip->names = g_string_free(filler.names, FALSE);
+
+  while (size < 2 * nsites)
+    size <<= 1;
+  chip->lookup_mask = size - 1;
+  chip->lookup = g_new(site_lookup_t, size);
+  for (i = 0; i < size; i++)
+    chip->lookup[i].site = SITE_NULL;
+
+  for (i = 0; i < nsites; i++)
+    insert_lookup(chip, i);
+}
+
+/* Bucket the sites by type, keeping the order of iterate_over_sites */
+static void
+init_typed(chip_descr_t *chip) {
+  const unsigned width = chip->width;
+  const unsigned nsites = width * chip->height;
+  guint fill[NR_SITE_TYPE];
+  unsigned i;
+
+  memset(chip->typed_start, 0, sizeof(chip->typed_start));
+  for (i = 0; i < nsites; i++)
+    chip->typed_start[chip->data[i].type + 1]++;
+  for (i = 0; i < NR_SITE_TYPE; i++) {
+    chip->typed_start[i + 1] += chip->typed_start[i];
+    fill[i] = chip->typed_start[i];
+  }
+
+  chip->typed = g_new(typed_site_t, nsites);
+  for (i = 0; i < nsites; i++) {
+    typed_site_t *ts = &chip->typed[fill[chip->data[i].type]++];
+    ts->site = i;
+    ts->global.x = i % width;
+    ts->global.y = i / width;
+  }
 }
 
 static void
@@ -324,6 +482,7 @@ init_chip(chip_descr_t *chip, GKeyFile *file) {
   iterate_over_groups(file, init_group_chip_type, chip);
   init_local_coordinates(chip);
   init_lookup(chip);
+  init_typed(chip);
 }
 
 static inline void
@@ -448,10 +607,57 @@ init_area_chip_type(GKeyFile *file, const gchar *group,
   return;
 }
 
+/* Unroll the intervals into a per-coordinate table. Coordinates
+   outside of all intervals map to the origin */
+static nsite_axis_t *
+build_axis(const interval_t *descr, const unsigned dlen,
+	   const unsigned len) {
+  nsite_axis_t *axis = g_new0(nsite_axis_t, len);
+  unsigned i, pos;
+
+  for (i = 0; i < dlen; i++) {
+    const interval_t *itv = &descr[i];
+    for (pos = itv->base; pos < itv->base + itv->length && pos < len; pos++) {
+      axis[pos].area = i;
+      axis[pos].offset = pos - itv->base;
+    }
+  }
+
+  return axis;
+}
+
 static void
 init_nchip(chip_descr_t *chip, GKeyFile *file) {
   /* Initialize area */
   iterate_over_groups(file, init_area_chip_type, chip);
+  chip->x_axis = build_axis(chip->x_descr, chip->awidth, chip->width);
+  chip->y_axis = build_axis(chip->y_descr, chip->aheight, chip->height);
+}
+
+void
+nsites_of_sites(const chip_descr_t *chip,
+		const site_ref_t *sites, nsite_ref_t *nsites,
+		const gsize len) {
+  gsize i;
+  for (i = 0; i < len; i++)
+    nsites[i] = nsite_of_site(chip, sites[i]);
+}
+
+void
+nsites_of_chip(const chip_descr_t *chip, nsite_ref_t *nsites) {
+  const nsite_axis_t *x_axis = chip->x_axis;
+  const nsite_axis_t *y_axis = chip->y_axis;
+  unsigned x, y;
+
+  for (y = 0; y < chip->height; y++) {
+    const nsite_axis_t ya = y_axis[y];
+    for (x = 0; x < chip->width; x++) {
+      const nsite_axis_t xa = x_axis[x];
+      const unsigned lco = MAKE_AREA(chip, xa.area, ya.area);
+      const unsigned off = MAKE_RELATIVE(chip, xa.offset, ya.offset);
+      *nsites++ = MAKE_NSITE(lco, off);
+    }
+  }
 }
 
 /* exported alloc and destroy functions */
@@ -713,13 +919,13 @@ snprint_switch(gchar *buf, size_t bufs,
 int parse_site_simple(const chip_descr_t *chip,
 		      site_ref_t* sref,
 		      const gchar *lookup) {
-  chip_descr_t *mchip = (void *) chip;
-  csite_descr_t *site = g_datalist_get_data(&mchip->lookup, lookup);
+  const site_lookup_t *slot =
+    find_lookup_slot(chip, lookup, site_name_hash(lookup));
 
-  if (site == NULL)
+  if (slot->site == SITE_NULL)
     return -1;
 
-  *sref = get_site_ref(chip, site);
+  *sref = slot->site;
   return 0;
 }
 
@@ -71,6 +71,13 @@ typedef struct interval {
   unsigned length;
 } interval_t;
 
+/* Position of a global coordinate along one axis of the nsite grid:
+   the index of the interval, and the offset in it */
+typedef struct nsite_axis {
+  guint8 area;
+  guint8 offset;
+} nsite_axis_t;
+
 typedef struct nsite_area {
   /* coordinates of the upper left corner of the area on the subsampled
      grid of places of the same type */
@@ -78,11 +85,33 @@ typedef struct nsite_area {
   site_type_t type;
 } nsite_area_t;
 
+/* A site of the per-type lists, with its global coordinates */
+typedef struct _typed_site {
+  site_ref_t site;
+  site_t global;
+} typed_site_t;
+
+/* Slot of the site name hash table. Empty slots have a SITE_NULL
+   site */
+typedef struct _site_lookup {
+  guint32 hash;
+  site_ref_t site;
+} site_lookup_t;
+
 typedef struct _chip_descr {
   unsigned width;
   unsigned height;
   csite_descr_t *data;
-  GData *lookup;
+  /* Open-addressing hash table from the site names to the sites. The
+     names are kept back to back in names, at name_off[site] */
+  guint lookup_mask;
+  site_lookup_t *lookup;
+  gchar *names;
+  guint32 *name_off;
+  /* The sites of each type, in-order WRT iterate_over_sites: those of
+     type t are typed[typed_start[t]] to typed[typed_start[t+1]-1] */
+  typed_site_t *typed;
+  guint typed_start[NR_SITE_TYPE + 1];
   /* New kind of optimized site database. the descr arrays must
      contain and end-of-line element, with length 0 and base = width+1 */
   unsigned awidth;
@@ -90,6 +119,10 @@ typedef struct _chip_descr {
   unsigned aheight;
   const interval_t *y_descr;
   const nsite_area_t *area;
+  /* x -> column and y -> row of the nsite grid, width and height
+     entries respectively */
+  const nsite_axis_t *x_axis;
+  const nsite_axis_t *y_axis;
 } chip_descr_t;
 
 /* New nsite_ref_t container, on 32 bits. The nsite_ref_t contains 2
@@ -108,19 +141,6 @@ typedef struct _chip_descr {
 #define GET_AREA_Y(chip, area) ((area >> 8) & 0xff)
 #define MAKE_NSITE(area, rel) (rel | area << 16)
 
-static inline
-int find_index(const interval_t *itv, const unsigned itv_l,
-	       const int seek) {
-  /* Simple, linear search */
-  unsigned coord;
-  for (coord = 0; coord < itv_l; coord++) {
-    int base = itv[coord].base;
-    if (seek < base)
-      return (int)(coord-1);
-  }
-  return -1;
-}
-
 /*
  * Translate global coordinates into the nsite system of coordinates.
  * This definitely allows better *everything*
@@ -129,14 +149,10 @@ int find_index(const interval_t *itv, const unsigned itv_l,
 static inline nsite_ref_t
 nsite_of_global(const chip_descr_t *chip,
 		const unsigned x, const unsigned y) {
-  int ycoord, xcoord;
-  unsigned x_off, y_off, lco, off;
-  xcoord = find_index(chip->x_descr, chip->awidth, x);
-  x_off = (xcoord < 0) ? 0 : x - chip->x_descr[xcoord].base;
-  ycoord = find_index(chip->y_descr, chip->aheight, y);
-  y_off = (ycoord < 0) ? 0 : y - chip->y_descr[ycoord].base;
-  lco = MAKE_AREA(chip, xcoord, ycoord);
-  off = MAKE_RELATIVE(chip, x_off, y_off);
+  const nsite_axis_t xa = chip->x_axis[x];
+  const nsite_axis_t ya = chip->y_axis[y];
+  const unsigned lco = MAKE_AREA(chip, xa.area, ya.area);
+  const unsigned off = MAKE_RELATIVE(chip, xa.offset, ya.offset);
   return MAKE_NSITE(lco, off);
 }
 
@@ -199,8 +215,7 @@ type_of_site(const chip_descr_t *chip, const nsite_ref_t site) {
   return area->type;
 }
 
-/*
-static nsite_ref_t
+static inline nsite_ref_t
 nsite_of_site(const chip_descr_t *chip,
 	      const site_ref_t site) {
   const unsigned width = chip->width;
@@ -210,6 +225,24 @@ nsite_of_site(const chip_descr_t *chip,
   return nsite_of_global(chip, x, y);
 }
 
+/** \brief Translate a batch of sites into the nsite system
+ *
+ * @param sites the sites to translate
+ * @param nsites return location for the translated sites
+ * @param len the number of sites
+ */
+void nsites_of_sites(const chip_descr_t *chip,
+		     const site_ref_t *sites, nsite_ref_t *nsites,
+		     const gsize len);
+
+/** \brief Translate all the sites of the chip into the nsite system
+ *
+ * @param nsites return location for the translated sites, in-order
+ * WRT iterate_over_sites; width * height entries
+ */
+void nsites_of_chip(const chip_descr_t *chip, nsite_ref_t *nsites);
+
+/*
 static site_ref_t
 site_of_nsite(const chip_descr_t *chip,
 	      const nsite_ref_t site) {
@@ -342,6 +375,31 @@ void iterate_over_sites(const chip_descr_t *chip,
 void iterate_over_typed_sites(const chip_descr_t *chip, site_type_t type,
 			      site_iterator_t fun, gpointer data);
 
+static inline guint
+count_typed_sites(const chip_descr_t *chip, const site_type_t type) {
+  return chip->typed_start[type + 1] - chip->typed_start[type];
+}
+
+/** \brief Iterate over a chunk of the sites of a type
+ *
+ * The sites are numbered from 0 to count_typed_sites() - 1, in-order
+ * WRT iterate_over_typed_sites; this visits the sites start to end - 1.
+ */
+void iterate_over_typed_sites_range(const chip_descr_t *chip, site_type_t type,
+				    guint start, guint end,
+				    site_iterator_t fun, gpointer data);
+
+/** \brief Iterate over the sites of a type with several threads
+ *
+ * Each thread visits a contiguous chunk of the sites. The function is
+ * called concurrently and must be reentrant.
+ *
+ * @param jobs the number of threads to use
+ */
+void iterate_over_typed_sites_parallel(const chip_descr_t *chip, site_type_t type,
+				       site_iterator_t fun, gpointer data,
+				       unsigned jobs);
+
 void release_chip(chip_descr_t *chip);
 chip_descr_t *get_chip(const gchar *datadir, const unsigned chipid);
 
@@ -0,0 +1,276 @@
+/*
+ * Copyright (C) 2006, 2007 Jean-Baptiste Note <jean-baptiste.note@m4x.org>
+ *
+ * This file is part of debit.
+ *
+ * Debit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Debit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with debit.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Snapshot of the pips extracted from a bitstream
+ */
+
+#include <string.h>
+#include <time.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+#include "debitlog.h"
+
+#include "snapshot.h"
+#include "design.h"
+
+static const gchar snapshot_magic[8] = "DEBITSNP";
+
+/* Like the pip database cache, the snapshot is host-endian */
+typedef struct _snapshot_header {
+  gchar magic[8];
+  guint32 version;
+  guint16 indexrecsize;
+  guint16 piprecsize;
+  snapshot_key_t key;
+  guint32 npips;
+  guint32 pad;
+} snapshot_header_t;
+
+/* The site index follows the header, then the pips */
+static inline gsize
+pips_offset(const guint32 nsites) {
+  const gsize off = sizeof(snapshot_header_t) + (nsites + 1) * sizeof(unsigned);
+  return (off + 7) & ~(gsize)7;
+}
+
+int
+snapshot_key(snapshot_key_t *key,
+	     const bitstream_parsed_t *bitstream,
+	     const pip_db_t *pipdb, const chip_descr_t *chip) {
+  GMappedFile *file = bitstream->file;
+  gsize len = sizeof(key->digest);
+  GChecksum *checksum;
+
+  if (!file)
+    return -1;
+
+  memset(key, 0, sizeof(*key));
+
+  checksum = g_checksum_new(G_CHECKSUM_MD5);
+  g_checksum_update(checksum,
+		    (const guchar *) g_mapped_file_get_contents(file),
+		    g_mapped_file_get_length(file));
+  g_checksum_get_digest(checksum, key->digest, &len);
+  g_checksum_free(checksum);
+
+  key->dbstamp = pipdb->stamp;
+  key->wirecount = pipdb->wiredb->dblen;
+  key->nsites = chip->width * chip->height;
+  return 0;
+}
+
+static gchar *
+snapshot_filename(const snapshot_key_t *key, const gchar *dir) {
+  gchar hex[2 * sizeof(key->digest) + 1];
+  gchar *base, *filename;
+  unsigned i;
+
+  for (i = 0; i < sizeof(key->digest); i++)
+    g_snprintf(&hex[2 * i], 3, "%02x", key->digest[i]);
+
+  base = g_strconcat("design-", hex, ".snap", NULL);
+  filename = g_build_filename(dir, CHIP, base, NULL);
+  g_free(base);
+  return filename;
+}
+
+static int
+check_image(const gchar *image, const gsize len,
+	    const snapshot_key_t *key) {
+  const snapshot_header_t *header = (const snapshot_header_t *) image;
+  const gsize off = pips_offset(key->nsites);
+  const unsigned *site_index;
+  const pip_t *pips;
+  guint32 i;
+
+  if (len < sizeof(snapshot_header_t))
+    return -1;
+
+  if (memcmp(header->magic, snapshot_magic, sizeof(header->magic)) ||
+      header->version != SNAPSHOT_VERSION ||
+      header->indexrecsize != sizeof(unsigned) ||
+      header->piprecsize != sizeof(pip_t) ||
+      memcmp(&header->key, key, sizeof(*key))) {
+    debit_log(L_PIPS, "design snapshot is stale or incompatible");
+    return -1;
+  }
+
+  if (off > len || header->npips > (len - off) / sizeof(pip_t))
+    goto out_corrupted;
+
+  site_index = (const unsigned *) (image + sizeof(snapshot_header_t));
+  for (i = 0; i < key->nsites; i++)
+    if (site_index[i] > site_index[i + 1])
+      goto out_corrupted;
+  if (site_index[key->nsites] != header->npips)
+    goto out_corrupted;
+
+  pips = (const pip_t *) (image + off);
+  for (i = 0; i < header->npips; i++)
+    if (pips[i].source >= key->wirecount ||
+	pips[i].target >= key->wirecount)
+      goto out_corrupted;
+
+  return 0;
+
+ out_corrupted:
+  g_warning("design snapshot is corrupted, discarding it");
+  return -1;
+}
+
+pip_parsed_dense_t *
+snapshot_load(const snapshot_key_t *key, const gchar *dir) {
+  gchar *filename = snapshot_filename(key, dir);
+  GError *error = NULL;
+  GMappedFile *file = g_mapped_file_new(filename, FALSE, &error);
+  pip_parsed_dense_t *pipdat;
+  gchar *image;
+
+  if (error) {
+    debit_log(L_PIPS, "no design snapshot: %s", error->message);
+    g_error_free(error);
+    goto out_free;
+  }
+
+  image = g_mapped_file_get_contents(file);
+  if (check_image(image, g_mapped_file_get_length(file), key)) {
+    g_mapped_file_free(file);
+    goto out_free;
+  }
+
+  debit_log(L_PIPS, "design snapshot mapped from %s", filename);
+  g_free(filename);
+
+  pipdat = g_new(pip_parsed_dense_t, 1);
+  pipdat->site_index = (unsigned *) (image + sizeof(snapshot_header_t));
+  pipdat->bitpips = (pip_t *) (image + pips_offset(key->nsites));
+  pipdat->file = file;
+  return pipdat;
+
+ out_free:
+  g_free(filename);
+  return NULL;
+}
+
+typedef struct _snapshot_file {
+  gchar *name;
+  goffset size;
+  time_t mtime;
+} snapshot_file_t;
+
+static gint
+newest_first(gconstpointer a, gconstpointer b) {
+  const snapshot_file_t *fa = a, *fb = b;
+  return (fa->mtime < fb->mtime) - (fa->mtime > fb->mtime);
+}
+
+/* Remove the oldest snapshots once the directory grows over the size
+   limit, and those over the age limit. The newest one, which was just
+   written, is always kept. */
+static void
+prune_snapshots(const gchar *dirname) {
+  const time_t now = time(NULL);
+  GDir *dir = g_dir_open(dirname, 0, NULL);
+  GArray *files;
+  const gchar *name;
+  goffset total = 0;
+  guint i;
+
+  if (!dir)
+    return;
+
+  files = g_array_new(FALSE, FALSE, sizeof(snapshot_file_t));
+  while ((name = g_dir_read_name(dir)) != NULL) {
+    snapshot_file_t file;
+    struct stat st;
+
+    if (!g_str_has_prefix(name, "design-") || !g_str_has_suffix(name, ".snap"))
+      continue;
+
+    file.name = g_build_filename(dirname, name, NULL);
+    if (g_stat(file.name, &st)) {
+      g_free(file.name);
+      continue;
+    }
+    file.size = st.st_size;
+    file.mtime = st.st_mtime;
+    g_array_append_val(files, file);
+  }
+  g_dir_close(dir);
+
+  g_array_sort(files, newest_first);
+
+  for (i = 0; i < files->len; i++) {
+    snapshot_file_t *file = &g_array_index(files, snapshot_file_t, i);
+    total += file->size;
+    if (i > 0 && (total > SNAPSHOT_CACHE_SIZE ||
+		  now - file->mtime > SNAPSHOT_MAX_AGE)) {
+      debit_log(L_PIPS, "removing design snapshot %s", file->name);
+      g_unlink(file->name);
+    }
+    g_free(file->name);
+  }
+
+  g_array_free(files, TRUE);
+}
+
+int
+snapshot_save(const snapshot_key_t *key,
+	      const pip_parsed_dense_t *pipdat, const gchar *dir) {
+  const guint32 npips = pipdat->site_index[key->nsites];
+  const gsize off = pips_offset(key->nsites);
+  const gsize len = off + npips * sizeof(pip_t);
+  gchar *image = g_malloc0(len);
+  snapshot_header_t *header = (snapshot_header_t *) image;
+  gchar *filename = snapshot_filename(key, dir);
+  gchar *dirname = g_path_get_dirname(filename);
+  GError *error = NULL;
+  int err = 0;
+
+  memcpy(header->magic, snapshot_magic, sizeof(header->magic));
+  header->version = SNAPSHOT_VERSION;
+  header->indexrecsize = sizeof(unsigned);
+  header->piprecsize = sizeof(pip_t);
+  header->key = *key;
+  header->npips = npips;
+  memcpy(image + sizeof(snapshot_header_t), pipdat->site_index,
+	 (key->nsites + 1) * sizeof(unsigned));
+  memcpy(image + off, pipdat->bitpips, npips * sizeof(pip_t));
+
+  if (g_mkdir_with_parents(dirname, 0755)) {
+    err = -1;
+    goto out_free;
+  }
+
+  /* The write is atomic, so that concurrent runs never see a partial
+     snapshot */
+  if (!g_file_set_contents(filename, image, len, &error)) {
+    debit_log(L_PIPS, "could not write design snapshot: %s", error->message);
+    g_error_free(error);
+    err = -1;
+  } else
+    prune_snapshots(dirname);
+
+ out_free:
+  g_free(dirname);
+  g_free(filename);
+  g_free(image);
+  return err;
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2006, 2007 Jean-Baptiste Note <jean-baptiste.note@m4x.org>
+ *
+ * This file is part of debit.
+ *
+ * Debit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Debit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with debit.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _HAS_SNAPSHOT_H
+#define _HAS_SNAPSHOT_H
+
+/** \file
+ *
+ * Snapshot of the analysis of a bitstream.
+ *
+ * Extracting the pips is the expensive part of the analysis of a
+ * bitstream. Its result can be saved in a snapshot directory, in a
+ * file named after the digest of the bitstream, and simply mapped the
+ * next time the same bitstream is analyzed with the same databases.
+ *
+ * The oldest snapshots are removed when a new one is saved, so that
+ * the snapshots of a chip stay under SNAPSHOT_CACHE_SIZE bytes and are
+ * never older than SNAPSHOT_MAX_AGE seconds.
+ */
+
+#include <glib.h>
+#include "bitstream_parser.h"
+#include "localpips.h"
+#include "sites.h"
+
+/* Bump this whenever the snapshot layout or the meaning of its contents
+   changes */
+#define SNAPSHOT_VERSION 1
+
+/* Limits of the snapshots kept for each chip */
+#define SNAPSHOT_CACHE_SIZE (256 << 20)
+#define SNAPSHOT_MAX_AGE (30 * 24 * 3600)
+
+/** \brief What a snapshot depends on
+ */
+typedef struct _snapshot_key {
+  /* MD5 digest of the bitstream file */
+  guint8 digest[16];
+  /* stamp of the pip database */
+  guint64 dbstamp;
+  guint32 wirecount;
+  guint32 nsites;
+} snapshot_key_t;
+
+/** \brief Compute the key of the analysis of a bitstream
+ *
+ * @return 0 on success, -1 if the bitstream does not come from a
+ * file and thus cannot have a snapshot
+ */
+int snapshot_key(snapshot_key_t *key,
+		 const bitstream_parsed_t *bitstream,
+		 const pip_db_t *pipdb, const chip_descr_t *chip);
+
+/** \brief Map the snapshot of a bitstream
+ *
+ * The snapshot is fully checked before use.
+ *
+ * @param dir the snapshot directory
+ *
+ * @return the pips of the bitstream, to be freed with free_pipdat, or
+ * NULL if there is no usable snapshot
+ */
+pip_parsed_dense_t *snapshot_load(const snapshot_key_t *key,
+				  const gchar *dir);
+
+/** \brief Save the snapshot of a bitstream
+ *
+ * The oldest snapshots of the directory are removed if the size or
+ * age limits are exceeded.
+ *
+ * @param dir the snapshot directory
+ *
+ * @return 0 on success, -1 if the snapshot could not be written
+ */
+int snapshot_save(const snapshot_key_t *key,
+		  const pip_parsed_dense_t *pipdat, const gchar *dir);
+
+#endif /* _HAS_SNAPSHOT_H */
@@ -0,0 +1,272 @@
+/*
+ * Copyright (C) 2006, 2007 Jean-Baptiste Note <jean-baptiste.note@m4x.org>
+ *
+ * This file is part of debit.
+ *
+ * Debit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Debit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with debit.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Phase timings and event counters
+ */
+
+/* for RUSAGE_THREAD */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif /* HAVE_CONFIG_H */
+
+#include <time.h>
+#include <glib.h>
+#include <glib/gprintf.h>
+
+#ifdef HAVE_GETRUSAGE
+#include <sys/time.h>
+#include <sys/resource.h>
+#endif /* HAVE_GETRUSAGE */
+
+#include "stats.h"
+
+gboolean debit_stats = FALSE;
+
+typedef struct _phase_stats {
+  guint runs;
+  gint64 wall;
+  gint64 cpu;
+  /* in kilobytes */
+  glong peak_rss;
+} phase_stats_t;
+
+static phase_stats_t phases[NR_STATS_PHASES];
+static guint64 counters[NR_STATS_COUNTERS];
+
+static const gchar *phase_names[NR_STATS_PHASES] = {
+  [STATS_HEADER] = "header",
+  [STATS_PACKETS] = "packets",
+  [STATS_FRAMES] = "frames",
+  [STATS_COMPACT] = "compact",
+  [STATS_CHIPDB] = "chipdb",
+  [STATS_PIPDB] = "pipdb",
+  [STATS_PIPS] = "pips",
+  [STATS_NETS] = "nets",
+  [STATS_DUMP_FRAMES] = "framedump",
+  [STATS_DUMP_UNK] = "unkdump",
+  [STATS_DUMP_SITES] = "sitedump",
+  [STATS_DUMP_ARCHIVE] = "sitearchive",
+  [STATS_DUMP_PIPS] = "pipdump",
+  [STATS_DUMP_LUTS] = "lutdump",
+  [STATS_DUMP_BRAM] = "bramdump",
+  [STATS_DUMP_NETS] = "netdump",
+};
+
+static const gchar *counter_names[NR_STATS_COUNTERS] = {
+  [STATS_NFRAMES] = "frames",
+  [STATS_NCRC] = "crc_checks",
+  [STATS_NPIPS] = "pips",
+  [STATS_NNETS] = "nets",
+  [STATS_NNODES] = "net_nodes",
+};
+
+#if GLIB_CHECK_VERSION(2,32,0)
+static GMutex stats_mutex;
+#define stats_lock() g_mutex_lock(&stats_mutex)
+#define stats_unlock() g_mutex_unlock(&stats_mutex)
+static GPrivate charged_cpu = G_PRIVATE_INIT(g_free);
+#define charged_get() g_private_get(&charged_cpu)
+#define charged_set(p) g_private_set(&charged_cpu, p)
+#else
+static GStaticMutex stats_mutex = G_STATIC_MUTEX_INIT;
+#define stats_lock() g_static_mutex_lock(&stats_mutex)
+#define stats_unlock() g_static_mutex_unlock(&stats_mutex)
+static GStaticPrivate charged_cpu = G_STATIC_PRIVATE_INIT;
+#define charged_get() g_static_private_get(&charged_cpu)
+#define charged_set(p) g_static_private_set(&charged_cpu, p, g_free)
+#endif
+
+/* All times are in microseconds */
+
+static inline gint64
+wall_time(void) {
+#if GLIB_CHECK_VERSION(2,28,0)
+  return g_get_monotonic_time();
+#else
+  GTimeVal now;
+  g_get_current_time(&now);
+  return (gint64) now.tv_sec * G_USEC_PER_SEC + now.tv_usec;
+#endif
+}
+
+#ifdef HAVE_GETRUSAGE
+
+/* Where the system tells threads apart, the CPU time is that of the
+   calling thread, so that batch workers do not count each other's;
+   the workers it joined are charged to it explicitly */
+#ifdef RUSAGE_THREAD
+#define CPU_RUSAGE_WHO RUSAGE_THREAD
+#define CPU_CHARGE_WORKERS 1
+#else
+#define CPU_RUSAGE_WHO RUSAGE_SELF
+#endif
+
+static inline gint64
+timeval_usec(const struct timeval *tv) {
+  return (gint64) tv->tv_sec * G_USEC_PER_SEC + tv->tv_usec;
+}
+
+static inline gint64
+thread_cpu_time(void) {
+  struct rusage usage;
+  if (getrusage(CPU_RUSAGE_WHO, &usage))
+    return 0;
+  return timeval_usec(&usage.ru_utime) + timeval_usec(&usage.ru_stime);
+}
+
+static inline glong
+peak_rss(void) {
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage))
+    return 0;
+  return usage.ru_maxrss;
+}
+
+#else /* HAVE_GETRUSAGE */
+
+static inline gint64
+thread_cpu_time(void) {
+  return (gint64) clock() * G_USEC_PER_SEC / CLOCKS_PER_SEC;
+}
+
+static inline glong
+peak_rss(void) {
+  return 0;
+}
+
+#endif /* HAVE_GETRUSAGE */
+
+/* The CPU time of the calling thread, and of the workers it joined */
+static inline gint64
+cpu_time(void) {
+  const gint64 *charged = charged_get();
+  return thread_cpu_time() + (charged ? *charged : 0);
+}
+
+void
+_stats_begin(stats_mark_t *mark) {
+  mark->wall = wall_time();
+  mark->cpu = cpu_time();
+}
+
+void
+_stats_end(const stats_mark_t *mark, const stats_phase_t phase) {
+  const gint64 wall = wall_time() - mark->wall;
+  const gint64 cpu = cpu_time() - mark->cpu;
+  const glong rss = peak_rss();
+  phase_stats_t *stats = &phases[phase];
+
+  stats_lock();
+  stats->runs++;
+  stats->wall += wall;
+  stats->cpu += cpu;
+  stats->peak_rss = MAX(stats->peak_rss, rss);
+  stats_unlock();
+}
+
+void
+_stats_count(const stats_counter_t counter, const guint64 n) {
+  stats_lock();
+  counters[counter] += n;
+  stats_unlock();
+}
+
+void
+_stats_lap(stats_mark_t *mark) {
+  mark->wall = wall_time() - mark->wall;
+  mark->cpu = cpu_time() - mark->cpu;
+}
+
+void
+_stats_charge(const stats_mark_t *mark) {
+#ifdef CPU_CHARGE_WORKERS
+  gint64 *charged = charged_get();
+  if (!charged) {
+    charged = g_new0(gint64, 1);
+    charged_set(charged);
+  }
+  *charged += mark->cpu;
+#else
+  /* the process time already counts the workers */
+  (void) mark;
+#endif
+}
+
+static void
+report_text(FILE *out) {
+  unsigned i;
+
+  g_fprintf(out, "%-12s %6s %12s %12s %12s\n",
+	    "phase", "runs", "wall (s)", "cpu (s)", "peak rss (k)");
+  for (i = 0; i < NR_STATS_PHASES; i++) {
+    const phase_stats_t *stats = &phases[i];
+    if (!stats->runs)
+      continue;
+    g_fprintf(out, "%-12s %6u %12.6f %12.6f %12ld\n",
+	      phase_names[i], stats->runs,
+	      (gdouble) stats->wall / G_USEC_PER_SEC,
+	      (gdouble) stats->cpu / G_USEC_PER_SEC,
+	      stats->peak_rss);
+  }
+
+  for (i = 0; i < NR_STATS_COUNTERS; i++)
+    g_fprintf(out, "%-12s %" G_GUINT64_FORMAT "\n",
+	      counter_names[i], counters[i]);
+}
+
+static void
+report_json(FILE *out) {
+  gboolean first = TRUE;
+  unsigned i;
+
+  g_fprintf(out, "{\"phases\": {");
+  for (i = 0; i < NR_STATS_PHASES; i++) {
+    const phase_stats_t *stats = &phases[i];
+    if (!stats->runs)
+      continue;
+    g_fprintf(out, "%s\"%s\": {\"runs\": %u, \"wall\": %.6f, "
+	      "\"cpu\": %.6f, \"peak_rss_kb\": %ld}",
+	      first ? "" : ", ", phase_names[i], stats->runs,
+	      (gdouble) stats->wall / G_USEC_PER_SEC,
+	      (gdouble) stats->cpu / G_USEC_PER_SEC,
+	      stats->peak_rss);
+    first = FALSE;
+  }
+
+  g_fprintf(out, "}, \"counters\": {");
+  for (i = 0; i < NR_STATS_COUNTERS; i++)
+    g_fprintf(out, "%s\"%s\": %" G_GUINT64_FORMAT,
+	      i ? ", " : "", counter_names[i], counters[i]);
+  g_fprintf(out, "}}\n");
+}
+
+void
+stats_report(FILE *out, const gboolean json) {
+  stats_lock();
+  if (json)
+    report_json(out);
+  else
+    report_text(out);
+  stats_unlock();
+}
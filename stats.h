@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2006, 2007 Jean-Baptiste Note <jean-baptiste.note@m4x.org>
+ *
+ * This file is part of debit.
+ *
+ * Debit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Debit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with debit.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _HAS_STATS_H
+#define _HAS_STATS_H
+
+/** \file
+ *
+ * Phase timings and event counters.
+ *
+ * A phase is timed between stats_begin and stats_end; its wall and CPU
+ * times are summed over all its runs, and the peak RSS of the process
+ * is sampled at its end. Phases may nest. The CPU time is that of the
+ * thread running the phase, plus that of the workers it joined, on
+ * systems which have RUSAGE_THREAD; elsewhere it is that of the whole
+ * process, and is only meaningful with a single thread. Nothing is
+ * recorded unless debit_stats is set.
+ */
+
+#include <stdio.h>
+#include <glib.h>
+
+typedef enum {
+  STATS_HEADER = 0,
+  STATS_PACKETS,
+  STATS_FRAMES,
+  STATS_COMPACT,
+  STATS_CHIPDB,
+  STATS_PIPDB,
+  STATS_PIPS,
+  STATS_NETS,
+  STATS_DUMP_FRAMES,
+  STATS_DUMP_UNK,
+  STATS_DUMP_SITES,
+  STATS_DUMP_ARCHIVE,
+  STATS_DUMP_PIPS,
+  STATS_DUMP_LUTS,
+  STATS_DUMP_BRAM,
+  STATS_DUMP_NETS,
+  NR_STATS_PHASES,
+} stats_phase_t;
+
+typedef enum {
+  STATS_NFRAMES = 0,
+  STATS_NCRC,
+  STATS_NPIPS,
+  STATS_NNETS,
+  STATS_NNODES,
+  NR_STATS_COUNTERS,
+} stats_counter_t;
+
+typedef struct _stats_mark {
+  gint64 wall;
+  gint64 cpu;
+} stats_mark_t;
+
+extern gboolean debit_stats;
+
+void _stats_begin(stats_mark_t *mark);
+void _stats_end(const stats_mark_t *mark, const stats_phase_t phase);
+void _stats_count(const stats_counter_t counter, const guint64 n);
+void _stats_lap(stats_mark_t *mark);
+void _stats_charge(const stats_mark_t *mark);
+
+static inline void
+stats_begin(stats_mark_t *mark) {
+  if (G_UNLIKELY(debit_stats))
+    _stats_begin(mark);
+}
+
+static inline void
+stats_end(const stats_mark_t *mark, const stats_phase_t phase) {
+  if (G_UNLIKELY(debit_stats))
+    _stats_end(mark, phase);
+}
+
+static inline void
+stats_count(const stats_counter_t counter, const guint64 n) {
+  if (G_UNLIKELY(debit_stats))
+    _stats_count(counter, n);
+}
+
+/** \brief Turn a mark into the time elapsed since it was set
+ *
+ * Called by a worker thread on the mark it set when starting.
+ *
+ * @param mark the mark
+ */
+static inline void
+stats_lap(stats_mark_t *mark) {
+  if (G_UNLIKELY(debit_stats))
+    _stats_lap(mark);
+}
+
+/** \brief Charge the CPU time of a worker to the calling thread
+ *
+ * Called once the worker is joined, with the mark it turned with
+ * stats_lap, so that the phases running around count its CPU time.
+ *
+ * @param mark the mark
+ */
+static inline void
+stats_charge(const stats_mark_t *mark) {
+  if (G_UNLIKELY(debit_stats))
+    _stats_charge(mark);
+}
+
+/** \brief Print the statistics gathered so far
+ *
+ * @param out the output stream
+ * @param json whether to print JSON rather than text
+ */
+void stats_report(FILE *out, const gboolean json);
+
+#endif /* _HAS_STATS_H */
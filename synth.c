@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2006, 2007 Jean-Baptiste Note <jean-baptiste.note@m4x.org>
+ *
+ * This file is part of debit.
+ *
+ * Debit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Debit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with debit.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** \file
+    Synthetic bitstream generator.
+
+    This writes a full-device bitstream for any chip of the family,
+    with random frame contents and, optionally, random pips of the
+    database, so that large parts can be processed without a design
+    for them.
+*/
+
+#include <glib.h>
+#include <glib/gprintf.h>
+
+#include "bitstream_parser.h"
+#include "bitstream_write.h"
+#include "bitsynth.h"
+#include "debitlog.h"
+#include "sites.h"
+#include "localpips.h"
+
+static gchar *ofile = NULL;
+static gchar *datadir = DATADIR;
+static gint chipid = 0;
+static gint seed = 0;
+static gint sparsity = 32;
+static gint npips = 0;
+static gint nblank = 0;
+static gboolean list = FALSE;
+
+#if DEBIT_DEBUG > 0
+unsigned int debit_debug = 0;
+#else
+static unsigned debit_local_debug;
+#endif
+
+static void
+list_chips(void) {
+  const gchar *name;
+  unsigned i;
+
+  for (i = 0; (name = bitstream_chip_name(i)) != NULL; i++)
+    g_printf("%u\t%s\n", i, name);
+}
+
+static int
+synth_file(GRand *rand) {
+  bitstream_parsed_t bit;
+  chip_descr_t *chip = NULL;
+  pip_db_t *pipdb = NULL;
+  unsigned set = 0;
+  int err;
+
+  err = synth_bitstream(&bit, chipid, rand, sparsity);
+  if (err)
+    return err;
+
+  if (npips > 0) {
+    err = -1;
+    chip = get_chip(datadir, chipid);
+    if (!chip)
+      goto out_free;
+    pipdb = get_pipdb(datadir);
+    if (!pipdb)
+      goto out_free;
+
+    set = synth_pips(&bit, chip, pipdb, rand, npips);
+    if (set < (unsigned) npips)
+      g_warning("Could only set %u pips out of %i", set, npips);
+  }
+
+  /* last, so that the rest does not depend on it */
+  synth_blank_frames(&bit, rand, nblank);
+
+  err = bitstream_write(&bit, NULL, ofile);
+  if (err)
+    g_warning("Could not write bitstream %s", ofile);
+  else
+    g_printf("%s: %" G_GSIZE_FORMAT " frames, %u pips\n",
+	     bitstream_chip_name(chipid), bitstream_frame_count(&bit), set);
+
+ out_free:
+  if (pipdb)
+    free_pipdb(pipdb);
+  if (chip)
+    release_chip(chip);
+  free_synth_bitstream(&bit);
+  return err;
+}
+
+static GOptionEntry entries[] =
+{
+  {"outfile", 't', 0, G_OPTION_ARG_FILENAME, &ofile, "Write output bitstream to <ofile>", "<ofile>"},
+  {"datadir", 'd', 0, G_OPTION_ARG_FILENAME, &datadir, "Read data files from directory <datadir>", "<datadir>"},
+  {"chip", 'c', 0, G_OPTION_ARG_INT, &chipid, "Generate the bitstream for chip id <chip>", "<chip>"},
+  {"list", 'l', 0, G_OPTION_ARG_NONE, &list, "List the chip ids of the family", NULL},
+  {"seed", 'r', 0, G_OPTION_ARG_INT, &seed, "Seed of the random contents", "<seed>"},
+  {"sparsity", 'p', 0, G_OPTION_ARG_INT, &sparsity, "Set each bit of the frames with probability 2^-<sparsity>, 32 for blank frames", "<sparsity>"},
+  {"pips", 'n', 0, G_OPTION_ARG_INT, &npips, "Set <pips> random pips of the database", "<pips>"},
+  {"blank", 'b', 0, G_OPTION_ARG_INT, &nblank, "Then blank <frames> random frames", "<frames>"},
+#if DEBIT_DEBUG > 0
+  {"debug", 'g', 0, G_OPTION_ARG_INT, &debit_debug, "Debug verbosity", NULL},
+#else
+  {"debug", 'g', 0, G_OPTION_ARG_INT, &debit_local_debug, "Debug verbosity", NULL},
+#endif
+  { NULL, '\0', 0, 0, NULL, NULL, NULL }
+};
+
+int
+main(int argc, char *argv[])
+{
+  GError *error = NULL;
+  GOptionContext *context = NULL;
+  GRand *rand;
+  int err;
+
+  context = g_option_context_new ("- generate synthetic xilinx bitstreams");
+  g_option_context_add_main_entries (context, entries, NULL);
+  g_option_context_parse (context, &argc, &argv, &error);
+  if (error != NULL) {
+    g_warning("parse error: %s",error->message);
+    g_error_free (error);
+    return -1;
+  }
+
+  g_option_context_free(context);
+
+  if (list) {
+    list_chips();
+    return 0;
+  }
+
+  if (!ofile) {
+    g_warning("You must specify an output file, %s --help for help", argv[0]);
+    return -1;
+  }
+
+  if (sparsity < 0 || npips < 0 || nblank < 0) {
+    g_warning("The sparsity and the numbers of pips and frames must not be negative");
+    return -1;
+  }
+
+  rand = g_rand_new_with_seed(seed);
+  err = synth_file(rand);
+  g_rand_free(rand);
+
+  return err;
+}
@@ -0,0 +1,89 @@
+#! /bin/bash
+
+# Checks run on synthetic bitstreams from debit_synth, which need no
+# design
+
+. log-functions
+
+COMPARE="cmp -s"
+#MAKE is set by make itself from above
+
+SEEDS="1 2"
+
+function check_stream() {
+    local synth=$1;
+    echo -ne "stream\t\t\t"
+
+    ${MAKE} -s --no-print-directory -f $MAKEFILE $synth.frames $synth.stream && \
+	${COMPARE} $synth.frames $synth.stream || \
+	log_failure_msg "FAILED"
+
+    log_success_msg "PASSED"
+}
+
+function check_compact() {
+    local synth=$1;
+    echo -ne "compact\t\t\t"
+
+    ${MAKE} -s --no-print-directory -f $MAKEFILE $synth.frames $synth.compact && \
+	${COMPARE} $synth.frames $synth.compact || \
+	log_failure_msg "FAILED"
+
+    log_success_msg "PASSED"
+}
+
+function check_archive() {
+    local synth=$1;
+    echo -ne "sitearchive\t\t"
+
+    ${MAKE} -s --no-print-directory -f $MAKEFILE $synth.unarchive && \
+	test -s $synth.sites && \
+	${COMPARE} $synth.sites $synth.unarchive || \
+	log_failure_msg "FAILED"
+
+    log_success_msg "PASSED"
+}
+
+function check_partial() {
+    local dir=$1 seed=$2;
+    local blank=$dir/blank$seed;
+    echo -ne "partial\t\t\t"
+
+    ${MAKE} -s --no-print-directory -f $MAKEFILE $blank.frames $blank.overlay && \
+	test "`wc -c < $blank.part`" -lt "`wc -c < $blank.bit`" && \
+	${COMPARE} $blank.frames $blank.overlay || \
+	log_failure_msg "FAILED"
+
+    log_success_msg "PASSED"
+}
+
+function check_pipupdate() {
+    local blank=$1/blank$2;
+    echo -ne "pip update\t\t"
+
+    ${MAKE} -s --no-print-directory -f $MAKEFILE $blank.pip $blank.pipupdate && \
+	test -s $blank.pip && \
+	${COMPARE} $blank.pip $blank.pipupdate || \
+	log_failure_msg "FAILED"
+
+    log_success_msg "PASSED"
+}
+
+function test_synth() {
+    local dir=synth/$family;
+    mkdir -p $dir
+
+    for seed in $SEEDS; do
+	echo -ne "Testing synthetic\t";
+	log_fancy_msg "$family, seed $seed";
+
+	${MAKE} -s --no-print-directory -f $MAKEFILE $dir/synth$seed.bit || \
+	    log_failure_msg "GENERATION FAILED"
+
+	check_stream $dir/synth$seed
+	check_compact $dir/synth$seed
+	check_archive $dir/synth$seed
+	check_partial $dir $seed
+	check_pipupdate $dir $seed
+    done
+}
@@ -0,0 +1,11 @@
+#! /bin/bash
+
+source $srcdir/synth.sh
+
+echo "*************************************"
+echo "Testing Virtex-4 synthetic bitstreams"
+echo "*************************************"
+
+MAKEFILE="$srcdir/testmake.mk DEBIT=\$(top_builddir)/debit_v4 SYNTH=\$(top_builddir)/debit_synth_v4 DUMPARG=--unkdump"
+family=virtex4
+test_synth
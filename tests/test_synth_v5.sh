@@ -0,0 +1,11 @@
+#! /bin/bash
+
+source $srcdir/synth.sh
+
+echo "*************************************"
+echo "Testing Virtex-5 synthetic bitstreams"
+echo "*************************************"
+
+MAKEFILE="$srcdir/testmake.mk DEBIT=\$(top_builddir)/debit_v5 SYNTH=\$(top_builddir)/debit_synth_v5 DUMPARG=--unkdump"
+family=virtex5
+test_synth
@@ -2,11 +2,17 @@ top_srcdir	?= ..
 top_builddir	?= $(top_srcdir)
 DEBIT		?= $(top_builddir)/debit
 XDL2BIT         ?= $(top_builddir)/xdl/xdl2bit
+SYNTH		?= $(top_builddir)/debit_synth
+UNARCHIVE	?= $(top_builddir)/debit_unarchive
 DUMPARG		?= --fakearg
 DATADIR		?= $(top_srcdir)/data
 DEBITDBG	?= -g 0x0
 DEBIT_CMD	=$(VALGRIND_DEBIT_CMD) $(DEBIT) $(DEBITDBG) --datadir=$(DATADIR)
 XDL2BIT_CMD	=$(VALGRIND_DEBIT_CMD) $(XDL2BIT) $(DEBITDBG) --datadir=$(DATADIR)
+SYNTH_CMD	=$(VALGRIND_DEBIT_CMD) $(SYNTH) $(DEBITDBG) --datadir=$(DATADIR)
+UNARCHIVE_CMD	=$(VALGRIND_DEBIT_CMD) $(UNARCHIVE) $(DEBITDBG)
+SYNTHARG	?= --chip 0 --sparsity 4
+BLANKS		?= 64
 
 ##################
 ### Debit work ###
@@ -22,6 +28,39 @@ LOGME = 2>$@.log
 	echo $*.dir/* | xargs md5sum | sort -n | sed -e 's/_u//' | tr -s "/" $(DUMPME) && \
 	rm -Rf $*.dir
 
+#same as %.frames, with the bitstream piped on the standard input
+%.stream: %.bit $(DEBIT)
+	mkdir -p $*.sdir && \
+	$(DEBIT_CMD) $(DUMPARG) --outdir $*.sdir --input - < $< $(DUMPME) $(LOGME) && \
+	echo $*.sdir/* | xargs md5sum | sort -n | sed -e 's/\.sdir/.dir/' -e 's/_u//' | tr -s "/" $(DUMPME) && \
+	rm -Rf $*.sdir
+
+#same as %.frames, from the compacted frames
+%.compact: %.bit $(DEBIT)
+	mkdir -p $*.cdir && \
+	$(DEBIT_CMD) $(DUMPARG) --compact --outdir $*.cdir --input $< $(DUMPME) $(LOGME) && \
+	echo $*.cdir/* | xargs md5sum | sort -n | sed -e 's/\.cdir/.dir/' -e 's/_u//' | tr -s "/" $(DUMPME) && \
+	rm -Rf $*.cdir
+
+#raw site data, one file per site
+%.sites: %.bit $(DEBIT)
+	mkdir -p $*.sitedir && \
+	$(DEBIT_CMD) --sitedump --outdir $*.sitedir --input $< $(DUMPME) $(LOGME) && \
+	(cd $*.sitedir && md5sum *) | sort $(DUMPME)
+
+#the sites of %.sites, looked up in the site archive
+%.unarchive: %.bit %.sites $(DEBIT) $(UNARCHIVE)
+	mkdir -p $*.adir && \
+	$(DEBIT_CMD) --sitearchive sites.sar --outdir $*.adir --input $< $(DUMPME) $(LOGME) && \
+	$(UNARCHIVE_CMD) --archive $*.adir/sites.sar --outdir $*.adir \
+		`ls $*.sitedir | sed -e 's/\.bin$$//'` $(DUMPME) $(LOGME) && \
+	rm -f $*.adir/sites.sar && \
+	(cd $*.adir && md5sum *) | sort $(DUMPME) && \
+	rm -Rf $*.adir $*.sitedir
+
+#keep it for the comparison
+.PRECIOUS: %.sites
+
 %.rewrite: %.bit $(DEBIT)
 	$(DEBIT_CMD) --input $< --outfile $@ $(LOGME)
 
@@ -46,6 +85,42 @@ LOGME = 2>$@.log
 %.nets: %.bit $(DEBIT)
 	$(DEBIT_CMD) --netdump --input $< $(DUMPME) $(LOGME)
 
+############################
+### Synthetic bitstreams ###
+############################
+
+#the random seed is taken from the name, synth<seed>.bit
+synth%.bit: $(SYNTH)
+	$(SYNTH_CMD) $(SYNTHARG) --seed $(notdir $*) --outfile $@ $(LOGME)
+
+#synth<seed>.bit, with some frames blanked
+blank%.bit: $(SYNTH)
+	$(SYNTH_CMD) $(SYNTHARG) --seed $(notdir $*) --blank $(BLANKS) --outfile $@ $(LOGME)
+
+#the frames of blank<seed>.bit which differ from synth<seed>.bit
+blank%.part: blank%.bit synth%.bit $(DEBIT)
+	$(DEBIT_CMD) --input $< --partial $(word 2,$^) --outfile $@ $(LOGME)
+
+#the frames of synth<seed>.bit, overwritten by those of the partial
+#bitstream, as %.frames
+blank%.overlay: blank%.part synth%.bit $(DEBIT)
+	mkdir -p $(@:.overlay=.odir) && \
+	$(DEBIT_CMD) $(DUMPARG) --outdir $(@:.overlay=.odir) --input $(word 2,$^) > /dev/null $(LOGME) && \
+	$(DEBIT_CMD) $(DUMPARG) --outdir $(@:.overlay=.odir) --input $< > /dev/null 2>> $@.log && \
+	echo $(@:.overlay=.odir)/* | xargs md5sum | sort -n | sed -e 's/\.odir/.dir/' -e 's/_u//' | tr -s "/" $(DUMPME) && \
+	rm -Rf $(@:.overlay=.odir)
+
+#the pips of blank<seed>.bit, updated from those of synth<seed>.bit,
+#as %.pip. Only batches extract the pips of the base beforehand.
+blank%.pipupdate: blank%.bit synth%.bit $(DEBIT)
+	$(DEBIT_CMD) --pipdump --diff $(word 2,$^) --batch /dev/null \
+		--outdir $(@:.pipupdate=.udir) --input $< > /dev/null $(LOGME) && \
+	grep '^pip' $(@:.pipupdate=.udir)/$(notdir $(@:.pipupdate=))/dump.txt $(DUMPME) && \
+	rm -Rf $(@:.pipupdate=.udir)
+
+#keep them to check the size of the partial bitstream
+.PRECIOUS: blank%.bit blank%.part
+
 ####################
 ### xdl2bit work ###
 ####################
@@ -111,6 +186,19 @@ XDL2NCD=xdl -xdl2ncd
 clean:
 	- rm -rf $(CLEANDIR)/*.dir
 	- rm -rf $(CLEANDIR)/*.frames
+	- rm -rf $(CLEANDIR)/*.sdir
+	- rm -f $(CLEANDIR)/*.stream
+	- rm -rf $(CLEANDIR)/*.cdir
+	- rm -f $(CLEANDIR)/*.compact
+	- rm -rf $(CLEANDIR)/*.sitedir
+	- rm -rf $(CLEANDIR)/*.adir
+	- rm -f $(CLEANDIR)/*.sites
+	- rm -f $(CLEANDIR)/*.unarchive
+	- rm -f $(CLEANDIR)/*.part
+	- rm -rf $(CLEANDIR)/*.odir
+	- rm -f $(CLEANDIR)/*.overlay
+	- rm -rf $(CLEANDIR)/*.udir
+	- rm -f $(CLEANDIR)/*.pipupdate
 	- rm -f $(CLEANDIR)/*.bram
 	- rm -f $(CLEANDIR)/*.lut
 	- rm -f $(CLEANDIR)/*.pip
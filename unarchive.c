@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2006, 2007 Jean-Baptiste Note <jean-baptiste.note@m4x.org>
+ *
+ * This file is part of debit.
+ *
+ * Debit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Debit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with debit.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** \file
+    Site archive extractor.
+
+    This writes the data of some sites of an archive made by debit
+    --sitearchive to one file per site, as debit --sitedump would have.
+*/
+
+#include <glib.h>
+#include <glib/gprintf.h>
+
+#include "sitearchive.h"
+#include "debitlog.h"
+
+static gchar *archive_file = NULL;
+static gchar *odir = "";
+static gchar *suffix = ".bin";
+
+#if DEBIT_DEBUG > 0
+unsigned int debit_debug = 0;
+#else
+static unsigned debit_local_debug;
+#endif
+
+static int
+extract_site(const site_archive_t *archive, const gchar *name) {
+  const gchar *data;
+  gchar *filename, *fullname;
+  gsize len;
+  int err = 0;
+
+  data = site_archive_lookup(archive, name, &len);
+  if (!data) {
+    g_warning("No site %s in the archive", name);
+    return -1;
+  }
+
+  filename = g_strconcat(name, suffix, NULL);
+  fullname = g_build_filename(odir, filename, NULL);
+  g_free(filename);
+
+  if (!g_file_set_contents(fullname, data, len, NULL)) {
+    g_warning("Failed to write %s", fullname);
+    err = -1;
+  }
+
+  g_free(fullname);
+  return err;
+}
+
+static GOptionEntry entries[] =
+{
+  {"archive", 'a', 0, G_OPTION_ARG_FILENAME, &archive_file, "Read the sites from archive <archive>", "<archive>"},
+  {"outdir", 'o', 0, G_OPTION_ARG_FILENAME, &odir, "Write the site files in directory <odir>", "<odir>"},
+  {"suffix", 'x', 0, G_OPTION_ARG_STRING, &suffix, "Suffix appended to the site files", NULL},
+#if DEBIT_DEBUG > 0
+  {"debug", 'g', 0, G_OPTION_ARG_INT, &debit_debug, "Debug verbosity", NULL},
+#else
+  {"debug", 'g', 0, G_OPTION_ARG_INT, &debit_local_debug, "Debug verbosity", NULL},
+#endif
+  { NULL, '\0', 0, 0, NULL, NULL, NULL }
+};
+
+int
+main(int argc, char *argv[])
+{
+  GError *error = NULL;
+  GOptionContext *context = NULL;
+  site_archive_t *archive;
+  int i, err = 0;
+
+  context = g_option_context_new ("<site>... - extract sites from a site archive");
+  g_option_context_add_main_entries (context, entries, NULL);
+  g_option_context_parse (context, &argc, &argv, &error);
+  if (error != NULL) {
+    g_warning("parse error: %s",error->message);
+    g_error_free (error);
+    return -1;
+  }
+
+  g_option_context_free(context);
+
+  if (!archive_file) {
+    g_warning("You must specify an archive, %s --help for help", argv[0]);
+    return -1;
+  }
+
+  archive = site_archive_open(archive_file);
+  if (!archive)
+    return -1;
+
+  for (i = 1; i < argc; i++)
+    if (extract_site(archive, argv[i]))
+      err = -1;
+
+  site_archive_close(archive);
+  return err;
+}
@@ -29,6 +29,131 @@
 #include "wiring.h"
 #include "design.h"
 
+/*
+ * Wire name hashing.
+ *
+ * This is a minimal perfect hash of the "hash and displace" kind. The
+ * names are spread into buckets by their hash with seed zero; each
+ * bucket then gets the first seed (displacement) under which the
+ * hashes of all its names land on distinct free slots. The same
+ * function is computed by data/wirehash.pl for the compiled-in
+ * database, so the two must be kept in sync.
+ */
+
+static inline guint32
+wirehash(const gchar *name, const guint32 seed) {
+  guint32 h = 2166136261U ^ seed;
+  for (; *name; name++) {
+    h ^= (guchar) *name;
+    h *= 16777619U;
+  }
+  h ^= h >> 16;
+  h *= 0x85ebca6bU;
+  h ^= h >> 13;
+  return h;
+}
+
+#define WIREHASH_LOAD 4
+#define WIREHASH_MAX_DISP (1 << 20)
+
+#ifndef __COMPILED_WIREDB
+
+/* Order the buckets by decreasing size, so that the crowded ones are
+   placed while there is room */
+static gint
+cmp_bucket_size(gconstpointer a, gconstpointer b, gpointer data) {
+  const guint32 *sizes = data;
+  const guint32 sa = sizes[*(const guint32 *) a];
+  const guint32 sb = sizes[*(const guint32 *) b];
+  return (sa < sb) - (sa > sb);
+}
+
+static int
+build_wirehash(wire_db_t *db) {
+  const guint32 n = db->dblen;
+  const guint32 nbuckets = n / WIREHASH_LOAD + 1;
+  guint32 *sizes = g_new0(guint32, nbuckets);
+  guint32 *start = g_new(guint32, nbuckets + 1);
+  guint32 *order = g_new(guint32, nbuckets);
+  guint32 *members = g_new(guint32, n);
+  guint32 *slot_of = g_new(guint32, n);
+  guint32 *disp = g_new0(guint32, nbuckets);
+  wire_atom_t *slots = g_new(wire_atom_t, n);
+  gboolean *taken = g_new0(gboolean, n);
+  guint32 i, j, b;
+  int err = 0;
+
+  /* bucket the names */
+  for (i = 0; i < n; i++)
+    sizes[wirehash(wire_name(db, i), 0) % nbuckets]++;
+  start[0] = 0;
+  for (b = 0; b < nbuckets; b++) {
+    start[b + 1] = start[b] + sizes[b];
+    order[b] = b;
+  }
+  for (i = 0; i < n; i++) {
+    b = wirehash(wire_name(db, i), 0) % nbuckets;
+    members[start[b + 1] - sizes[b]--] = i;
+  }
+  for (b = 0; b < nbuckets; b++)
+    sizes[b] = start[b + 1] - start[b];
+
+  g_qsort_with_data(order, nbuckets, sizeof(guint32), cmp_bucket_size, sizes);
+
+  for (j = 0; j < nbuckets && !err; j++) {
+    guint32 d;
+    b = order[j];
+    if (!sizes[b])
+      break;
+
+    for (d = 1; d < WIREHASH_MAX_DISP; d++) {
+      guint32 k;
+      for (k = start[b]; k < start[b + 1]; k++) {
+	const guint32 slot = wirehash(wire_name(db, members[k]), d) % n;
+	if (taken[slot])
+	  break;
+	taken[slot] = TRUE;
+	slot_of[k] = slot;
+      }
+      if (k == start[b + 1])
+	break;
+      /* roll back */
+      while (k-- > start[b])
+	taken[slot_of[k]] = FALSE;
+    }
+
+    if (d == WIREHASH_MAX_DISP) {
+      err = -1;
+      break;
+    }
+
+    disp[b] = d;
+    for (i = start[b]; i < start[b + 1]; i++)
+      slots[slot_of[i]] = members[i];
+  }
+
+  g_free(taken);
+  g_free(slot_of);
+  g_free(members);
+  g_free(order);
+  g_free(start);
+  g_free(sizes);
+
+  if (err) {
+    g_warning("could not hash the wire names, falling back to a search");
+    g_free(disp);
+    g_free(slots);
+    return err;
+  }
+
+  db->hash_nbuckets = nbuckets;
+  db->hash_disp = disp;
+  db->hash_slots = slots;
+  return 0;
+}
+
+#endif /* __COMPILED_WIREDB */
+
 #ifdef __COMPILED_WIREDB
 
 /*
@@ -37,17 +162,22 @@
 
 #if defined(VIRTEX2)
 #define WIREDB "data/virtex2/wires.m4"
+#define WIREHASH "data/virtex2/wirehash.h"
 #elif defined(VIRTEX4)
 #define WIREDB "data/virtex4/wires.m4"
+#define WIREHASH "data/virtex4/wirehash.h"
 #elif defined(VIRTEX5)
 #define WIREDB "data/virtex5/wires.m4"
+#define WIREHASH "data/virtex5/wirehash.h"
 #elif defined(SPARTAN3)
 #define WIREDB "data/spartan3/wires.m4"
+#define WIREHASH "data/spartan3/wirehash.h"
 #else
 #error "Unable to compile wiredb in"
 #endif
 
 #include "data/wiring_compiled.h"
+#include WIREHASH
 
 wire_db_t *get_wiredb(const gchar *datadir) {
   wire_db_t *wiredb = g_new0(wire_db_t, 1);
@@ -57,6 +187,9 @@ wire_db_t *get_wiredb(const gchar *datadir) {
   wiredb->wirenames = wirestr.str;
   wiredb->wireidx = wireidx;
   wiredb->dblen = G_N_ELEMENTS(wires);
+  wiredb->hash_nbuckets = G_N_ELEMENTS(wirehash_disp);
+  wiredb->hash_disp = wirehash_disp;
+  wiredb->hash_slots = wirehash_slots;
   return wiredb;
 }
 
@@ -239,6 +372,9 @@ wire_db_t *get_wiredb(const gchar *datadir) {
     goto out_err;
 
   g_key_file_free(db);
+
+  /* Not fatal: lookups fall back to a binary search */
+  (void) build_wirehash(wiredb);
   return wiredb;
 
  out_err:
@@ -260,6 +396,8 @@ void free_wiredb(wire_db_t *wires) {
     g_string_chunk_free(wirenames);
   g_free((void *)wires->details);
   g_free(wires->names);
+  g_free((void *)wires->hash_disp);
+  g_free((void *)wires->hash_slots);
   empty_db(wires, wires->dblen);
   g_free((void *)wires->wires);
   g_free(wires);
@@ -275,12 +413,31 @@ static inline gint cmp(const gchar *s1, const gchar *s2) {
   return strcmp(s1,s2);
 }
 
-/* This one is a get_by_name. The only complicated function, which
-   is a dichotomy */
+/* This one is a get_by_name. The name is hashed when the database
+   has its hash, and otherwise searched for by dichotomy */
+
+static inline gint
+lookup_wirehash(const wire_db_t *db, wire_atom_t *res,
+		const gchar *wire) {
+  const guint32 bucket = wirehash(wire, 0) % db->hash_nbuckets;
+  const guint32 slot = wirehash(wire, db->hash_disp[bucket]) % db->dblen;
+  const wire_atom_t atom = db->hash_slots[slot];
+
+  /* names outside of the database land anywhere */
+  if (cmp(wire, wire_name(db, atom)))
+    return -1;
+
+  *res = atom;
+  return 0;
+}
 
 gint parse_wire_simple(const wire_db_t *db, wire_atom_t* res,
 		       const gchar *wire) {
   int low = 0, high = db->dblen-1;
+
+  if (db->hash_slots)
+    return lookup_wirehash(db, res, wire);
+
   //  g_assert(high <= db->dblen);
 
   do {
@@ -69,6 +69,12 @@ typedef struct _wire_db {
   const gchar **names;
   GStringChunk *wirenames;
 #endif
+  /* Minimal perfect hash of the wire names: the name hashed with the
+     displacement of its bucket gives its slot, which holds its atom.
+     NULL slots if the hash could not be built */
+  guint32 hash_nbuckets;
+  const guint32 *hash_disp;
+  const wire_atom_t *hash_slots;
 } wire_db_t;
 
 static inline
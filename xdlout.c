@@ -24,34 +24,39 @@
 #include "xdlout.h"
 
 #include <time.h>
+#include <glib/gprintf.h>
 #include "bitheader.h"
 
 /**
  * Design printing function
  **/
 
-void print_design(parsed_header_t *header) {
+void print_design(FILE *out, parsed_header_t *header) {
   const unsigned ncdv1 = 3, ncdv2 = 1;
   const header_option_p *devopt = get_option(header, DEVICE_TYPE);
   const header_option_p *nameopt = get_option(header, FILENAME);
   time_t timestamp;
 
-  g_print("design \"%.*s\" %.*s v%i.%i ,\n",
-	  nameopt->len, nameopt->data,
-	  devopt->len, devopt->data,
-	  ncdv1, ncdv2);
+  g_fprintf(out, "design \"%.*s\" %.*s v%i.%i ,\n",
+	    nameopt->len, nameopt->data,
+	    devopt->len, devopt->data,
+	    ncdv1, ncdv2);
 
   /* At some point get the timestamp from the bitfile */
   timestamp = time(NULL);
-  g_print("  cfg \"\n");
-  g_print("       _DESIGN_PROP::PK_NGMTIMESTAMP:%lu\n",timestamp);
-  g_print("      \";\n");
+  g_fprintf(out, "  cfg \"\n");
+  g_fprintf(out, "       _DESIGN_PROP::PK_NGMTIMESTAMP:%lu\n",timestamp);
+  g_fprintf(out, "      \";\n");
 }
 
 /**
  * NET Printing functions
  **/
 struct _print_net {
+  FILE *out;
+  unsigned netnum;
+  const nets_t *nets;
+  const nets_csr_t *csr;
   const wire_db_t *wiredb;
   const chip_descr_t *chipdb;
 };
@@ -94,7 +99,8 @@ static const char *ioname[IO_END] = {
 };
 
 static void
-print_iopin(const iopin_dir_t iodir,
+print_iopin(FILE *out,
+	    const iopin_dir_t iodir,
 	    const sited_pip_t *spip,
 	    const wire_db_t *wiredb,
 	    const chip_descr_t *chip) {
@@ -104,86 +110,91 @@ print_iopin(const iopin_dir_t iodir,
   gchar slicen[MAX_SITE_NLEN];
   snprint_slice(slicen, MAX_SITE_NLEN, chip, site, wire->situation - ZERO);
   /* Combine the situation and site to get the location */
-  g_print("  %s \"%s\" %s , #%s\n", ioname[iodir], slicen,
-	  typename(wire->type), wire_name(wiredb,spip->pip.target));
+  g_fprintf(out, "  %s \"%s\" %s , #%s\n", ioname[iodir], slicen,
+	    typename(wire->type), wire_name(wiredb,spip->pip.target));
 }
 
-static gboolean
-print_inpin(GNode *net,
-	    gpointer data) {
-  const sited_pip_t *spip = net->data;
-  struct _print_net *arg = data;
-  print_iopin(IO_INPUT, spip, arg->wiredb, arg->chipdb);
-  return FALSE;
+static void
+print_inpin(const net_node_t node,
+	    const struct _print_net *arg) {
+  const sited_pip_t *spip = &arg->nets->spip[node];
+  print_iopin(arg->out, IO_INPUT, spip, arg->wiredb, arg->chipdb);
 }
 
-static gboolean
-print_outpin(GNode *net,
-	     gpointer data) {
-  const sited_pip_t *spip = net->data;
-  struct _print_net *arg = data;
-  print_iopin(IO_OUTPUT, spip, arg->wiredb, arg->chipdb);
-  return FALSE;
+static void
+print_outpin(const net_node_t node,
+	     const struct _print_net *arg) {
+  const sited_pip_t *spip = &arg->nets->spip[node];
+  print_iopin(arg->out, IO_OUTPUT, spip, arg->wiredb, arg->chipdb);
 }
 
 #else
 
-static gboolean
-print_inpin(GNode *net,
-	    gpointer data) {
-  (void) net;
-  (void) data;
-  return FALSE;
+static void
+print_inpin(const net_node_t node,
+	    const struct _print_net *arg) {
+  (void) node;
+  (void) arg;
 }
 
-static gboolean
-print_outpin(GNode *net,
-	     gpointer data) {
-  (void) net;
-  (void) data;
-  return FALSE;
+static void
+print_outpin(const net_node_t node,
+	     const struct _print_net *arg) {
+  (void) node;
+  (void) arg;
 }
 
 #endif
 
-static gboolean
-print_wire(GNode *net,
-	   gpointer data) {
-  struct _print_net *arg = data;
+static void
+print_wire(const net_node_t node,
+	   const struct _print_net *arg) {
   const wire_db_t *wiredb = arg->wiredb;
   const chip_descr_t *chip = arg->chipdb;
-  const sited_pip_t *spip = net->data;
+  const sited_pip_t *spip = &arg->nets->spip[node];
   gchar buf[64];
 
   /* This is how wire start are indicated -- this is actually redundant
      with positioning in the tree... */
   if (spip->pip.source == WIRE_EP_END)
-    return FALSE;
+    return;
 
   snprint_spip(buf, ARRAY_SIZE(buf),
-	       wiredb, chip, net->data);
-  g_print("  %s ,\n", buf);
-  return FALSE;
+	       wiredb, chip, spip);
+  g_fprintf(arg->out, "  %s ,\n", buf);
 }
 
 static void
-print_net(GNode *net, gpointer data) {
-  static unsigned netnum = 0;
-  g_print("net \"net_%i\" , \n", netnum++);
+print_net(const guint32 netnum, struct _print_net *arg) {
+  const nets_t *nets = arg->nets;
+  const nets_csr_t *csr = arg->csr;
+  const net_node_t *row = &csr->nodes[csr->offsets[netnum]];
+  const guint32 len = csr->offsets[netnum + 1] - csr->offsets[netnum];
+  guint32 i;
+
+  g_fprintf(arg->out, "net \"net_%i\" , \n", arg->netnum++);
   /* print input -- this should be the output pin of a logical bloc */
-  print_outpin(net, data);
+  print_outpin(row[0], arg);
   /* print outputs -- these should be input pins to some logical blocs */
-  g_node_traverse (net, G_IN_ORDER, G_TRAVERSE_LEAVES, -1, print_inpin, data);
-  g_node_traverse (net, G_PRE_ORDER, G_TRAVERSE_ALL, -1, print_wire, data);
-  g_print("  ;\n");
+  for (i = 0; i < len; i++)
+    if (net_node_is_leaf(nets, row[i]))
+      print_inpin(row[i], arg);
+  for (i = 0; i < len; i++)
+    print_wire(row[i], arg);
+  g_fprintf(arg->out, "  ;\n");
 }
 
-void print_nets(nets_t *net,
+void print_nets(FILE *out, const nets_t *nets,
+		const nets_csr_t *csr,
 		const pip_db_t *pipdb,
 		const chip_descr_t *cdb) {
-  struct _print_net arg = { .wiredb = pipdb->wiredb, .chipdb = cdb };
+  struct _print_net arg = { .out = out, .netnum = 0, .nets = nets,
+			    .csr = csr,
+			    .wiredb = pipdb->wiredb, .chipdb = cdb };
+  guint32 i;
   /* Iterate through nets */
-  g_node_children_foreach (net->head, G_TRAVERSE_ALL, print_net, &arg);
+  for (i = 0; i < csr->nnets; i++)
+    print_net(i, &arg);
 }
 
 /**
@@ -191,6 +202,7 @@ void print_nets(nets_t *net,
  **/
 
 typedef struct _slice_iter {
+  FILE *out;
   const chip_descr_t *chip;
   const wire_db_t *wiredb;
 } slice_iter_t;
@@ -205,7 +217,7 @@ pip_iterator(gpointer data, const pip_t pip,
   const char *owire = wire_name(db, pip.target);
   const char *iwire = wire_name(db, pip.source);
   (void) site;
-  g_print(" %s::%s", owire, iwire);
+  g_fprintf(slit->out, " %s::%s", owire, iwire);
 }
 
 #if defined(VIRTEX2) || defined(SPARTAN3)
@@ -252,11 +264,11 @@ slice_iterator(unsigned site_x, unsigned site_y,
   /*  inst "Q_1" "SLICE",placed R6C4 SLICE_X7Y4  ,
       cfg " BXINV::#OFF BXOUTUSED::#OFF BYINV::#OFF BYINVOUTUSED::#OFF BYOUTUSED::#OFF
   */
-  g_print("inst \"%s\" \"%s\",placed %s %s  ,\n",
-	  sliceid, type_names[site->type], siten, slicen);
+  g_fprintf(slit->out, "inst \"%s\" \"%s\",placed %s %s  ,\n",
+	    sliceid, type_names[site->type], siten, slicen);
 
   /* start of config string */
-  g_print("  cfg \"");
+  g_fprintf(slit->out, "  cfg \"");
   /* data */
 
   /* end */
@@ -265,10 +277,11 @@ slice_iterator(unsigned site_x, unsigned site_y,
 }
 
 void
-print_slices(const pip_parsed_dense_t *pipdat,
+print_slices(FILE *out,
+	     const pip_parsed_dense_t *pipdat,
 	     const pip_db_t *pipdb,
 	     const chip_descr_t *chip) {
-  slice_iter_t arg = { .chip = chip, .wiredb = pipdb->wiredb };
+  slice_iter_t arg = { .out = out, .chip = chip, .wiredb = pipdb->wiredb };
   iterate_over_bitpips_complex(pipdat, chip,
 			       slice_iterator, pip_iterator, &arg);
 }
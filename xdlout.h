@@ -20,18 +20,21 @@
 #ifndef _HAS_XDLOUT_H
 #define _HAS_XDLOUT_H
 
+#include <stdio.h>
 #include "connexity.h"
 #include "localpips.h"
 #include "sites.h"
 
-void print_design(parsed_header_t *header);
+void print_design(FILE *out, parsed_header_t *header);
 
-void print_nets(nets_t *net,
+void print_nets(FILE *out, const nets_t *nets,
+		const nets_csr_t *csr,
 		const pip_db_t *pipdb,
 		const chip_descr_t *cdb);
 
 void
-print_slices(const pip_parsed_dense_t *pipdat,
+print_slices(FILE *out,
+	     const pip_parsed_dense_t *pipdat,
 	     const pip_db_t *pipdb,
 	     const chip_descr_t *chip);
 
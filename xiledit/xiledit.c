@@ -115,7 +115,7 @@ display_bitstream(const gchar *filename) {
     return -1;
   }
 
-  nlz = analyze_bitstream(bit, datadir);
+  nlz = analyze_bitstream(bit, datadir, 1);
   if (!nlz) {
     g_warning("Could not analyze the bitfile");
     return -1;